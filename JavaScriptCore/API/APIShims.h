@@ -40,10 +40,24 @@ protected:
         if (registerThread)
             globalData->heap.registerThread();
         m_globalData->timeoutChecker.start();
+#ifndef NDEBUG
+        if (!m_globalData->isSharedInstance) {
+            // Two threads inside the same context group at once would corrupt it.
+            ASSERT(!m_globalData->apiEntryDepth || m_globalData->apiEntryThread == currentThread());
+            m_globalData->apiEntryThread = currentThread();
+            ++m_globalData->apiEntryDepth;
+        }
+#endif
     }
 
     ~APIEntryShimWithoutLock()
     {
+#ifndef NDEBUG
+        if (!m_globalData->isSharedInstance) {
+            ASSERT(m_globalData->apiEntryThread == currentThread());
+            --m_globalData->apiEntryDepth;
+        }
+#endif
         m_globalData->timeoutChecker.stop();
         setCurrentIdentifierTable(m_entryIdentifierTable);
     }
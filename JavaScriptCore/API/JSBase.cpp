@@ -110,3 +110,8 @@ void JSReportExtraMemoryCost(JSContextRef ctx, size_t size)
     APIEntryShim entryShim(exec);
     exec->globalData().heap.reportExtraMemoryCost(size);
 }
+
+void JSReleaseFreeMemory()
+{
+    WTF::releaseFastMallocFreeMemory();
+}
@@ -45,6 +45,16 @@ region.
 */
 JS_EXPORT void JSReportExtraMemoryCost(JSContextRef ctx, size_t size) AVAILABLE_IN_WEBKIT_VERSION_4_0;
 
+/*!
+@function
+@abstract Returns free memory held by JavaScriptCore's allocator to the system.
+@discussion Use this function when the system is low on memory. Memory is
+also returned gradually in the background; this function returns what it can
+right away. Call JSGarbageCollect first to free the memory of unreachable
+objects as well.
+*/
+JS_EXPORT void JSReleaseFreeMemory(void) AVAILABLE_AFTER_WEBKIT_VERSION_4_0;
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,8 +27,10 @@
 #include "JSProfilerPrivate.h"
 
 #include "APICast.h"
+#include "APIShims.h"
 #include "OpaqueJSString.h"
 #include "Profiler.h"
+#include "SamplingProfiler.h"
 
 using namespace JSC;
 
@@ -44,3 +46,53 @@ void JSEndProfiling(JSContextRef ctx, JSStringRef title)
     profiler->stopProfiling(exec, title->ustring());
 }
 
+bool JSStartSamplingProfiler(JSContextRef ctx, unsigned samplesPerSecond)
+{
+#if ENABLE(SAMPLING_PROFILER)
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    JSGlobalData& globalData = exec->globalData();
+    if (globalData.samplingProfiler && globalData.samplingProfiler->isRunning())
+        return true;
+    // The samples of the last run are only thrown away once sampling starts.
+    OwnPtr<SamplingProfiler> profiler(new SamplingProfiler(&globalData));
+    if (!profiler->start(exec, samplesPerSecond))
+        return false;
+    globalData.samplingProfiler.set(profiler.release());
+    return true;
+#else
+    UNUSED_PARAM(ctx);
+    UNUSED_PARAM(samplesPerSecond);
+    return false;
+#endif
+}
+
+void JSStopSamplingProfiler(JSContextRef ctx)
+{
+#if ENABLE(SAMPLING_PROFILER)
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    if (SamplingProfiler* profiler = exec->globalData().samplingProfiler.get())
+        profiler->stop();
+#else
+    UNUSED_PARAM(ctx);
+#endif
+}
+
+JSStringRef JSSamplingProfilerCopyCollapsedStacks(JSContextRef ctx)
+{
+#if ENABLE(SAMPLING_PROFILER)
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    SamplingProfiler* profiler = exec->globalData().samplingProfiler.get();
+    if (!profiler)
+        return 0;
+    return OpaqueJSString::create(profiler->collapsedStacks()).releaseRef();
+#else
+    UNUSED_PARAM(ctx);
+    return 0;
+#endif
+}
@@ -27,6 +27,7 @@
 #define JSProfiler_h
 
 #include <JavaScriptCore/JSBase.h>
+#include <JavaScriptCore/WebKitAvailability.h>
 
 #ifndef __cplusplus
 #include <stdbool.h>
@@ -56,6 +57,38 @@ JS_EXPORT void JSStartProfiling(JSContextRef ctx, JSStringRef title);
 */
 JS_EXPORT void JSEndProfiling(JSContextRef ctx, JSStringRef title);
 
+/*!
+@function JSStartSamplingProfiler
+@abstract Starts sampling the JavaScript stack of the calling thread.
+@param ctx The execution context to use.
+@param samplesPerSecond How often to take a sample; 0 means the default of 1000.
+@result true if the profiler is running; false if sampling is not supported on
+        this platform, or another context group is already being sampled.
+@discussion Sampling is cheap enough to leave on, so samples accumulate until
+            the profiler is started again after being stopped. If it fails to
+            start, the samples of the last run are kept. Sampling stops if the
+            calling thread exits.
+*/
+JS_EXPORT bool JSStartSamplingProfiler(JSContextRef ctx, unsigned samplesPerSecond) AVAILABLE_AFTER_WEBKIT_VERSION_4_0;
+
+/*!
+@function JSStopSamplingProfiler
+@abstract Stops sampling, keeping the samples taken so far.
+@param ctx The execution context to use.
+*/
+JS_EXPORT void JSStopSamplingProfiler(JSContextRef ctx) AVAILABLE_AFTER_WEBKIT_VERSION_4_0;
+
+/*!
+@function JSSamplingProfilerCopyCollapsedStacks
+@abstract Returns the samples taken so far as collapsed stacks.
+@param ctx The execution context to use.
+@result A JSString with one line per distinct stack, outermost frame first,
+        frames separated by semicolons and followed by a space and the number
+        of samples - the input format of common flame graph tools - or NULL if
+        the profiler was never started. Ownership follows the Create Rule.
+*/
+JS_EXPORT JSStringRef JSSamplingProfilerCopyCollapsedStacks(JSContextRef ctx) AVAILABLE_AFTER_WEBKIT_VERSION_4_0;
+
 #ifdef __cplusplus
 }
 #endif
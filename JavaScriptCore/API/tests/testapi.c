@@ -27,7 +27,9 @@
 #include "JSBasePrivate.h"
 #include "JSContextRefPrivate.h"
 #include "JSObjectRefPrivate.h"
+#include "JSProfilerPrivate.h"
 #include <math.h>
+#include <string.h>
 #define ASSERT_DISABLED 0
 #include <wtf/Assertions.h>
 #include <wtf/UnusedParam.h>
@@ -764,6 +766,102 @@ static void makeGlobalNumberValue(JSContextRef context) {
     v = NULL;
 }
 
+// Each line of collapsed stacks is "frame;...;frame count".
+static bool isCollapsedStackLine(const char* line, size_t length)
+{
+    size_t space = length;
+    while (space && line[space - 1] != ' ')
+        --space;
+    if (space < 2 || space == length)
+        return false;
+    for (size_t i = space; i < length; ++i) {
+        if (line[i] < '0' || line[i] > '9')
+            return false;
+    }
+    return true;
+}
+
+static void checkCollapsedStacks(JSContextRef context, const char* expectedFrame)
+{
+    JSStringRef stacks = JSSamplingProfilerCopyCollapsedStacks(context);
+    if (!stacks) {
+        printf("FAIL: The sampling profiler returned no samples.\n");
+        failed = 1;
+        return;
+    }
+
+    size_t size = JSStringGetMaximumUTF8CStringSize(stacks);
+    char* buffer = (char*)malloc(size);
+    JSStringGetUTF8CString(stacks, buffer, size);
+    JSStringRelease(stacks);
+
+    bool wellFormed = *buffer;
+    for (char* line = buffer; *line && wellFormed; ) {
+        char* end = strchr(line, '\n');
+        if (!end)
+            wellFormed = false;
+        else {
+            wellFormed = isCollapsedStackLine(line, end - line);
+            line = end + 1;
+        }
+    }
+    if (!wellFormed) {
+        printf("FAIL: The sampling profiler's collapsed stacks are malformed:\n%s", buffer);
+        failed = 1;
+    } else if (!strstr(buffer, expectedFrame)) {
+        printf("FAIL: The sampling profiler did not see %s:\n%s", expectedFrame, buffer);
+        failed = 1;
+    } else
+        printf("PASS: The sampling profiler saw %s.\n", expectedFrame);
+    free(buffer);
+}
+
+static void testSamplingProfiler()
+{
+    JSGlobalContextRef profiledContext = JSGlobalContextCreateInGroup(NULL, NULL);
+    JSGlobalContextRef otherContext = JSGlobalContextCreateInGroup(NULL, NULL);
+
+    if (!JSStartSamplingProfiler(profiledContext, 0)) {
+        printf("PASS: Sampling is not supported on this platform.\n");
+        JSGlobalContextRelease(profiledContext);
+        JSGlobalContextRelease(otherContext);
+        return;
+    }
+
+    if (JSStartSamplingProfiler(otherContext, 0) || JSSamplingProfilerCopyCollapsedStacks(otherContext)) {
+        printf("FAIL: Two context groups were sampled at once.\n");
+        failed = 1;
+    } else
+        printf("PASS: Only one context group is sampled at a time.\n");
+
+    JSStringRef script = JSStringCreateWithUTF8CString(
+        "function spinForSamples() {"
+        "    var end = new Date().getTime() + 200;"
+        "    var total = 0;"
+        "    while (new Date().getTime() < end)"
+        "        total += Math.sqrt(total + 1);"
+        "    return total;"
+        "}"
+        "spinForSamples();");
+    JSEvaluateScript(profiledContext, script, NULL, NULL, 1, NULL);
+    JSStringRelease(script);
+    JSStopSamplingProfiler(profiledContext);
+    checkCollapsedStacks(profiledContext, "spinForSamples");
+
+    // A profiler that fails to start leaves the last run's samples in place.
+    if (JSStartSamplingProfiler(otherContext, 0)) {
+        if (JSStartSamplingProfiler(profiledContext, 0)) {
+            printf("FAIL: Two context groups were sampled at once.\n");
+            failed = 1;
+        }
+        checkCollapsedStacks(profiledContext, "spinForSamples");
+        JSStopSamplingProfiler(otherContext);
+    }
+
+    JSGlobalContextRelease(profiledContext);
+    JSGlobalContextRelease(otherContext);
+}
+
 int main(int argc, char* argv[])
 {
     const char *scriptPath = "testapi.js";
@@ -1346,6 +1444,8 @@ int main(int argc, char* argv[])
 
     printf("PASS: Infinite prototype chain does not occur.\n");
 
+    testSamplingProfiler();
+
     if (failed) {
         printf("FAIL: Some tests failed.\n");
         return 1;
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2010 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Measures how API throughput scales with threads when every thread has a
+ * context group of its own, the way a server runs one group per request
+ * thread. Each run doubles the number of threads; with no shared lock, the
+ * work done per second should double with it, up to the number of cores.
+ * Efficiency is the speedup divided by the number of cores the threads can
+ * use, so on a machine with fewer cores than threads it only shows that
+ * adding threads costs nothing; it says nothing about scaling.
+ *
+ * Usage: threadbench [max threads] [requests per thread]
+ */
+
+#include "JavaScript.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <wtf/UnusedParam.h>
+
+static const char* requestSource =
+    "var total = 0;"
+    "for (var i = 0; i < 200; ++i)"
+    "    total = add(total, String(i).length + [i, i + 1].join('-').length);"
+    "total;";
+
+static pthread_mutex_t startMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t startCondition = PTHREAD_COND_INITIALIZER;
+static int readyThreads;
+static int started;
+static int requestsPerThread;
+
+static double currentTime(void)
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return now.tv_sec + now.tv_usec / 1000000.0;
+}
+
+static JSValueRef add(JSContextRef context, JSObjectRef function, JSObjectRef thisObject, size_t argumentCount, const JSValueRef arguments[], JSValueRef* exception)
+{
+    UNUSED_PARAM(function);
+    UNUSED_PARAM(thisObject);
+
+    if (argumentCount < 2)
+        return JSValueMakeUndefined(context);
+    return JSValueMakeNumber(context, JSValueToNumber(context, arguments[0], exception) + JSValueToNumber(context, arguments[1], exception));
+}
+
+static void* runRequests(void* unused)
+{
+    JSContextGroupRef group;
+    JSGlobalContextRef context;
+    JSStringRef addName;
+    JSStringRef source;
+    double expected = -1;
+    int failed = 0;
+    int i;
+
+    UNUSED_PARAM(unused);
+
+    /* The context keeps the group alive, and destroys its heap on release. */
+    group = JSContextGroupCreate();
+    context = JSGlobalContextCreateInGroup(group, NULL);
+    JSContextGroupRelease(group);
+    addName = JSStringCreateWithUTF8CString("add");
+    JSObjectSetProperty(context, JSContextGetGlobalObject(context), addName, JSObjectMakeFunctionWithCallback(context, addName, add), kJSPropertyAttributeNone, NULL);
+    JSStringRelease(addName);
+    source = JSStringCreateWithUTF8CString(requestSource);
+
+    pthread_mutex_lock(&startMutex);
+    ++readyThreads;
+    pthread_cond_broadcast(&startCondition);
+    while (!started)
+        pthread_cond_wait(&startCondition, &startMutex);
+    pthread_mutex_unlock(&startMutex);
+
+    for (i = 0; i < requestsPerThread; ++i) {
+        JSValueRef result = JSEvaluateScript(context, source, NULL, NULL, 1, NULL);
+        double value = result ? JSValueToNumber(context, result, NULL) : -1;
+        if (expected < 0)
+            expected = value;
+        if (value != expected || value < 0)
+            failed = 1;
+    }
+
+    JSStringRelease(source);
+    JSGlobalContextRelease(context);
+    return failed ? (void*)1 : NULL;
+}
+
+/* Returns the requests handled per second by threadCount threads, or a
+   negative number if any request failed. */
+static double runThreads(int threadCount)
+{
+    pthread_t* threads = (pthread_t*)malloc(threadCount * sizeof(pthread_t));
+    double startTime;
+    double elapsed;
+    int failed = 0;
+    int i;
+
+    readyThreads = 0;
+    started = 0;
+    for (i = 0; i < threadCount; ++i)
+        pthread_create(&threads[i], NULL, runRequests, NULL);
+
+    /* Creating the context groups is not part of what is measured. */
+    pthread_mutex_lock(&startMutex);
+    while (readyThreads < threadCount)
+        pthread_cond_wait(&startCondition, &startMutex);
+    started = 1;
+    startTime = currentTime();
+    pthread_cond_broadcast(&startCondition);
+    pthread_mutex_unlock(&startMutex);
+
+    for (i = 0; i < threadCount; ++i) {
+        void* threadResult;
+        pthread_join(threads[i], &threadResult);
+        if (threadResult)
+            failed = 1;
+    }
+    elapsed = currentTime() - startTime;
+
+    free(threads);
+    if (failed)
+        return -1;
+    return threadCount * requestsPerThread / elapsed;
+}
+
+int main(int argc, char* argv[])
+{
+    int maxThreads = argc > 1 ? atoi(argv[1]) : 8;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    double baseline = 0;
+    int threadCount;
+
+    requestsPerThread = argc > 2 ? atoi(argv[2]) : 2000;
+    if (maxThreads < 1 || requestsPerThread < 1) {
+        fprintf(stderr, "Usage: %s [max threads] [requests per thread]\n", argv[0]);
+        return 1;
+    }
+
+    if (cores < 1)
+        cores = 1;
+    printf("%ld core(s) online", cores);
+    if (cores < maxThreads)
+        printf("; runs with more threads than cores do not measure scaling");
+    printf("\n");
+
+    printf("%8s %16s %8s %11s\n", "threads", "requests/second", "speedup", "efficiency");
+    for (threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+        double throughput = runThreads(threadCount);
+        if (throughput < 0) {
+            printf("FAIL: a request on %d threads returned the wrong result\n", threadCount);
+            return 1;
+        }
+        if (threadCount == 1)
+            baseline = throughput;
+        printf("%8d %16.0f %7.2fx %10.0f%%\n", threadCount, throughput, throughput / baseline, 100 * throughput / baseline / (threadCount < cores ? threadCount : cores));
+    }
+
+    return 0;
+}
@@ -28,6 +28,7 @@ LOCAL_SRC_FILES := \
 	API/JSCallbackObject.cpp \
 	API/OpaqueJSString.cpp \
 	\
+	bytecode/BytecodeCache.cpp \
 	bytecode/CodeBlock.cpp \
 	bytecode/JumpTable.cpp \
 	bytecode/Opcode.cpp \
@@ -51,6 +52,7 @@ LOCAL_SRC_FILES := \
 	jit/JIT.cpp \
 	jit/JITArithmetic.cpp \
 	jit/JITCall.cpp \
+	jit/JITIntrinsics.cpp \
 	jit/JITOpcodes.cpp \
 	jit/JITPropertyAccess.cpp \
 	jit/JITStubs.cpp \
@@ -70,6 +72,7 @@ LOCAL_SRC_FILES := \
 	profiler/ProfileGenerator.cpp \
 	profiler/ProfileNode.cpp \
 	profiler/Profiler.cpp \
+	profiler/SamplingProfiler.cpp \
 	\
 	runtime/ArgList.cpp \
 	runtime/Arguments.cpp \
@@ -126,6 +129,7 @@ LOCAL_SRC_FILES := \
 	runtime/MarkStack.cpp \
 	runtime/MarkStackPosix.cpp \
 	runtime/MathObject.cpp \
+	runtime/MegamorphicCache.cpp \
 	runtime/NativeErrorConstructor.cpp \
 	runtime/NativeErrorPrototype.cpp \
 	runtime/NumberConstructor.cpp \
@@ -139,6 +143,7 @@ LOCAL_SRC_FILES := \
 	runtime/PropertySlot.cpp \
 	runtime/PrototypeFunction.cpp \
 	runtime/RegExp.cpp \
+	runtime/RegExpCache.cpp \
 	runtime/RegExpConstructor.cpp \
 	runtime/RegExpObject.cpp \
 	runtime/RegExpPrototype.cpp \
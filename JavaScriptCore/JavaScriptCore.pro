@@ -71,6 +71,7 @@ SOURCES += \
     API/OpaqueJSString.cpp \
     assembler/ARMAssembler.cpp \
     assembler/MacroAssemblerARM.cpp \
+    bytecode/BytecodeCache.cpp \
     bytecode/CodeBlock.cpp \
     bytecode/JumpTable.cpp \
     bytecode/Opcode.cpp \
@@ -92,6 +93,7 @@ SOURCES += \
     jit/JITArithmetic.cpp \
     jit/JITCall.cpp \
     jit/JIT.cpp \
+    jit/JITIntrinsics.cpp \
     jit/JITOpcodes.cpp \
     jit/JITPropertyAccess.cpp \
     jit/JITPropertyAccess32_64.cpp \
@@ -104,6 +106,7 @@ SOURCES += \
     profiler/ProfileGenerator.cpp \
     profiler/ProfileNode.cpp \
     profiler/Profiler.cpp \
+    profiler/SamplingProfiler.cpp \
     runtime/ArgList.cpp \
     runtime/Arguments.cpp \
     runtime/ArrayConstructor.cpp \
@@ -161,6 +164,7 @@ SOURCES += \
     runtime/MarkStackWin.cpp \
     runtime/MarkStack.cpp \
     runtime/MathObject.cpp \
+    runtime/MegamorphicCache.cpp \
     runtime/NativeErrorConstructor.cpp \
     runtime/NativeErrorPrototype.cpp \
     runtime/NumberConstructor.cpp \
@@ -175,6 +179,7 @@ SOURCES += \
     runtime/PrototypeFunction.cpp \
     runtime/RegExpConstructor.cpp \
     runtime/RegExp.cpp \
+    runtime/RegExpCache.cpp \
     runtime/RegExpObject.cpp \
     runtime/RegExpPrototype.cpp \
     runtime/ScopeChain.cpp \
@@ -409,6 +409,12 @@ public:
         m_assembler.subsd_mr(src.offset, src.base, dest);
     }
 
+    void sqrtDouble(FPRegisterID src, FPRegisterID dest)
+    {
+        ASSERT(isSSE2Present());
+        m_assembler.sqrtsd_rr(src, dest);
+    }
+
     void mulDouble(FPRegisterID src, FPRegisterID dest)
     {
         ASSERT(isSSE2Present());
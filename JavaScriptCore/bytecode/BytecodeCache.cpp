@@ -0,0 +1,2259 @@
+/*
+ * Copyright (C) 2010 Apple Inc. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "BytecodeCache.h"
+
+#include "BytecodeGenerator.h"
+#include "CodeBlock.h"
+#include "Executable.h"
+#include "Interpreter.h"
+#include "JSGlobalObject.h"
+#include "JSString.h"
+#include "NativeFunctionWrapper.h"
+#include "Parser.h"
+#include "PrototypeFunction.h"
+#include "RegExpCache.h"
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+
+namespace JSC {
+
+// Bump this whenever the layout of an entry changes, or opcodes are renumbered.
+static const uint32_t cacheFileMagic = 0x4342534A; // "JSBC"
+static const uint32_t cacheFileVersion = 4;
+
+static const uint32_t nullStringLength = 0xFFFFFFFF;
+
+enum ConstantKind {
+    EmptyConstant,
+    UndefinedConstant,
+    NullConstant,
+    TrueConstant,
+    FalseConstant,
+    NumberConstant,
+    StringConstant,
+    GlobalObjectConstant
+};
+
+// The generator embeds a few cells in the instruction stream. All of them
+// belong to the global object, so they are saved as one of these and found
+// again in the global object the code is loaded into.
+enum CellOperand {
+    GlobalObjectOperand,
+    CallFunctionOperand,
+    ApplyFunctionOperand
+};
+
+static uint32_t configurationBits()
+{
+    uint32_t bits = 0;
+#if ENABLE(JIT)
+    bits |= 1 << 0;
+#endif
+    return bits;
+}
+
+static uint32_t opcodeLengthsHash()
+{
+    uint32_t hash = numOpcodeIDs;
+    for (int i = 0; i < numOpcodeIDs; ++i)
+        hash = hash * 31 + opcodeLengths[i];
+    return hash;
+}
+
+// Returns the index of the operand holding a cell, or 0 if the opcode has none.
+static int cellOperandIndex(OpcodeID opcodeID)
+{
+    switch (opcodeID) {
+    case op_resolve_global:
+    case op_get_global_var:
+    case op_jneq_ptr:
+        return 2;
+    case op_put_global_var:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+// Describes the operands of each opcode the generator emits, one character per
+// operand, so that a decoded entry can be checked before it is used:
+//   r  a register the opcode reads: a local, a parameter or a constant
+//   w  a register the opcode writes
+//   m  a register the opcode reads and writes
+//   u  a register the opcode reads, which may hold the empty value
+//   t  a register the opcode uses in a way of its own; see CachedCodeVerifier
+//   a  the first of a run of registers that are read; the next operand is its length
+//   o  the register offset of a call; the operand before it is the argument count
+//   O  the initial register offset of a varargs call
+//   i  an identifier          x  a regular expression
+//   f  a function declaration e  a function expression
+//   I, C, S  an immediate, character or string switch table
+//   j  a jump, relative to the start of the instruction
+//   v  a scoped variable; the next operand is its depth
+//   d  a depth in the scope chain
+//   g  a global variable
+//   p  a number of scopes to pop
+//   G  the global object
+//   c  the global object or one of its functions, checked when it was decoded
+//   z  a cache slot, which must still be empty
+//   n  a number that needs no checking
+// Opcodes the generator never emits, such as the specialized forms of
+// get_by_id and put_by_id, have no entry, and cached code using them is
+// rejected.
+static const char* operandKinds(OpcodeID opcodeID)
+{
+    switch (opcodeID) {
+    case op_enter:
+    case op_init_arguments:
+    case op_create_arguments:
+    case op_tear_off_arguments:
+    case op_method_check:
+    case op_pop_scope:
+        return "";
+    case op_enter_with_activation:
+    case op_tear_off_activation:
+    case op_push_scope:
+    case op_sret:
+    case op_convert_this:
+        return "t";
+    case op_pre_inc:
+    case op_pre_dec:
+        return "m";
+    case op_new_object:
+    case op_catch:
+        return "w";
+    case op_ret:
+    case op_throw:
+    case op_profile_will_call:
+    case op_profile_did_call:
+    case op_end:
+        return "r";
+    case op_new_array:
+    case op_strcat:
+        return "wan";
+    case op_new_regexp:
+        return "wx";
+    case op_mov:
+        return "wu";
+    case op_not:
+    case op_eq_null:
+    case op_neq_null:
+    case op_to_jsnumber:
+    case op_negate:
+    case op_bitnot:
+    case op_typeof:
+    case op_is_undefined:
+    case op_is_boolean:
+    case op_is_number:
+    case op_is_string:
+    case op_is_object:
+    case op_is_function:
+    case op_to_primitive:
+        return "wr";
+    case op_post_inc:
+    case op_post_dec:
+        return "wm";
+    case op_construct_verify:
+        return "mt";
+    case op_load_varargs:
+        return "tu";
+    case op_eq:
+    case op_neq:
+    case op_stricteq:
+    case op_nstricteq:
+    case op_less:
+    case op_lesseq:
+    case op_mod:
+    case op_lshift:
+    case op_rshift:
+    case op_urshift:
+    case op_in:
+    case op_get_by_val:
+    case op_del_by_val:
+        return "wrr";
+    case op_get_argument_by_val:
+        return "wur";
+    case op_put_by_val:
+        return "rrr";
+    case op_add:
+    case op_mul:
+    case op_div:
+    case op_sub:
+    case op_bitand:
+    case op_bitxor:
+    case op_bitor:
+        return "wrrn";
+    case op_instanceof:
+        return "wrrr";
+    case op_resolve:
+    case op_resolve_base:
+        return "wi";
+    case op_resolve_skip:
+        return "wid";
+    case op_resolve_global:
+        return "wGizz";
+    case op_get_scoped_var:
+        return "wvd";
+    case op_put_scoped_var:
+        return "vdr";
+    case op_get_global_var:
+        return "wGg";
+    case op_put_global_var:
+        return "Ggr";
+    case op_resolve_with_base:
+        return "wwi";
+    case op_get_arguments_length:
+        return "wui";
+    case op_del_by_id:
+        return "wri";
+    case op_get_by_id:
+        return "wrizzzz";
+    case op_put_by_id:
+        return "rirzzzz";
+    case op_get_by_pname:
+        return "wrrrtt";
+    case op_put_by_index:
+        return "rnr";
+    case op_put_getter:
+    case op_put_setter:
+        return "rir";
+    case op_push_new_scope:
+        return "tir";
+    case op_jmp:
+    case op_loop:
+        return "j";
+    case op_jtrue:
+    case op_jfalse:
+    case op_jeq_null:
+    case op_jneq_null:
+    case op_loop_if_true:
+    case op_loop_if_false:
+        return "rj";
+    case op_jsr:
+        return "tj";
+    case op_jneq_ptr:
+        return "rcj";
+    case op_jnless:
+    case op_jnlesseq:
+    case op_jless:
+    case op_loop_if_less:
+    case op_loop_if_lesseq:
+        return "rrj";
+    case op_jmp_scopes:
+        return "pj";
+    case op_switch_imm:
+        return "Ijr";
+    case op_switch_char:
+        return "Cjr";
+    case op_switch_string:
+        return "Sjr";
+    case op_new_func:
+        return "wf";
+    case op_new_func_exp:
+        return "we";
+    case op_call:
+    case op_call_eval:
+        return "wrno";
+    case op_call_varargs:
+        return "wrtO";
+    case op_construct:
+        return "wrnort";
+    case op_get_pnames:
+        return "trttj";
+    case op_next_pname:
+        return "tttttj";
+    case op_new_error:
+        return "wnr";
+    case op_debug:
+        return "nnn";
+    default:
+        return 0;
+    }
+}
+
+static bool encodeCellOperand(JSGlobalObject* globalObject, JSCell* cell, int32_t& operand)
+{
+    if (cell == globalObject)
+        operand = GlobalObjectOperand;
+    else if (cell == globalObject->d()->callFunction)
+        operand = CallFunctionOperand;
+    else if (cell == globalObject->d()->applyFunction)
+        operand = ApplyFunctionOperand;
+    else
+        return false;
+    return true;
+}
+
+static JSCell* decodeCellOperand(JSGlobalObject* globalObject, int32_t operand)
+{
+    switch (operand) {
+    case GlobalObjectOperand:
+        return globalObject;
+    case CallFunctionOperand:
+        return globalObject->d()->callFunction;
+    case ApplyFunctionOperand:
+        return globalObject->d()->applyFunction;
+    default:
+        return 0;
+    }
+}
+
+static inline uint32_t addToDigest(uint32_t hash, uint32_t value)
+{
+    return (hash ^ value) * 16777619U;
+}
+
+static uint32_t addToDigest(uint32_t hash, const UChar* characters, unsigned length)
+{
+    hash = addToDigest(hash, length);
+    for (unsigned i = 0; i < length; ++i)
+        hash = addToDigest(hash, characters[i]);
+    return hash;
+}
+
+static uint32_t addToDigest(uint32_t hash, const UString& string)
+{
+    return addToDigest(hash, string.data(), string.size());
+}
+
+static uint32_t checksum(const char* data, unsigned length)
+{
+    uint32_t hash = 2166136261U;
+    for (unsigned i = 0; i < length; ++i)
+        hash = addToDigest(hash, static_cast<unsigned char>(data[i]));
+    return hash;
+}
+
+static UString regExpFlags(RegExp* regExp)
+{
+    UChar flags[3];
+    int length = 0;
+    if (regExp->global())
+        flags[length++] = 'g';
+    if (regExp->ignoreCase())
+        flags[length++] = 'i';
+    if (regExp->multiline())
+        flags[length++] = 'm';
+    return UString(flags, length);
+}
+
+class BytecodeWriter {
+public:
+    BytecodeWriter(Vector<char>& buffer)
+        : m_buffer(buffer)
+    {
+    }
+
+    template<typename T> void write(T value)
+    {
+        m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    // Function names are null for anonymous functions, which matters, so null
+    // strings are kept apart from empty ones.
+    void writeString(const UString& string)
+    {
+        if (string.isNull()) {
+            write<uint32_t>(nullStringLength);
+            return;
+        }
+        write<uint32_t>(string.size());
+        m_buffer.append(reinterpret_cast<const char*>(string.data()), string.size() * sizeof(UChar));
+    }
+
+    void writeCharacters(const UChar* characters, unsigned length)
+    {
+        write<uint32_t>(length);
+        m_buffer.append(reinterpret_cast<const char*>(characters), length * sizeof(UChar));
+    }
+
+    void writeParameters(const FunctionParameters& parameters)
+    {
+        write<uint32_t>(parameters.size());
+        for (size_t i = 0; i < parameters.size(); ++i)
+            writeString(parameters[i].ustring());
+    }
+
+private:
+    Vector<char>& m_buffer;
+};
+
+class BytecodeReader {
+public:
+    BytecodeReader(const char* data, size_t length)
+        : m_position(data)
+        , m_end(data + length)
+    {
+    }
+
+    size_t remaining() const { return m_end - m_position; }
+
+    template<typename T> bool read(T& value)
+    {
+        if (remaining() < sizeof(T))
+            return false;
+        memcpy(&value, m_position, sizeof(T));
+        m_position += sizeof(T);
+        return true;
+    }
+
+    // Reads a count of items that each take at least minimumItemSize bytes.
+    bool readCount(uint32_t& count, size_t minimumItemSize = 1)
+    {
+        return read(count) && count <= remaining() / minimumItemSize;
+    }
+
+    bool readString(UString& string)
+    {
+        uint32_t length;
+        if (!read(length))
+            return false;
+        if (length == nullStringLength) {
+            string = UString();
+            return true;
+        }
+        if (length > remaining() / sizeof(UChar))
+            return false;
+        // The characters may not be aligned, so copy them out.
+        Vector<UChar, 64> characters(length);
+        memcpy(characters.data(), m_position, length * sizeof(UChar));
+        m_position += length * sizeof(UChar);
+        string = UString(characters.data(), length);
+        return true;
+    }
+
+    // Reads characters written by writeCharacters, and checks that they are
+    // the given ones.
+    bool readMatchingCharacters(const UChar* characters, unsigned length)
+    {
+        uint32_t storedLength;
+        if (!read(storedLength) || storedLength != length || length > remaining() / sizeof(UChar))
+            return false;
+        if (memcmp(m_position, characters, length * sizeof(UChar)))
+            return false;
+        m_position += length * sizeof(UChar);
+        return true;
+    }
+
+    bool readIdentifier(JSGlobalData* globalData, Identifier& identifier)
+    {
+        UString string;
+        if (!readString(string))
+            return false;
+        identifier = string.isNull() ? Identifier() : Identifier(globalData, string);
+        return true;
+    }
+
+    bool readParameters(JSGlobalData* globalData, RefPtr<FunctionParameters>& parameters)
+    {
+        uint32_t count;
+        if (!readCount(count, sizeof(uint32_t)))
+            return false;
+        parameters = FunctionParameters::create(0);
+        for (uint32_t i = 0; i < count; ++i) {
+            Identifier parameter;
+            if (!readIdentifier(globalData, parameter))
+                return false;
+            parameters->append(parameter);
+        }
+        return true;
+    }
+
+    bool readBool(bool& value)
+    {
+        uint8_t byte;
+        if (!read(byte))
+            return false;
+        value = byte;
+        return true;
+    }
+
+private:
+    const char* m_position;
+    const char* m_end;
+};
+
+BytecodeCache::BytecodeCache()
+    : m_maxSize(defaultMaxSize)
+    , m_hits(0)
+    , m_misses(0)
+{
+}
+
+BytecodeCache::~BytecodeCache()
+{
+}
+
+uint64_t BytecodeCache::keyFor(FunctionExecutable* executable)
+{
+    const SourceCode& source = executable->source();
+    uint32_t textHash = UString::Rep::computeHash(source.data(), source.length());
+
+    uint32_t signatureHash = addToDigest(2166136261U, source.data(), source.length());
+    signatureHash = addToDigest(signatureHash, executable->m_name.ustring());
+    const FunctionParameters& parameters = *executable->m_parameters;
+    signatureHash = addToDigest(signatureHash, parameters.size());
+    for (size_t i = 0; i < parameters.size(); ++i)
+        signatureHash = addToDigest(signatureHash, parameters[i].ustring());
+    signatureHash = addToDigest(signatureHash, executable->m_forceUsesArguments);
+
+    uint64_t key = (static_cast<uint64_t>(textHash) << 32) | signatureHash;
+    // The hash table reserves 0 and -1.
+    if (!key || key == static_cast<uint64_t>(-1))
+        key = 1;
+    return key;
+}
+
+void BytecodeCache::addEntry(uint64_t key, const char* data, unsigned length)
+{
+    if (length > m_maxSize / 2)
+        return;
+    if (m_data.size() + length > m_maxSize)
+        evictOldestEntries(m_maxSize / 2);
+
+    unsigned offset = m_data.size();
+    m_data.append(data, length);
+    std::pair<EntryMap::iterator, bool> result = m_entries.add(key, std::make_pair(offset, length));
+    if (!result.second)
+        result.first->second = std::make_pair(offset, length);
+}
+
+struct EntryLocation {
+    uint64_t key;
+    unsigned offset;
+    unsigned length;
+};
+
+static bool isNewer(const EntryLocation& a, const EntryLocation& b)
+{
+    return a.offset > b.offset;
+}
+
+static bool isOlder(const EntryLocation& a, const EntryLocation& b)
+{
+    return a.offset < b.offset;
+}
+
+void BytecodeCache::evictOldestEntries(size_t bytesToKeep)
+{
+    Vector<EntryLocation> entries;
+    EntryMap::iterator end = m_entries.end();
+    for (EntryMap::iterator it = m_entries.begin(); it != end; ++it) {
+        EntryLocation entry = { it->first, it->second.first, it->second.second };
+        entries.append(entry);
+    }
+
+    // Keep the newest entries that fit. Replaced entries are not in the map,
+    // so their space is reclaimed too.
+    std::sort(entries.begin(), entries.end(), isNewer);
+    size_t keptSize = 0;
+    size_t keptCount = 0;
+    while (keptCount < entries.size() && keptSize + entries[keptCount].length <= bytesToKeep)
+        keptSize += entries[keptCount++].length;
+    entries.shrink(keptCount);
+    std::sort(entries.begin(), entries.end(), isOlder);
+
+    Vector<char> data;
+    data.reserveCapacity(keptSize);
+    m_entries.clear();
+    for (size_t i = 0; i < entries.size(); ++i) {
+        m_entries.add(entries[i].key, std::make_pair(static_cast<unsigned>(data.size()), entries[i].length));
+        data.append(m_data.data() + entries[i].offset, entries[i].length);
+    }
+    m_data.swap(data);
+}
+
+void BytecodeCache::setMaxSize(size_t maxSize)
+{
+    m_maxSize = maxSize;
+    if (m_data.size() > m_maxSize)
+        evictOldestEntries(m_maxSize);
+}
+
+bool BytecodeCache::load(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return false;
+
+    Vector<char> contents;
+    char buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)))
+        contents.append(buffer, count);
+    bool readFailed = ferror(file);
+    fclose(file);
+    if (readFailed)
+        return false;
+
+    BytecodeReader reader(contents.data(), contents.size());
+    uint32_t magic, version, opcodeCount, opcodeHash, configuration, entryCount;
+    if (!reader.read(magic) || magic != cacheFileMagic
+        || !reader.read(version) || version != cacheFileVersion
+        || !reader.read(opcodeCount) || opcodeCount != static_cast<uint32_t>(numOpcodeIDs)
+        || !reader.read(opcodeHash) || opcodeHash != opcodeLengthsHash()
+        || !reader.read(configuration) || configuration != configurationBits()
+        || !reader.readCount(entryCount, sizeof(uint64_t) + 2 * sizeof(uint32_t)))
+        return false;
+
+    // Check the whole file before adding any of it.
+    Vector<std::pair<uint64_t, const char*> > entries;
+    Vector<uint32_t> lengths;
+    for (uint32_t i = 0; i < entryCount; ++i) {
+        uint64_t key;
+        uint32_t length;
+        uint32_t entryChecksum;
+        if (!reader.read(key) || !key || key == static_cast<uint64_t>(-1)
+            || !reader.read(length) || !reader.read(entryChecksum) || length > reader.remaining())
+            return false;
+        const char* data = contents.data() + (contents.size() - reader.remaining());
+        if (checksum(data, length) != entryChecksum)
+            return false;
+        entries.append(std::make_pair(key, data));
+        lengths.append(length);
+        for (uint32_t skipped = 0; skipped < length; ++skipped) {
+            uint8_t byte;
+            reader.read(byte);
+        }
+    }
+    if (reader.remaining())
+        return false;
+
+    for (size_t i = 0; i < entries.size(); ++i)
+        addEntry(entries[i].first, entries[i].second, lengths[i]);
+    return true;
+}
+
+bool BytecodeCache::save(const char* path) const
+{
+    FILE* file = fopen(path, "wb");
+    if (!file)
+        return false;
+
+    Vector<char> contents;
+    BytecodeWriter writer(contents);
+    writer.write<uint32_t>(cacheFileMagic);
+    writer.write<uint32_t>(cacheFileVersion);
+    writer.write<uint32_t>(numOpcodeIDs);
+    writer.write<uint32_t>(opcodeLengthsHash());
+    writer.write<uint32_t>(configurationBits());
+    writer.write<uint32_t>(m_entries.size());
+    EntryMap::const_iterator end = m_entries.end();
+    for (EntryMap::const_iterator it = m_entries.begin(); it != end; ++it) {
+        const char* data = m_data.data() + it->second.first;
+        unsigned length = it->second.second;
+        writer.write<uint64_t>(it->first);
+        writer.write<uint32_t>(length);
+        writer.write<uint32_t>(checksum(data, length));
+        contents.append(data, length);
+    }
+
+    bool succeeded = fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    return !fclose(file) && succeeded;
+}
+
+bool BytecodeCache::decode(FunctionExecutable* executable, const ScopeChain& scopeChain)
+{
+    ASSERT(!executable->m_codeBlock);
+
+    EntryMap::iterator it = m_entries.find(keyFor(executable));
+    if (it != m_entries.end()) {
+        BytecodeReader reader(m_data.data() + it->second.first, it->second.second);
+        if (decodeCodeBlock(reader, executable, scopeChain)) {
+            ++m_hits;
+            return true;
+        }
+        delete executable->m_codeBlock;
+        executable->m_codeBlock = 0;
+    }
+
+    ++m_misses;
+    return false;
+}
+
+void BytecodeCache::encode(FunctionExecutable* executable, const ScopeChain& scopeChain, const Vector<ScopedPropertyLookup>& lookups)
+{
+    Vector<char> entry;
+    BytecodeWriter writer(entry);
+    if (!encodeCodeBlock(writer, executable, scopeChain, lookups))
+        return;
+    addEntry(keyFor(executable), entry.data(), entry.size());
+}
+
+bool BytecodeCache::encodeCodeBlock(BytecodeWriter& writer, FunctionExecutable* executable, const ScopeChain& scopeChain, const Vector<ScopedPropertyLookup>& lookups)
+{
+    CodeBlock* codeBlock = executable->m_codeBlock;
+    JSGlobalObject* globalObject = scopeChain.globalObject();
+    Interpreter* interpreter = globalObject->globalData()->interpreter;
+    const SourceCode& source = executable->source();
+    int baseOffset = source.startOffset();
+    int baseLine = source.firstLine();
+
+    // The key is only a digest, so the entry keeps the source text itself.
+    writer.writeCharacters(source.data(), source.length());
+
+    // What the parser would have found out.
+    writer.writeString(executable->m_name.ustring());
+    writer.writeParameters(*executable->m_parameters);
+    writer.write<uint32_t>(executable->m_features);
+    writer.write<int32_t>(executable->m_firstLine - baseLine);
+    writer.write<int32_t>(executable->m_lastLine - baseLine);
+
+    // What the generator found out from the scope chain.
+    writer.write<uint8_t>(globalObject->supportsProfiling());
+    writer.write<uint32_t>(lookups.size());
+    for (size_t i = 0; i < lookups.size(); ++i) {
+        const ScopedPropertyLookup& lookup = lookups[i];
+        writer.writeString(lookup.property.ustring());
+        writer.write<uint8_t>(lookup.forWriting);
+        writer.write<uint8_t>(lookup.canOptimize);
+        writer.write<int32_t>(lookup.index);
+        writer.write<uint32_t>(lookup.depth);
+        writer.write<uint8_t>(lookup.hasGlobalObject);
+    }
+
+    writer.write<int32_t>(codeBlock->m_numCalleeRegisters);
+    writer.write<int32_t>(codeBlock->m_numVars);
+    writer.write<int32_t>(codeBlock->m_numParameters);
+    writer.write<int32_t>(codeBlock->m_thisRegister);
+    writer.write<uint8_t>(codeBlock->m_needsFullScopeChain);
+    writer.write<uint8_t>(codeBlock->m_usesEval);
+    writer.write<uint8_t>(codeBlock->m_usesArguments);
+    writer.write<uint8_t>(codeBlock->m_compareFunctionType);
+
+    const Vector<Instruction>& instructions = codeBlock->m_instructions;
+    writer.write<uint32_t>(instructions.size());
+    for (size_t i = 0; i < instructions.size(); ) {
+        OpcodeID opcodeID = interpreter->getOpcodeID(instructions[i].u.opcode);
+        writer.write<uint32_t>(opcodeID);
+        int cellOperand = cellOperandIndex(opcodeID);
+        for (int j = 1; j < opcodeLengths[opcodeID]; ++j) {
+            const Instruction& instruction = instructions[i + j];
+            int32_t operand = instruction.u.operand;
+            if (j == cellOperand) {
+                if (!encodeCellOperand(globalObject, instruction.u.jsCell, operand))
+                    return false;
+            } else if (Instruction(operand).u.jsCell != instruction.u.jsCell)
+                return false; // A pointer we don't know how to relocate.
+            writer.write<int32_t>(operand);
+        }
+        i += opcodeLengths[opcodeID];
+    }
+
+    writer.write<uint32_t>(codeBlock->m_jumpTargets.size());
+    for (size_t i = 0; i < codeBlock->m_jumpTargets.size(); ++i)
+        writer.write<uint32_t>(codeBlock->m_jumpTargets[i]);
+
+    writer.write<uint32_t>(codeBlock->m_identifiers.size());
+    for (size_t i = 0; i < codeBlock->m_identifiers.size(); ++i)
+        writer.writeString(codeBlock->m_identifiers[i].ustring());
+
+    writer.write<uint32_t>(codeBlock->m_constantRegisters.size());
+    for (size_t i = 0; i < codeBlock->m_constantRegisters.size(); ++i) {
+        JSValue value = codeBlock->m_constantRegisters[i].jsValue();
+        if (!value)
+            writer.write<uint8_t>(EmptyConstant);
+        else if (value.isUndefined())
+            writer.write<uint8_t>(UndefinedConstant);
+        else if (value.isNull())
+            writer.write<uint8_t>(NullConstant);
+        else if (value.isBoolean())
+            writer.write<uint8_t>(value.isTrue() ? TrueConstant : FalseConstant);
+        else if (value.isNumber()) {
+            writer.write<uint8_t>(NumberConstant);
+            writer.write<double>(value.uncheckedGetNumber());
+        } else if (value.isString()) {
+            UString string = asString(value)->tryGetValue();
+            if (string.isNull())
+                return false;
+            writer.write<uint8_t>(StringConstant);
+            writer.writeString(string);
+        } else if (value == globalObject)
+            writer.write<uint8_t>(GlobalObjectConstant);
+        else
+            return false;
+    }
+
+    for (int list = 0; list < 2; ++list) {
+        const Vector<RefPtr<FunctionExecutable> >& functions = list ? codeBlock->m_functionExprs : codeBlock->m_functionDecls;
+        writer.write<uint32_t>(functions.size());
+        for (size_t i = 0; i < functions.size(); ++i) {
+            FunctionExecutable* function = functions[i].get();
+            const SourceCode& functionSource = function->source();
+            if (functionSource.provider() != source.provider())
+                return false;
+            writer.writeString(function->m_name.ustring());
+            writer.writeParameters(*function->m_parameters);
+            writer.write<uint8_t>(function->m_forceUsesArguments);
+            writer.write<int32_t>(functionSource.startOffset() - baseOffset);
+            writer.write<int32_t>(functionSource.endOffset() - baseOffset);
+            writer.write<int32_t>(functionSource.firstLine() - baseLine);
+            writer.write<int32_t>(function->m_firstLine - baseLine);
+            writer.write<int32_t>(function->m_lastLine - baseLine);
+        }
+    }
+
+    CodeBlock::RareData* rareData = codeBlock->m_rareData.get();
+
+    writer.write<uint32_t>(rareData ? rareData->m_regexps.size() : 0);
+    for (size_t i = 0; rareData && i < rareData->m_regexps.size(); ++i) {
+        writer.writeString(rareData->m_regexps[i]->pattern());
+        writer.writeString(regExpFlags(rareData->m_regexps[i].get()));
+    }
+
+    writer.write<uint32_t>(codeBlock->numberOfExceptionHandlers());
+    for (size_t i = 0; i < codeBlock->numberOfExceptionHandlers(); ++i) {
+        const HandlerInfo& handler = codeBlock->exceptionHandler(i);
+        writer.write<uint32_t>(handler.start);
+        writer.write<uint32_t>(handler.end);
+        writer.write<uint32_t>(handler.target);
+        writer.write<uint32_t>(handler.scopeDepth);
+    }
+
+    for (int list = 0; list < 2; ++list) {
+        size_t count = list ? codeBlock->numberOfCharacterSwitchJumpTables() : codeBlock->numberOfImmediateSwitchJumpTables();
+        writer.write<uint32_t>(count);
+        for (size_t i = 0; i < count; ++i) {
+            const SimpleJumpTable& jumpTable = list ? codeBlock->characterSwitchJumpTable(i) : codeBlock->immediateSwitchJumpTable(i);
+            writer.write<int32_t>(jumpTable.min);
+            writer.write<uint32_t>(jumpTable.branchOffsets.size());
+            for (size_t j = 0; j < jumpTable.branchOffsets.size(); ++j)
+                writer.write<int32_t>(jumpTable.branchOffsets[j]);
+        }
+    }
+
+    writer.write<uint32_t>(codeBlock->numberOfStringSwitchJumpTables());
+    for (size_t i = 0; i < codeBlock->numberOfStringSwitchJumpTables(); ++i) {
+        const StringJumpTable::StringOffsetTable& offsetTable = codeBlock->stringSwitchJumpTable(i).offsetTable;
+        writer.write<uint32_t>(offsetTable.size());
+        StringJumpTable::StringOffsetTable::const_iterator end = offsetTable.end();
+        for (StringJumpTable::StringOffsetTable::const_iterator it = offsetTable.begin(); it != end; ++it) {
+            writer.writeString(UString(it->first));
+            writer.write<int32_t>(it->second.branchOffset);
+        }
+    }
+
+#if ENABLE(JIT)
+    writer.write<uint32_t>(codeBlock->m_structureStubInfos.size());
+    for (size_t i = 0; i < codeBlock->m_structureStubInfos.size(); ++i)
+        writer.write<int32_t>(codeBlock->m_structureStubInfos[i].accessType);
+
+    writer.write<uint32_t>(codeBlock->m_globalResolveInfos.size());
+    for (size_t i = 0; i < codeBlock->m_globalResolveInfos.size(); ++i)
+        writer.write<uint32_t>(codeBlock->m_globalResolveInfos[i].bytecodeOffset);
+
+    writer.write<uint32_t>(codeBlock->m_callLinkInfos.size());
+
+    writer.write<uint32_t>(rareData ? rareData->m_functionRegisterInfos.size() : 0);
+    for (size_t i = 0; rareData && i < rareData->m_functionRegisterInfos.size(); ++i) {
+        writer.write<uint32_t>(rareData->m_functionRegisterInfos[i].bytecodeOffset);
+        writer.write<int32_t>(rareData->m_functionRegisterInfos[i].functionRegisterIndex);
+    }
+#else
+    writer.write<uint32_t>(codeBlock->m_propertyAccessInstructions.size());
+    for (size_t i = 0; i < codeBlock->m_propertyAccessInstructions.size(); ++i)
+        writer.write<uint32_t>(codeBlock->m_propertyAccessInstructions[i]);
+
+    writer.write<uint32_t>(codeBlock->m_globalResolveInstructions.size());
+    for (size_t i = 0; i < codeBlock->m_globalResolveInstructions.size(); ++i)
+        writer.write<uint32_t>(codeBlock->m_globalResolveInstructions[i]);
+#endif
+
+    SymbolTable& symbolTable = *codeBlock->m_symbolTable;
+    writer.write<uint32_t>(symbolTable.size());
+    SymbolTable::iterator end = symbolTable.end();
+    for (SymbolTable::iterator it = symbolTable.begin(); it != end; ++it) {
+        writer.writeString(UString(it->first));
+        writer.write<int32_t>(it->second.getIndex());
+        writer.write<uint32_t>(it->second.getAttributes());
+    }
+
+    // Reparsing makes exception info for code the generator made, which is
+    // not what cached code is, so the entry keeps its own.
+    ExceptionInfo* exceptionInfo = codeBlock->m_exceptionInfo.get();
+    if (!exceptionInfo)
+        return false;
+
+    writer.write<uint32_t>(exceptionInfo->m_expressionInfo.size());
+    for (size_t i = 0; i < exceptionInfo->m_expressionInfo.size(); ++i) {
+        const ExpressionRangeInfo& info = exceptionInfo->m_expressionInfo[i];
+        writer.write<uint32_t>(info.instructionOffset);
+        writer.write<uint32_t>(info.divotPoint);
+        writer.write<uint8_t>(info.startOffset);
+        writer.write<uint8_t>(info.endOffset);
+    }
+
+    writer.write<uint32_t>(exceptionInfo->m_lineInfo.size());
+    for (size_t i = 0; i < exceptionInfo->m_lineInfo.size(); ++i) {
+        writer.write<uint32_t>(exceptionInfo->m_lineInfo[i].instructionOffset);
+        writer.write<int32_t>(exceptionInfo->m_lineInfo[i].lineNumber - baseLine);
+    }
+
+    writer.write<uint32_t>(exceptionInfo->m_getByIdExceptionInfo.size());
+    for (size_t i = 0; i < exceptionInfo->m_getByIdExceptionInfo.size(); ++i) {
+        writer.write<uint32_t>(exceptionInfo->m_getByIdExceptionInfo[i].bytecodeOffset);
+        writer.write<uint8_t>(exceptionInfo->m_getByIdExceptionInfo[i].isOpConstruct);
+    }
+
+    return true;
+}
+
+// A register in the code block's own frame: a local, or a parameter
+// (including "this").
+static bool isVariableRegister(CodeBlock* codeBlock, int index)
+{
+    if (index >= 0)
+        return index < codeBlock->m_numCalleeRegisters;
+    return index < -RegisterFile::CallFrameHeaderSize && index >= -RegisterFile::CallFrameHeaderSize - codeBlock->m_numParameters;
+}
+
+static bool isLocalRegisterRun(CodeBlock* codeBlock, int first, int count)
+{
+    if (count < 0)
+        return false;
+    if (!count)
+        return true;
+    return first >= 0 && first < codeBlock->m_numCalleeRegisters && count <= codeBlock->m_numCalleeRegisters - first;
+}
+
+static bool isInstructionStart(const Vector<bool>& instructionStarts, int bytecodeOffset)
+{
+    return bytecodeOffset >= 0 && static_cast<size_t>(bytecodeOffset) < instructionStarts.size() && instructionStarts[bytecodeOffset];
+}
+
+static bool isScopedVariable(const Vector<ScopedPropertyLookup>& lookups, int index, int depth, bool global)
+{
+    for (size_t i = 0; i < lookups.size(); ++i) {
+        const ScopedPropertyLookup& lookup = lookups[i];
+        if (lookup.canOptimize && lookup.index == index && lookup.hasGlobalObject == global
+            && (global || lookup.depth == static_cast<size_t>(depth)))
+            return true;
+    }
+    return false;
+}
+
+static bool isValidSwitchTable(const SimpleJumpTable& jumpTable, const Vector<bool>& instructionStarts, int location)
+{
+    for (size_t i = 0; i < jumpTable.branchOffsets.size(); ++i) {
+        int offset = jumpTable.branchOffsets[i];
+        if (offset && !isInstructionStart(instructionStarts, location + offset))
+            return false;
+    }
+    return true;
+}
+
+static bool isValidSwitchTable(const StringJumpTable& jumpTable, const Vector<bool>& instructionStarts, int location)
+{
+    StringJumpTable::StringOffsetTable::const_iterator end = jumpTable.offsetTable.end();
+    for (StringJumpTable::StringOffsetTable::const_iterator it = jumpTable.offsetTable.begin(); it != end; ++it) {
+        if (!isInstructionStart(instructionStarts, location + it->second.branchOffset))
+            return false;
+    }
+    return true;
+}
+
+// What a register may hold at some point in cached code. Each kind of contents
+// lies within the one enclosingContents() returns for it: a register holding
+// an activation holds an object, and so any value.
+enum RegisterContents {
+    UnknownContents, // Never written, or left over from a callee's frame.
+    ValueOrEmpty, // Any value, or the empty value of an arguments object not yet made.
+    AnyValue,
+    ObjectValue,
+    ActivationValue,
+    ConstructedThis, // The "this" of op_construct, which a host constructor leaves alone.
+    UnconvertedThis, // The callee's own "this" before op_convert_this; the JIT takes it to be a cell.
+    PropertyNameIterator, // The state of a for-in loop, which only its own opcodes use.
+    AnyPropertyIndex,
+    FirstPropertyIndex, // May still be 0, before the first name.
+    NextPropertyIndex,
+    PropertyCount,
+    VarargsCount, // The argument count op_load_varargs leaves for op_call_varargs,
+    VarargsArgument, // and the registers it may have copied arguments into.
+    FirstReturnAddress // Plus the scope depth of the op_jsr that stored it.
+};
+
+static const int maxVerifiedScopeDepth = 255 - FirstReturnAddress;
+
+static uint8_t enclosingContents(uint8_t contents)
+{
+    switch (contents) {
+    case AnyValue:
+        return ValueOrEmpty;
+    case ObjectValue:
+        return AnyValue;
+    case ActivationValue:
+        return ObjectValue;
+    case FirstPropertyIndex:
+    case NextPropertyIndex:
+        return AnyPropertyIndex;
+    default:
+        return UnknownContents;
+    }
+}
+
+static bool holds(uint8_t contents, uint8_t required)
+{
+    for (;;) {
+        if (contents == required)
+            return true;
+        if (contents == UnknownContents)
+            return false;
+        contents = enclosingContents(contents);
+    }
+}
+
+static uint8_t commonContents(uint8_t a, uint8_t b)
+{
+    while (!holds(b, a))
+        a = enclosingContents(a);
+    return a;
+}
+
+// Follows every path through cached code, keeping track of what each register
+// holds and how many scopes are pushed, so that code the generator did not
+// make cannot use the frame in a way that code it did make never would: a
+// register is read only once written, locals and parameters only ever hold
+// values, the state of for-in loops, finally blocks and apply calls is only
+// touched by the opcodes made for it, and scopes are popped only once pushed.
+// This keeps cached code from reading or writing memory it shouldn't; it says
+// nothing about whether the code does what its source does.
+class CachedCodeVerifier {
+public:
+    CachedCodeVerifier(CodeBlock*, Interpreter*, const Vector<bool>& instructionStarts);
+
+    bool verify();
+
+private:
+    struct State {
+        Vector<uint8_t> contents;
+        Vector<bool> modified; // Since entering the innermost finally block.
+        int scopeDepth;
+    };
+
+    struct Block {
+        Block(int location)
+            : location(location)
+            , reached(false)
+            , queued(false)
+        {
+        }
+
+        int location;
+        bool reached;
+        bool queued;
+        State state;
+    };
+
+    // Finally blocks are entered with op_jsr, and left with an op_sret that
+    // returns to whichever op_jsr entered them. The state is the one each
+    // op_jsr stored its return address in, or each op_sret returns with.
+    struct Subroutine {
+        Subroutine(int location, int returnAddress)
+            : location(location)
+            , returnAddress(returnAddress)
+            , reached(false)
+        {
+        }
+
+        int location;
+        int returnAddress;
+        bool reached;
+        State state;
+    };
+
+    OpcodeID opcodeAt(int location) const { return m_interpreter->getOpcodeID(m_instructions[location].u.opcode); }
+    int slotFor(int index) const { return index >= 0 ? m_numParameters + index : index + RegisterFile::CallFrameHeaderSize + m_numParameters; }
+    uint8_t contentsOf(const State&, int index) const;
+    void set(State& state, int index, uint8_t contents) const
+    {
+        state.contents[slotFor(index)] = contents;
+        state.modified[slotFor(index)] = true;
+    }
+    bool write(State&, int index, uint8_t contents) const;
+    void clobber(State&, int firstRegister) const;
+    static bool meet(State& into, const State&, bool& changed);
+    static State returnState(const State& jumpState, const State& subroutineState);
+    static Subroutine& subroutineAt(Vector<Subroutine>&, int location);
+
+    void addBlock(int location);
+    bool jumpTo(int location, const State&, bool viaException = false);
+    bool jumpToHandlers(int location, State&, int scopeDepth);
+    bool jumpToSwitchTargets(OpcodeID, int location, int tableIndex, const State&);
+    bool execute(int location, State&);
+    static bool endsBlock(OpcodeID);
+    static bool canThrow(OpcodeID);
+
+    CodeBlock* m_codeBlock;
+    Interpreter* m_interpreter;
+    const Vector<Instruction>& m_instructions;
+    const Vector<bool>& m_instructionStarts;
+    int m_numParameters;
+    int m_numSlots;
+    Vector<int> m_blockIndices;
+    Vector<Block> m_blocks;
+    Vector<int> m_worklist;
+    Vector<Subroutine> m_jumps; // The op_jsr instructions.
+    Vector<Subroutine> m_returns; // The op_sret instructions.
+};
+
+CachedCodeVerifier::CachedCodeVerifier(CodeBlock* codeBlock, Interpreter* interpreter, const Vector<bool>& instructionStarts)
+    : m_codeBlock(codeBlock)
+    , m_interpreter(interpreter)
+    , m_instructions(codeBlock->instructions())
+    , m_instructionStarts(instructionStarts)
+    , m_numParameters(codeBlock->m_numParameters)
+    , m_numSlots(codeBlock->m_numParameters + codeBlock->m_numCalleeRegisters)
+{
+}
+
+uint8_t CachedCodeVerifier::contentsOf(const State& state, int index) const
+{
+    if (index >= FirstConstantRegisterIndex)
+        return m_codeBlock->getConstant(index) ? AnyValue : ValueOrEmpty;
+    return state.contents[slotFor(index)];
+}
+
+bool CachedCodeVerifier::write(State& state, int index, uint8_t contents) const
+{
+    // Locals and parameters may be read through an activation, an arguments
+    // object or the debugger, so they only ever hold values.
+    if (index < m_codeBlock->m_numVars && !holds(contents, AnyValue))
+        return false;
+    // Only op_convert_this may leave a value in "this".
+    if (index == m_codeBlock->thisRegister())
+        return false;
+    set(state, index, contents);
+    return true;
+}
+
+void CachedCodeVerifier::clobber(State& state, int firstRegister) const
+{
+    for (int i = slotFor(firstRegister); i < m_numSlots; ++i) {
+        state.contents[i] = UnknownContents;
+        state.modified[i] = true;
+    }
+}
+
+bool CachedCodeVerifier::meet(State& into, const State& state, bool& changed)
+{
+    if (into.scopeDepth != state.scopeDepth)
+        return false;
+    for (size_t i = 0; i < into.contents.size(); ++i) {
+        uint8_t contents = commonContents(into.contents[i], state.contents[i]);
+        if (contents != into.contents[i]) {
+            into.contents[i] = contents;
+            changed = true;
+        }
+        if (state.modified[i] && !into.modified[i]) {
+            into.modified[i] = true;
+            changed = true;
+        }
+    }
+    return true;
+}
+
+// Returning from a finally block, a register keeps what it held at the op_jsr
+// unless something on the way to the op_sret may have changed it.
+CachedCodeVerifier::State CachedCodeVerifier::returnState(const State& jumpState, const State& subroutineState)
+{
+    State state = jumpState;
+    for (size_t i = 0; i < state.contents.size(); ++i) {
+        if (subroutineState.modified[i]) {
+            state.contents[i] = subroutineState.contents[i];
+            state.modified[i] = true;
+        }
+    }
+    return state;
+}
+
+CachedCodeVerifier::Subroutine& CachedCodeVerifier::subroutineAt(Vector<Subroutine>& subroutines, int location)
+{
+    size_t i = 0;
+    while (subroutines[i].location != location)
+        ++i;
+    return subroutines[i];
+}
+
+void CachedCodeVerifier::addBlock(int location)
+{
+    if (m_blockIndices[location] != -1)
+        return;
+    m_blockIndices[location] = m_blocks.size();
+    m_blocks.append(Block(location));
+}
+
+bool CachedCodeVerifier::jumpTo(int location, const State& state, bool viaException)
+{
+    // Nothing jumps back to op_enter, or between op_method_check and the
+    // op_get_by_id it goes with, and only exceptions lead to op_catch.
+    if (location <= 0 || static_cast<size_t>(location) >= m_instructions.size() || m_blockIndices[location] == -1
+        || (m_instructionStarts[location - 1] && opcodeAt(location - 1) == op_method_check)
+        || (opcodeAt(location) == op_catch) != viaException)
+        return false;
+
+    int blockIndex = m_blockIndices[location];
+    Block& block = m_blocks[blockIndex];
+    if (!block.reached) {
+        block.state = state;
+        block.reached = true;
+    } else {
+        bool changed = false;
+        if (!meet(block.state, state, changed))
+            return false;
+        if (!changed)
+            return true;
+    }
+    if (!block.queued) {
+        block.queued = true;
+        m_worklist.append(blockIndex);
+    }
+    return true;
+}
+
+// An exception may be thrown before or after an instruction has written its
+// results, so both states lead to each handler covering the instruction. No
+// instruction throws once it has changed the scope chain, though, so either
+// way the exception is thrown at the scope depth the instruction started at.
+bool CachedCodeVerifier::jumpToHandlers(int location, State& state, int scopeDepth)
+{
+    for (size_t i = 0; i < m_codeBlock->numberOfExceptionHandlers(); ++i) {
+        const HandlerInfo& handler = m_codeBlock->exceptionHandler(i);
+        if (static_cast<unsigned>(location) < handler.start || static_cast<unsigned>(location) >= handler.end)
+            continue;
+        // Unwinding pops the scopes pushed since the handler's scope depth.
+        if (static_cast<unsigned>(scopeDepth) < handler.scopeDepth)
+            return false;
+        int depthAfter = state.scopeDepth;
+        state.scopeDepth = handler.scopeDepth;
+        bool jumped = jumpTo(handler.target, state, true);
+        state.scopeDepth = depthAfter;
+        if (!jumped)
+            return false;
+    }
+    return true;
+}
+
+bool CachedCodeVerifier::jumpToSwitchTargets(OpcodeID opcodeID, int location, int tableIndex, const State& state)
+{
+    if (opcodeID == op_switch_string) {
+        const StringJumpTable::StringOffsetTable& offsetTable = m_codeBlock->stringSwitchJumpTable(tableIndex).offsetTable;
+        StringJumpTable::StringOffsetTable::const_iterator end = offsetTable.end();
+        for (StringJumpTable::StringOffsetTable::const_iterator it = offsetTable.begin(); it != end; ++it) {
+            if (!jumpTo(location + it->second.branchOffset, state))
+                return false;
+        }
+        return true;
+    }
+
+    const SimpleJumpTable& jumpTable = opcodeID == op_switch_imm ? m_codeBlock->immediateSwitchJumpTable(tableIndex) : m_codeBlock->characterSwitchJumpTable(tableIndex);
+    for (size_t i = 0; i < jumpTable.branchOffsets.size(); ++i) {
+        int offset = jumpTable.branchOffsets[i];
+        if (offset && !jumpTo(location + offset, state))
+            return false;
+    }
+    return true;
+}
+
+bool CachedCodeVerifier::endsBlock(OpcodeID opcodeID)
+{
+    switch (opcodeID) {
+    case op_jmp:
+    case op_loop:
+    case op_jmp_scopes:
+    case op_jsr:
+    case op_sret:
+    case op_switch_imm:
+    case op_switch_char:
+    case op_switch_string:
+    case op_ret:
+    case op_end:
+    case op_throw:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Leaving a scope or a finally block, the generator may step outside the
+// scopes a handler expects before leaving the handler's range, with opcodes
+// that cannot throw.
+bool CachedCodeVerifier::canThrow(OpcodeID opcodeID)
+{
+    switch (opcodeID) {
+    case op_enter:
+    case op_enter_with_activation:
+    case op_mov:
+    case op_jmp:
+    case op_jmp_scopes:
+    case op_jsr:
+    case op_sret:
+    case op_pop_scope:
+    case op_catch:
+    case op_tear_off_activation:
+    case op_tear_off_arguments:
+    case op_ret:
+    case op_end:
+        return false;
+    default:
+        return true;
+    }
+}
+
+bool CachedCodeVerifier::verify()
+{
+    size_t size = m_instructions.size();
+    if (!size || opcodeAt(0) != (m_codeBlock->needsFullScopeChain() ? op_enter_with_activation : op_enter))
+        return false;
+
+    m_blockIndices.fill(-1, size);
+    addBlock(0);
+    for (size_t i = 0; i < size; ) {
+        OpcodeID opcodeID = opcodeAt(i);
+        const char* kinds = operandKinds(opcodeID);
+        const Instruction* operands = &m_instructions[i];
+        bool branches = endsBlock(opcodeID);
+        for (int j = 1; kinds[j - 1]; ++j) {
+            int operand = operands[j].u.operand;
+            switch (kinds[j - 1]) {
+            case 'j':
+                addBlock(i + operand);
+                branches = true;
+                break;
+            case 'I':
+            case 'C': {
+                const SimpleJumpTable& jumpTable = kinds[j - 1] == 'I' ? m_codeBlock->immediateSwitchJumpTable(operand) : m_codeBlock->characterSwitchJumpTable(operand);
+                for (size_t k = 0; k < jumpTable.branchOffsets.size(); ++k) {
+                    if (jumpTable.branchOffsets[k])
+                        addBlock(i + jumpTable.branchOffsets[k]);
+                }
+                break;
+            }
+            case 'S': {
+                const StringJumpTable::StringOffsetTable& offsetTable = m_codeBlock->stringSwitchJumpTable(operand).offsetTable;
+                StringJumpTable::StringOffsetTable::const_iterator end = offsetTable.end();
+                for (StringJumpTable::StringOffsetTable::const_iterator it = offsetTable.begin(); it != end; ++it)
+                    addBlock(i + it->second.branchOffset);
+                break;
+            }
+            }
+        }
+        if (opcodeID == op_jsr)
+            m_jumps.append(Subroutine(i, operands[1].u.operand));
+        else if (opcodeID == op_sret)
+            m_returns.append(Subroutine(i, operands[1].u.operand));
+
+        i += opcodeLengths[opcodeID];
+        if (branches && i < size)
+            addBlock(i);
+    }
+    for (size_t i = 0; i < m_codeBlock->numberOfExceptionHandlers(); ++i)
+        addBlock(m_codeBlock->exceptionHandler(i).target);
+
+    Block& entry = m_blocks[0];
+    entry.state.contents.fill(UnknownContents, m_numSlots);
+    entry.state.modified.fill(false, m_numSlots);
+    for (int i = 0; i < m_numParameters; ++i)
+        entry.state.contents[i] = AnyValue;
+    entry.state.contents[slotFor(m_codeBlock->thisRegister())] = UnconvertedThis;
+    entry.state.scopeDepth = 0;
+    entry.reached = true;
+    entry.queued = true;
+    m_worklist.append(0);
+
+    while (!m_worklist.isEmpty()) {
+        int blockIndex = m_worklist.last();
+        m_worklist.removeLast();
+        m_blocks[blockIndex].queued = false;
+        State state = m_blocks[blockIndex].state;
+        for (int location = m_blocks[blockIndex].location; ; ) {
+            OpcodeID opcodeID = opcodeAt(location);
+            int scopeDepth = state.scopeDepth;
+            bool throws = canThrow(opcodeID);
+            if ((throws && !jumpToHandlers(location, state, scopeDepth)) || !execute(location, state) || (throws && !jumpToHandlers(location, state, scopeDepth)))
+                return false;
+            if (endsBlock(opcodeID))
+                break;
+            location += opcodeLengths[opcodeID];
+            if (static_cast<size_t>(location) >= size)
+                return false; // Falls off the end.
+            if (m_blockIndices[location] != -1) {
+                if (!jumpTo(location, state))
+                    return false;
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+// Checks the instruction at location against the state before it, and leaves
+// the state after it in place, having passed on the state at any jump target.
+bool CachedCodeVerifier::execute(int location, State& state)
+{
+    OpcodeID opcodeID = opcodeAt(location);
+    const char* kinds = operandKinds(opcodeID);
+    const Instruction* operands = &m_instructions[location];
+    int numVars = m_codeBlock->m_numVars;
+
+    for (int j = 1; kinds[j - 1]; ++j) {
+        int operand = operands[j].u.operand;
+        switch (kinds[j - 1]) {
+        case 'r':
+        case 'm':
+            if (!holds(contentsOf(state, operand), AnyValue))
+                return false;
+            break;
+        case 'u':
+            if (!holds(contentsOf(state, operand), ValueOrEmpty))
+                return false;
+            break;
+        case 'a':
+            for (int k = 0; k < operands[j + 1].u.operand; ++k) {
+                if (!holds(contentsOf(state, operand + k), AnyValue))
+                    return false;
+            }
+            break;
+        }
+    }
+
+    switch (opcodeID) {
+    case op_enter:
+    case op_enter_with_activation:
+        if (location)
+            return false;
+        for (int i = 0; i < numVars; ++i)
+            set(state, i, AnyValue);
+        if (opcodeID == op_enter_with_activation) {
+            if (operands[1].u.operand < 0 || operands[1].u.operand >= numVars)
+                return false;
+            set(state, operands[1].u.operand, ActivationValue);
+        }
+        return true;
+    case op_convert_this: {
+        int thisRegister = operands[1].u.operand;
+        if (thisRegister != m_codeBlock->thisRegister())
+            return false;
+        uint8_t contents = contentsOf(state, thisRegister);
+        if (contents != UnconvertedThis && !holds(contents, ObjectValue))
+            return false;
+        set(state, thisRegister, ObjectValue);
+        return true;
+    }
+    case op_init_arguments:
+    case op_create_arguments: {
+        if (!m_codeBlock->usesArguments() || numVars <= RegisterFile::ArgumentsRegister)
+            return false;
+        uint8_t arguments = contentsOf(state, RegisterFile::ArgumentsRegister);
+        if (!holds(arguments, ValueOrEmpty))
+            return false;
+        if (opcodeID == op_init_arguments)
+            set(state, RegisterFile::ArgumentsRegister, ValueOrEmpty);
+        else if (!holds(arguments, AnyValue))
+            set(state, RegisterFile::ArgumentsRegister, AnyValue);
+        return true;
+    }
+    case op_get_argument_by_val: {
+        if (!m_codeBlock->usesArguments() || operands[2].u.operand != RegisterFile::ArgumentsRegister)
+            return false;
+        if (!holds(contentsOf(state, RegisterFile::ArgumentsRegister), AnyValue))
+            set(state, RegisterFile::ArgumentsRegister, AnyValue);
+        break;
+    }
+    case op_tear_off_arguments:
+        return m_codeBlock->usesArguments();
+    case op_tear_off_activation:
+        return m_codeBlock->needsFullScopeChain() && holds(contentsOf(state, operands[1].u.operand), ActivationValue);
+    case op_method_check:
+        return static_cast<size_t>(location + 1) < m_instructions.size() && opcodeAt(location + 1) == op_get_by_id;
+    case op_mov:
+        return write(state, operands[1].u.operand, contentsOf(state, operands[2].u.operand));
+    case op_load_varargs: {
+        int argumentCount = operands[1].u.operand;
+        if (argumentCount < numVars || operands[2].u.operand != argumentCount + 2)
+            return false;
+        set(state, argumentCount, VarargsCount);
+        for (int i = argumentCount + 2; i < m_codeBlock->m_numCalleeRegisters; ++i)
+            set(state, i, VarargsArgument);
+        return true;
+    }
+    case op_call_varargs: {
+        int argumentCount = operands[3].u.operand;
+        int thisRegister = operands[4].u.operand - RegisterFile::CallFrameHeaderSize;
+        if (argumentCount < numVars || thisRegister != argumentCount + 1
+            || contentsOf(state, argumentCount) != VarargsCount || !holds(contentsOf(state, thisRegister), AnyValue))
+            return false;
+        for (int i = thisRegister + 1; i < m_codeBlock->m_numCalleeRegisters; ++i) {
+            if (contentsOf(state, i) != VarargsArgument)
+                return false;
+        }
+        clobber(state, argumentCount);
+        break;
+    }
+    case op_call:
+    case op_call_eval:
+    case op_construct: {
+        int callFrame = operands[4].u.operand - RegisterFile::CallFrameHeaderSize;
+        int thisRegister = callFrame - operands[3].u.operand;
+        if (thisRegister < numVars || (opcodeID == op_construct && operands[6].u.operand != thisRegister))
+            return false;
+        // op_construct makes "this" itself.
+        for (int i = opcodeID == op_construct ? thisRegister + 1 : thisRegister; i < callFrame; ++i) {
+            if (!holds(contentsOf(state, i), AnyValue))
+                return false;
+        }
+        clobber(state, callFrame);
+        if (opcodeID == op_construct)
+            set(state, thisRegister, ConstructedThis);
+        break;
+    }
+    case op_construct_verify: {
+        // The "this" register is only read if the constructor returned something
+        // other than an object, which a host constructor cannot; so the result
+        // checked must be the one op_construct has just stored.
+        int constructLocation = location - OPCODE_LENGTH(op_construct);
+        if (m_blockIndices[location] != -1 || constructLocation < 0 || !m_instructionStarts[constructLocation] || opcodeAt(constructLocation) != op_construct
+            || m_instructions[constructLocation + 1].u.operand != operands[1].u.operand || m_instructions[constructLocation + 6].u.operand != operands[2].u.operand)
+            return false;
+        if (contentsOf(state, operands[2].u.operand) != ConstructedThis && !holds(contentsOf(state, operands[2].u.operand), AnyValue))
+            return false;
+        break;
+    }
+    case op_get_pnames: {
+        int base = operands[2].u.operand;
+        if (base < numVars || operands[3].u.operand != base + 1 || operands[4].u.operand != base + 2 || operands[1].u.operand != base + 3)
+            return false;
+        if (!jumpTo(location + operands[5].u.operand, state))
+            return false;
+        set(state, base, ObjectValue);
+        set(state, base + 1, FirstPropertyIndex);
+        set(state, base + 2, PropertyCount);
+        set(state, base + 3, PropertyNameIterator);
+        return true;
+    }
+    case op_next_pname: {
+        int base = operands[2].u.operand;
+        if (operands[3].u.operand != base + 1 || operands[4].u.operand != base + 2 || operands[5].u.operand != base + 3
+            || !holds(contentsOf(state, base), ObjectValue) || !holds(contentsOf(state, base + 1), AnyPropertyIndex)
+            || contentsOf(state, base + 2) != PropertyCount || contentsOf(state, base + 3) != PropertyNameIterator)
+            return false;
+        State next = state;
+        set(next, base + 1, NextPropertyIndex);
+        return write(next, operands[1].u.operand, AnyValue) && jumpTo(location + operands[6].u.operand, next);
+    }
+    case op_get_by_pname: {
+        int iterator = operands[5].u.operand;
+        if (operands[6].u.operand != iterator - 2 || contentsOf(state, iterator) != PropertyNameIterator
+            || contentsOf(state, iterator - 2) != NextPropertyIndex)
+            return false;
+        break;
+    }
+    case op_push_scope:
+    case op_push_new_scope:
+        if (!m_codeBlock->needsFullScopeChain() || state.scopeDepth >= maxVerifiedScopeDepth
+            || (opcodeID == op_push_scope && !holds(contentsOf(state, operands[1].u.operand), AnyValue)))
+            return false;
+        ++state.scopeDepth;
+        return write(state, operands[1].u.operand, ObjectValue);
+    case op_pop_scope:
+        if (!state.scopeDepth)
+            return false;
+        --state.scopeDepth;
+        return true;
+    case op_jmp_scopes:
+        if (operands[1].u.operand > state.scopeDepth)
+            return false;
+        state.scopeDepth -= operands[1].u.operand;
+        return jumpTo(location + operands[2].u.operand, state);
+    case op_get_scoped_var:
+    case op_put_scoped_var:
+        // The depth counts the scopes the code block started with.
+        if (state.scopeDepth)
+            return false;
+        break;
+    case op_jsr: {
+        int returnAddress = operands[1].u.operand;
+        if (returnAddress < numVars)
+            return false;
+        set(state, returnAddress, FirstReturnAddress + state.scopeDepth);
+        Subroutine& jump = subroutineAt(m_jumps, location);
+        bool changed = false;
+        if (!jump.reached) {
+            jump.state = state;
+            jump.reached = true;
+        } else if (!meet(jump.state, state, changed))
+            return false;
+
+        State entry = state;
+        entry.modified.fill(false);
+        if (!jumpTo(location + operands[2].u.operand, entry))
+            return false;
+        for (size_t i = 0; i < m_returns.size(); ++i) {
+            const Subroutine& subroutineReturn = m_returns[i];
+            if (subroutineReturn.reached && subroutineReturn.returnAddress == returnAddress && subroutineReturn.state.scopeDepth == state.scopeDepth
+                && !jumpTo(location + OPCODE_LENGTH(op_jsr), returnState(jump.state, subroutineReturn.state)))
+                return false;
+        }
+        return true;
+    }
+    case op_sret: {
+        int returnAddress = operands[1].u.operand;
+        if (contentsOf(state, returnAddress) != FirstReturnAddress + state.scopeDepth)
+            return false;
+        Subroutine& subroutineReturn = subroutineAt(m_returns, location);
+        if (!subroutineReturn.reached) {
+            subroutineReturn.state = state;
+            subroutineReturn.reached = true;
+        } else {
+            bool changed = false;
+            if (!meet(subroutineReturn.state, state, changed))
+                return false;
+            if (!changed)
+                return true;
+        }
+        for (size_t i = 0; i < m_jumps.size(); ++i) {
+            const Subroutine& jump = m_jumps[i];
+            if (jump.reached && jump.returnAddress == returnAddress && jump.state.scopeDepth == state.scopeDepth
+                && !jumpTo(jump.location + OPCODE_LENGTH(op_jsr), returnState(jump.state, subroutineReturn.state)))
+                return false;
+        }
+        return true;
+    }
+    default:
+        break;
+    }
+
+    for (int j = 1; kinds[j - 1]; ++j) {
+        int operand = operands[j].u.operand;
+        switch (kinds[j - 1]) {
+        case 'w':
+        case 'm':
+            if (!write(state, operand, AnyValue))
+                return false;
+            break;
+        }
+    }
+
+    for (int j = 1; kinds[j - 1]; ++j) {
+        int operand = operands[j].u.operand;
+        switch (kinds[j - 1]) {
+        case 'j':
+            if (!jumpTo(location + operand, state))
+                return false;
+            break;
+        case 'I':
+        case 'C':
+        case 'S':
+            if (!jumpToSwitchTargets(opcodeID, location, operand, state))
+                return false;
+            break;
+        }
+    }
+    return true;
+}
+
+// The checksum catches a damaged file, but not one written by something other
+// than this class. Before cached code runs, every operand that indexes into the
+// frame, the code block's tables or the instruction stream is checked, as are
+// the tables that the JIT or the interpreter walk alongside the instructions,
+// and then CachedCodeVerifier follows the code through.
+bool BytecodeCache::validateCodeBlock(CodeBlock* codeBlock, Interpreter* interpreter, const ScopeChain& scopeChain, const Vector<ScopedPropertyLookup>& lookups)
+{
+    // Every temporary is written by an instruction of its own, and each call's
+    // frame header is outnumbered by the call and the loads feeding it, so a
+    // frame larger than this was not made by the generator.
+    const Vector<Instruction>& instructions = codeBlock->m_instructions;
+    if (codeBlock->m_numVars < 0 || codeBlock->m_numVars > codeBlock->m_numCalleeRegisters
+        || static_cast<size_t>(codeBlock->m_numCalleeRegisters) > codeBlock->m_numVars + instructions.size() + RegisterFile::CallFrameHeaderSize
+        || codeBlock->m_thisRegister != -RegisterFile::CallFrameHeaderSize - codeBlock->m_numParameters)
+        return false;
+
+    Vector<bool> instructionStarts(instructions.size());
+    instructionStarts.fill(false);
+    for (size_t i = 0; i < instructions.size(); i += opcodeLengths[interpreter->getOpcodeID(instructions[i].u.opcode)])
+        instructionStarts[i] = true;
+
+    int scopeChainDepth = 0;
+    ScopeChainIterator end = scopeChain.end();
+    for (ScopeChainIterator iter = scopeChain.begin(); iter != end; ++iter)
+        ++scopeChainDepth;
+
+    CodeBlock::RareData* rareData = codeBlock->m_rareData.get();
+    int regExpCount = rareData ? rareData->m_regexps.size() : 0;
+    int immediateSwitchCount = codeBlock->numberOfImmediateSwitchJumpTables();
+    int characterSwitchCount = codeBlock->numberOfCharacterSwitchJumpTables();
+    int stringSwitchCount = codeBlock->numberOfStringSwitchJumpTables();
+    int constantCount = codeBlock->m_constantRegisters.size();
+    size_t propertyAccessCount = 0;
+    size_t callCount = 0;
+    size_t globalResolveCount = 0;
+
+    for (size_t i = 0; i < instructions.size(); ) {
+        OpcodeID opcodeID = interpreter->getOpcodeID(instructions[i].u.opcode);
+        const char* kinds = operandKinds(opcodeID);
+        if (!kinds)
+            return false;
+        ASSERT(static_cast<int>(strlen(kinds)) == opcodeLengths[opcodeID] - 1);
+        int location = i;
+        const Instruction* operands = &instructions[i];
+        for (int j = 1; j < opcodeLengths[opcodeID]; ++j) {
+            int operand = operands[j].u.operand;
+            bool valid = true;
+            switch (kinds[j - 1]) {
+            case 'r':
+            case 'u':
+                if (operand >= FirstConstantRegisterIndex)
+                    valid = operand - FirstConstantRegisterIndex < constantCount;
+                else
+                    valid = isVariableRegister(codeBlock, operand);
+                break;
+            case 'w':
+            case 'm':
+            case 't':
+                valid = isVariableRegister(codeBlock, operand);
+                break;
+            case 'a':
+                valid = isLocalRegisterRun(codeBlock, operand, operands[j + 1].u.operand);
+                break;
+            case 'o':
+                valid = operands[j - 1].u.operand > 0 && operand <= codeBlock->m_numCalleeRegisters
+                    && isLocalRegisterRun(codeBlock, operand - RegisterFile::CallFrameHeaderSize - operands[j - 1].u.operand, operands[j - 1].u.operand);
+                break;
+            case 'O':
+                valid = operand <= codeBlock->m_numCalleeRegisters && isLocalRegisterRun(codeBlock, operand - RegisterFile::CallFrameHeaderSize, 1);
+                break;
+            case 'i':
+                valid = operand >= 0 && static_cast<size_t>(operand) < codeBlock->numberOfIdentifiers();
+                break;
+            case 'x':
+                valid = operand >= 0 && operand < regExpCount;
+                break;
+            case 'f':
+                valid = operand >= 0 && static_cast<size_t>(operand) < codeBlock->m_functionDecls.size();
+                break;
+            case 'e':
+                valid = operand >= 0 && static_cast<size_t>(operand) < codeBlock->m_functionExprs.size();
+                break;
+            case 'I':
+                valid = operand >= 0 && operand < immediateSwitchCount && isValidSwitchTable(codeBlock->immediateSwitchJumpTable(operand), instructionStarts, location);
+                break;
+            case 'C':
+                valid = operand >= 0 && operand < characterSwitchCount && isValidSwitchTable(codeBlock->characterSwitchJumpTable(operand), instructionStarts, location);
+                break;
+            case 'S':
+                valid = operand >= 0 && operand < stringSwitchCount && isValidSwitchTable(codeBlock->stringSwitchJumpTable(operand), instructionStarts, location);
+                break;
+            case 'j':
+                valid = isInstructionStart(instructionStarts, location + operand);
+                break;
+            case 'v':
+                valid = isScopedVariable(lookups, operand, operands[j + 1].u.operand, false);
+                break;
+            case 'd':
+                valid = operand >= 0 && operand < scopeChainDepth;
+                break;
+            case 'g':
+                valid = isScopedVariable(lookups, operand, 0, true);
+                break;
+            case 'p':
+                valid = operand >= 0;
+                break;
+            case 'z':
+                valid = !operands[j].u.jsCell;
+                break;
+            case 'G':
+                valid = operands[j].u.jsCell == scopeChain.globalObject();
+                break;
+            case 'c':
+            case 'n':
+                break;
+            default:
+                ASSERT_NOT_REACHED();
+                valid = false;
+            }
+            if (!valid)
+                return false;
+        }
+
+        switch (opcodeID) {
+        case op_get_by_id:
+        case op_put_by_id:
+#if ENABLE(JIT)
+            if (propertyAccessCount >= codeBlock->m_structureStubInfos.size()
+                || codeBlock->m_structureStubInfos[propertyAccessCount].accessType != (opcodeID == op_get_by_id ? access_get_by_id : access_put_by_id))
+                return false;
+#else
+            if (propertyAccessCount >= codeBlock->m_propertyAccessInstructions.size()
+                || codeBlock->m_propertyAccessInstructions[propertyAccessCount] != static_cast<unsigned>(location))
+                return false;
+#endif
+            ++propertyAccessCount;
+            break;
+        case op_call:
+        case op_call_eval:
+        case op_construct:
+            ++callCount;
+            break;
+        case op_resolve_global:
+#if ENABLE(JIT)
+            if (globalResolveCount >= codeBlock->m_globalResolveInfos.size()
+                || codeBlock->m_globalResolveInfos[globalResolveCount].bytecodeOffset != static_cast<unsigned>(location))
+#else
+            if (globalResolveCount >= codeBlock->m_globalResolveInstructions.size()
+                || codeBlock->m_globalResolveInstructions[globalResolveCount] != static_cast<unsigned>(location))
+#endif
+                return false;
+            ++globalResolveCount;
+            break;
+        default:
+            break;
+        }
+
+        i += opcodeLengths[opcodeID];
+    }
+
+#if ENABLE(JIT)
+    if (propertyAccessCount != codeBlock->m_structureStubInfos.size()
+        || callCount != codeBlock->m_callLinkInfos.size()
+        || globalResolveCount != codeBlock->m_globalResolveInfos.size())
+        return false;
+    // The profiler looks these up by the offset of the call, and reads the
+    // function from the register named, which the call must not overwrite.
+    for (size_t i = 0; rareData && i < rareData->m_functionRegisterInfos.size(); ++i) {
+        const FunctionRegisterInfo& info = rareData->m_functionRegisterInfos[i];
+        if (!isInstructionStart(instructionStarts, info.bytecodeOffset)
+            || (i && info.bytecodeOffset <= rareData->m_functionRegisterInfos[i - 1].bytecodeOffset))
+            return false;
+        const Instruction* operands = &instructions[info.bytecodeOffset];
+        OpcodeID opcodeID = interpreter->getOpcodeID(operands[0].u.opcode);
+        if ((opcodeID != op_call && opcodeID != op_call_eval && opcodeID != op_construct && opcodeID != op_call_varargs)
+            || operands[2].u.operand != info.functionRegisterIndex
+            || info.functionRegisterIndex >= operands[4].u.operand - RegisterFile::CallFrameHeaderSize - (opcodeID == op_call_varargs ? 1 : operands[3].u.operand))
+            return false;
+    }
+#else
+    if (propertyAccessCount != codeBlock->m_propertyAccessInstructions.size()
+        || globalResolveCount != codeBlock->m_globalResolveInstructions.size())
+        return false;
+#endif
+
+    for (size_t i = 0; i < codeBlock->m_jumpTargets.size(); ++i) {
+        if (!isInstructionStart(instructionStarts, codeBlock->m_jumpTargets[i])
+            || (i && codeBlock->m_jumpTargets[i] <= codeBlock->m_jumpTargets[i - 1]))
+            return false;
+    }
+
+    for (size_t i = 0; i < codeBlock->numberOfExceptionHandlers(); ++i) {
+        const HandlerInfo& handler = codeBlock->exceptionHandler(i);
+        if (!isInstructionStart(instructionStarts, handler.start) || handler.end < handler.start || handler.end > instructions.size()
+            || !isInstructionStart(instructionStarts, handler.target))
+            return false;
+    }
+
+    return CachedCodeVerifier(codeBlock, interpreter, instructionStarts).verify();
+}
+
+bool BytecodeCache::decodeCodeBlock(BytecodeReader& reader, FunctionExecutable* executable, const ScopeChain& scopeChain)
+{
+    JSGlobalObject* globalObject = scopeChain.globalObject();
+    JSGlobalData* globalData = globalObject->globalData();
+    Interpreter* interpreter = globalData->interpreter;
+    const SourceCode& source = executable->source();
+    int baseOffset = source.startOffset();
+    int baseLine = source.firstLine();
+
+    UString name;
+    RefPtr<FunctionParameters> parameters;
+    if (!reader.readMatchingCharacters(source.data(), source.length())
+        || !reader.readString(name) || name.isNull() != executable->m_name.isNull() || name != executable->m_name.ustring()
+        || !reader.readParameters(globalData, parameters) || parameters->size() != executable->m_parameters->size())
+        return false;
+    for (size_t i = 0; i < parameters->size(); ++i) {
+        if (parameters->at(i) != executable->m_parameters->at(i))
+            return false;
+    }
+
+    uint32_t features;
+    int32_t firstLine;
+    int32_t lastLine;
+    bool supportsProfiling;
+    uint32_t lookupCount;
+    if (!reader.read(features) || !reader.read(firstLine) || !reader.read(lastLine)
+        || !reader.readBool(supportsProfiling) || supportsProfiling != globalObject->supportsProfiling()
+        || !reader.readCount(lookupCount))
+        return false;
+
+    Vector<ScopedPropertyLookup> lookups(lookupCount);
+    for (uint32_t i = 0; i < lookupCount; ++i) {
+        ScopedPropertyLookup& lookup = lookups[i];
+        int32_t index;
+        uint32_t depth;
+        if (!reader.readIdentifier(globalData, lookup.property) || !reader.readBool(lookup.forWriting) || !reader.readBool(lookup.canOptimize)
+            || !reader.read(index) || !reader.read(depth) || !reader.readBool(lookup.hasGlobalObject))
+            return false;
+        lookup.index = index;
+        lookup.depth = depth;
+        if (lookup.property == globalData->propertyNames->arguments)
+            return false; // The generator never looks "arguments" up in the scope chain.
+
+        int currentIndex = 0;
+        size_t currentDepth = 0;
+        JSObject* currentGlobalObject = 0;
+        bool currentCanOptimize = BytecodeGenerator::findScopedPropertyInScopeChain(scopeChain, lookup.property, currentIndex, currentDepth, lookup.forWriting, currentGlobalObject);
+        if (currentCanOptimize != lookup.canOptimize || currentIndex != lookup.index || currentDepth != lookup.depth || !!currentGlobalObject != lookup.hasGlobalObject)
+            return false;
+    }
+
+    // The entry applies; from here on, failing means the entry is damaged.
+    executable->recordParse(features, baseLine + firstLine, baseLine + lastLine);
+    CodeBlock* codeBlock = new FunctionCodeBlock(executable, FunctionCode, source.provider(), source.startOffset());
+    executable->m_codeBlock = codeBlock;
+    codeBlock->setGlobalData(globalData);
+
+    bool needsFullScopeChain;
+    bool usesEval;
+    bool usesArguments;
+    uint8_t compareFunctionType;
+    if (!reader.read(codeBlock->m_numCalleeRegisters) || !reader.read(codeBlock->m_numVars)
+        || !reader.read(codeBlock->m_numParameters) || !reader.read(codeBlock->m_thisRegister)
+        || !reader.readBool(needsFullScopeChain) || !reader.readBool(usesEval)
+        || !reader.readBool(usesArguments) || !reader.read(compareFunctionType) || compareFunctionType > RelationalCompareFunction
+        || codeBlock->m_numParameters != static_cast<int>(parameters->size()) + 1)
+        return false;
+    // The flags follow from the features, as the generator would have set them.
+    if (needsFullScopeChain != executable->needsActivation() || usesEval != executable->usesEval() || usesArguments != executable->usesArguments()
+        || (executable->m_forceUsesArguments && !usesArguments))
+        return false;
+    codeBlock->setNeedsFullScopeChain(needsFullScopeChain);
+    codeBlock->setUsesEval(usesEval);
+    codeBlock->setUsesArguments(usesArguments);
+    codeBlock->setCompareFunctionType(static_cast<CompareFunctionType>(compareFunctionType));
+
+    uint32_t instructionCount;
+    if (!reader.readCount(instructionCount, sizeof(int32_t)))
+        return false;
+    Vector<Instruction>& instructions = codeBlock->m_instructions;
+    instructions.reserveCapacity(instructionCount);
+    while (instructions.size() < instructionCount) {
+        uint32_t opcodeID;
+        if (!reader.read(opcodeID) || opcodeID >= static_cast<uint32_t>(numOpcodeIDs)
+            || instructions.size() + opcodeLengths[opcodeID] > instructionCount)
+            return false;
+        instructions.append(Instruction(interpreter->getOpcode(static_cast<OpcodeID>(opcodeID))));
+        int cellOperand = cellOperandIndex(static_cast<OpcodeID>(opcodeID));
+        for (int j = 1; j < opcodeLengths[opcodeID]; ++j) {
+            int32_t operand;
+            if (!reader.read(operand))
+                return false;
+            if (j == cellOperand) {
+                JSCell* cell = decodeCellOperand(globalObject, operand);
+                if (!cell)
+                    return false;
+                instructions.append(Instruction(cell));
+            } else
+                instructions.append(Instruction(operand));
+        }
+    }
+
+    uint32_t count;
+    if (!reader.readCount(count, sizeof(uint32_t)))
+        return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t jumpTarget;
+        if (!reader.read(jumpTarget))
+            return false;
+        codeBlock->addJumpTarget(jumpTarget);
+    }
+
+    if (!reader.readCount(count, sizeof(uint32_t)))
+        return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        Identifier identifier;
+        if (!reader.readIdentifier(globalData, identifier))
+            return false;
+        codeBlock->addIdentifier(identifier);
+    }
+
+    // Each constant goes into the code block as soon as it is made, so that a
+    // collection triggered by the next one sees it.
+    if (!reader.readCount(count))
+        return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint8_t kind;
+        if (!reader.read(kind))
+            return false;
+        JSValue value;
+        switch (kind) {
+        case EmptyConstant:
+            break;
+        case UndefinedConstant:
+            value = jsUndefined();
+            break;
+        case NullConstant:
+            value = jsNull();
+            break;
+        case TrueConstant:
+            value = jsBoolean(true);
+            break;
+        case FalseConstant:
+            value = jsBoolean(false);
+            break;
+        case NumberConstant: {
+            double number;
+            if (!reader.read(number))
+                return false;
+            // A NaN with arbitrary payload bits could encode as a cell pointer.
+            if (isnan(number))
+                number = NaN;
+            value = jsNumber(globalData, number);
+            break;
+        }
+        case StringConstant: {
+            UString string;
+            if (!reader.readString(string))
+                return false;
+            value = jsOwnedString(globalData, string);
+            break;
+        }
+        case GlobalObjectConstant:
+            value = globalObject;
+            break;
+        default:
+            return false;
+        }
+        codeBlock->addConstantRegister(value);
+    }
+
+    for (int list = 0; list < 2; ++list) {
+        if (!reader.readCount(count))
+            return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            Identifier functionName;
+            RefPtr<FunctionParameters> functionParameters;
+            bool forceUsesArguments;
+            int32_t startOffset;
+            int32_t endOffset;
+            int32_t sourceFirstLine;
+            int32_t functionFirstLine;
+            int32_t functionLastLine;
+            if (!reader.readIdentifier(globalData, functionName) || !reader.readParameters(globalData, functionParameters)
+                || !reader.readBool(forceUsesArguments) || !reader.read(startOffset) || !reader.read(endOffset)
+                || !reader.read(sourceFirstLine) || !reader.read(functionFirstLine) || !reader.read(functionLastLine))
+                return false;
+            if (startOffset < 0 || startOffset > endOffset || endOffset > source.length())
+                return false;
+            SourceCode functionSource(source.provider(), baseOffset + startOffset, baseOffset + endOffset, baseLine + sourceFirstLine);
+            // Compiling a function takes for granted that its source parses,
+            // as it does for any range the parser handed the generator.
+            if (!globalData->parser->parse<FunctionBodyNode>(globalData, 0, 0, functionSource))
+                return false;
+            RefPtr<FunctionExecutable> function = FunctionExecutable::create(globalData, functionName, functionSource, forceUsesArguments, functionParameters.get(), baseLine + functionFirstLine, baseLine + functionLastLine);
+            if (list)
+                codeBlock->addFunctionExpr(function.release());
+            else
+                codeBlock->addFunctionDecl(function.release());
+        }
+    }
+
+    if (!reader.readCount(count, 2 * sizeof(uint32_t)))
+        return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        UString pattern;
+        UString flags;
+        if (!reader.readString(pattern) || !reader.readString(flags))
+            return false;
+        codeBlock->addRegExp(globalData->regExpCache.lookupOrCreate(globalData, pattern, flags).get());
+    }
+
+    if (!reader.readCount(count, 4 * sizeof(uint32_t)))
+        return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t start;
+        uint32_t end;
+        uint32_t target;
+        uint32_t scopeDepth;
+        if (!reader.read(start) || !reader.read(end) || !reader.read(target) || !reader.read(scopeDepth))
+            return false;
+#if ENABLE(JIT)
+        HandlerInfo handler = { start, end, target, scopeDepth, CodeLocationLabel() };
+#else
+        HandlerInfo handler = { start, end, target, scopeDepth };
+#endif
+        codeBlock->addExceptionHandler(handler);
+    }
+
+    for (int list = 0; list < 2; ++list) {
+        if (!reader.readCount(count, 2 * sizeof(uint32_t)))
+            return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            SimpleJumpTable& jumpTable = list ? codeBlock->addCharacterSwitchJumpTable() : codeBlock->addImmediateSwitchJumpTable();
+            uint32_t size;
+            if (!reader.read(jumpTable.min) || !reader.readCount(size, sizeof(int32_t)))
+                return false;
+            jumpTable.branchOffsets.resize(size);
+            for (uint32_t j = 0; j < size; ++j)
+                reader.read(jumpTable.branchOffsets[j]);
+        }
+    }
+
+    if (!reader.readCount(count, sizeof(uint32_t)))
+        return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        StringJumpTable& jumpTable = codeBlock->addStringSwitchJumpTable();
+        uint32_t size;
+        if (!reader.readCount(size, 2 * sizeof(uint32_t)))
+            return false;
+        for (uint32_t j = 0; j < size; ++j) {
+            Identifier clause;
+            OffsetLocation location;
+            if (!reader.readIdentifier(globalData, clause) || !reader.read(location.branchOffset))
+                return false;
+            jumpTable.offsetTable.add(clause.ustring().rep(), location);
+        }
+    }
+
+#if ENABLE(JIT)
+    if (!reader.readCount(count, sizeof(int32_t)))
+        return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        int32_t accessType;
+        if (!reader.read(accessType) || (accessType != access_get_by_id && accessType != access_put_by_id))
+            return false;
+        codeBlock->addStructureStubInfo(StructureStubInfo(static_cast<AccessType>(accessType)));
+    }
+
+    if (!reader.readCount(count, sizeof(uint32_t)))
+        return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t bytecodeOffset;
+        if (!reader.read(bytecodeOffset))
+            return false;
+        codeBlock->addGlobalResolveInfo(bytecodeOffset);
+    }
+
+    if (!reader.read(count) || count > instructionCount)
+        return false;
+    for (uint32_t i = 0; i < count; ++i)
+        codeBlock->addCallLinkInfo();
+
+    if (!reader.readCount(count, 2 * sizeof(uint32_t)))
+        return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t bytecodeOffset;
+        int32_t functionRegisterIndex;
+        if (!reader.read(bytecodeOffset) || !reader.read(functionRegisterIndex))
+            return false;
+        codeBlock->addFunctionRegisterInfo(bytecodeOffset, functionRegisterIndex);
+    }
+#else
+    for (int list = 0; list < 2; ++list) {
+        if (!reader.readCount(count, sizeof(uint32_t)))
+            return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t bytecodeOffset;
+            if (!reader.read(bytecodeOffset))
+                return false;
+            if (list)
+                codeBlock->addGlobalResolveInstruction(bytecodeOffset);
+            else
+                codeBlock->addPropertyAccessInstruction(bytecodeOffset);
+        }
+    }
+#endif
+
+    if (!reader.readCount(count, 3 * sizeof(uint32_t)))
+        return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        Identifier symbol;
+        int32_t index;
+        uint32_t attributes;
+        if (!reader.readIdentifier(globalData, symbol) || !reader.read(index) || !reader.read(attributes)
+            || !isVariableRegister(codeBlock, index) || index >= codeBlock->m_numVars || (attributes & ~(ReadOnly | DontEnum)))
+            return false;
+        codeBlock->m_symbolTable->add(symbol.ustring().rep(), SymbolTableEntry(index, attributes));
+    }
+
+    // Exception info is looked up by binary search, and its ranges index the source.
+    ExceptionInfo* exceptionInfo = codeBlock->m_exceptionInfo.get();
+    if (!reader.readCount(count, 2 * sizeof(uint32_t) + 2))
+        return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t instructionOffset;
+        uint32_t divotPoint;
+        uint8_t startOffset;
+        uint8_t endOffset;
+        if (!reader.read(instructionOffset) || !reader.read(divotPoint) || !reader.read(startOffset) || !reader.read(endOffset)
+            || instructionOffset >= instructionCount || (i && instructionOffset < exceptionInfo->m_expressionInfo.last().instructionOffset)
+            || divotPoint > static_cast<uint32_t>(source.length()) || startOffset > ExpressionRangeInfo::MaxOffset || endOffset > ExpressionRangeInfo::MaxOffset
+            || startOffset > divotPoint || divotPoint + endOffset > static_cast<uint32_t>(source.length()))
+            return false;
+        ExpressionRangeInfo info;
+        info.instructionOffset = instructionOffset;
+        info.divotPoint = divotPoint;
+        info.startOffset = startOffset;
+        info.endOffset = endOffset;
+        codeBlock->addExpressionInfo(info);
+    }
+
+    if (!reader.readCount(count, 2 * sizeof(uint32_t)))
+        return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        LineInfo info;
+        int32_t lineNumber;
+        if (!reader.read(info.instructionOffset) || !reader.read(lineNumber) || info.instructionOffset >= instructionCount
+            || (i && info.instructionOffset < exceptionInfo->m_lineInfo.last().instructionOffset))
+            return false;
+        info.lineNumber = baseLine + lineNumber;
+        codeBlock->addLineInfo(info);
+    }
+
+    if (!reader.readCount(count, sizeof(uint32_t) + 1))
+        return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t bytecodeOffset;
+        bool isOpConstruct;
+        if (!reader.read(bytecodeOffset) || !reader.readBool(isOpConstruct) || bytecodeOffset >= instructionCount
+            || (i && bytecodeOffset < exceptionInfo->m_getByIdExceptionInfo.last().bytecodeOffset))
+            return false;
+        GetByIdExceptionInfo info;
+        info.bytecodeOffset = bytecodeOffset;
+        info.isOpConstruct = isOpConstruct;
+        codeBlock->addGetByIdExceptionInfo(info);
+    }
+
+    if (reader.remaining() || !validateCodeBlock(codeBlock, interpreter, scopeChain, lookups))
+        return false;
+
+#ifndef NDEBUG
+    codeBlock->setInstructionCount(instructions.size());
+#endif
+    codeBlock->shrinkToFit();
+    return true;
+}
+
+} // namespace JSC
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2010 Apple Inc. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BytecodeCache_h
+#define BytecodeCache_h
+
+#include <wtf/HashMap.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+    class BytecodeReader;
+    class BytecodeWriter;
+    class CodeBlock;
+    class FunctionExecutable;
+    class Interpreter;
+    class ScopeChain;
+    struct ScopedPropertyLookup;
+
+    // Keeps the bytecode generated for functions, so that a function whose source
+    // has been compiled before - in this run, or in an earlier one that saved the
+    // cache to a file - can skip the parser and the bytecode generator.
+    //
+    // Entries are keyed by a digest of the function's source text, name and
+    // parameters. The generator's view of the enclosing scopes is not part of the
+    // source, so each entry also records every scope chain lookup made while the
+    // code was generated; the entry is only used if the same lookups against the
+    // current scope chain give the same answers.
+    //
+    // The entries together take at most maxSize() bytes; when a new entry would
+    // not fit, the oldest entries are evicted.
+    class BytecodeCache : public Noncopyable {
+    public:
+        BytecodeCache();
+        ~BytecodeCache();
+
+        // Adds the entries saved in the file at path. A file written by a build
+        // with different opcodes or configuration, or one that is damaged, is
+        // ignored.
+        bool load(const char* path);
+        bool save(const char* path) const;
+
+        // Gives the executable a code block decoded from the cache, if there is
+        // an entry for it that is valid in the given scope chain.
+        bool decode(FunctionExecutable*, const ScopeChain&);
+        // Adds the code block just generated for the executable.
+        void encode(FunctionExecutable*, const ScopeChain&, const Vector<ScopedPropertyLookup>&);
+
+        size_t size() const { return m_entries.size(); }
+        size_t maxSize() const { return m_maxSize; }
+        void setMaxSize(size_t);
+        size_t hits() const { return m_hits; }
+        size_t misses() const { return m_misses; }
+
+        static const size_t defaultMaxSize = 8 * 1024 * 1024;
+
+    private:
+        typedef HashMap<uint64_t, std::pair<unsigned, unsigned> > EntryMap;
+
+        static uint64_t keyFor(FunctionExecutable*);
+        bool decodeCodeBlock(BytecodeReader&, FunctionExecutable*, const ScopeChain&);
+        bool encodeCodeBlock(BytecodeWriter&, FunctionExecutable*, const ScopeChain&, const Vector<ScopedPropertyLookup>&);
+        static bool validateCodeBlock(CodeBlock*, Interpreter*, const ScopeChain&, const Vector<ScopedPropertyLookup>&);
+        void addEntry(uint64_t key, const char* data, unsigned length);
+        void evictOldestEntries(size_t bytesToKeep);
+
+        // Entries are stored back to back in m_data, oldest first; m_entries maps
+        // each key to the offset and length of its entry.
+        Vector<char> m_data;
+        EntryMap m_entries;
+        size_t m_maxSize;
+        size_t m_hits;
+        size_t m_misses;
+    };
+
+} // namespace JSC
+
+#endif // BytecodeCache_h
@@ -270,6 +270,7 @@ namespace JSC {
     };
 
     class CodeBlock : public FastAllocBase {
+        friend class BytecodeCache;
         friend class JIT;
     protected:
         CodeBlock(ScriptExecutable* ownerExecutable, CodeType, PassRefPtr<SourceProvider>, unsigned sourceOffset, SymbolTable* symbolTable);
@@ -356,8 +357,8 @@ namespace JSC {
         bool functionRegisterForBytecodeOffset(unsigned bytecodeOffset, int& functionRegisterIndex);
 #endif
 
-        void setIsNumericCompareFunction(bool isNumericCompareFunction) { m_isNumericCompareFunction = isNumericCompareFunction; }
-        bool isNumericCompareFunction() { return m_isNumericCompareFunction; }
+        void setCompareFunctionType(CompareFunctionType compareFunctionType) { m_compareFunctionType = compareFunctionType; }
+        CompareFunctionType compareFunctionType() { return m_compareFunctionType; }
 
         Vector<Instruction>& instructions() { return m_instructions; }
         void discardBytecode() { m_instructions.clear(); }
@@ -447,7 +448,19 @@ namespace JSC {
         Identifier& identifier(int index) { return m_identifiers[index]; }
 
         size_t numberOfConstantRegisters() const { return m_constantRegisters.size(); }
-        void addConstantRegister(const Register& r) { return m_constantRegisters.append(r); }
+        void addConstantRegister(const Register& r)
+        {
+            // Code blocks are compiled long after the functions that reach them
+            // may have been traced, so a nursery collection would not find a new
+            // constant through them. Keep it alive until the next full collection,
+            // and dirty its card, since marking it here does not trace its children.
+            JSValue value = r.jsValue();
+            if (value && value.isCell()) {
+                Heap::markCell(value.asCell());
+                Heap::writeBarrier(value.asCell());
+            }
+            m_constantRegisters.append(r);
+        }
         Register& constantRegister(int index) { return m_constantRegisters[index - FirstConstantRegisterIndex]; }
         ALWAYS_INLINE bool isConstantRegisterIndex(int index) const { return index >= FirstConstantRegisterIndex; }
         ALWAYS_INLINE JSValue getConstant(int index) const { return m_constantRegisters[index - FirstConstantRegisterIndex].jsValue(); }
@@ -523,7 +536,7 @@ namespace JSC {
         bool m_needsFullScopeChain;
         bool m_usesEval;
         bool m_usesArguments;
-        bool m_isNumericCompareFunction;
+        CompareFunctionType m_compareFunctionType;
 
         CodeType m_codeType;
 
@@ -122,6 +122,58 @@ namespace JSC {
         }
     };
 
+    // Structure used by a polymorphic put_by_id to hold the replace and transition cases it has
+    // cached.  Each stub falls back to the one before it; a case cached in the hot path has no stub.
+    struct PolymorphicPutByIdStructureList : FastAllocBase {
+        struct PolymorphicStubInfo {
+            PolymorphicAccessStructureListStubRoutineType stubRoutine;
+            Structure* oldStructure;
+            Structure* newStructure; // 0 for a replace.
+            StructureChain* chain; // 0 for a replace.
+
+            void set(PolymorphicAccessStructureListStubRoutineType _stubRoutine, Structure* _structure)
+            {
+                stubRoutine = _stubRoutine;
+                oldStructure = _structure;
+                newStructure = 0;
+                chain = 0;
+            }
+
+            void set(PolymorphicAccessStructureListStubRoutineType _stubRoutine, Structure* _oldStructure, Structure* _newStructure, StructureChain* _chain)
+            {
+                stubRoutine = _stubRoutine;
+                oldStructure = _oldStructure;
+                newStructure = _newStructure;
+                chain = _chain;
+            }
+        } list[POLYMORPHIC_LIST_CACHE_SIZE];
+
+        PolymorphicPutByIdStructureList(PolymorphicAccessStructureListStubRoutineType stubRoutine, Structure* firstStructure)
+        {
+            list[0].set(stubRoutine, firstStructure);
+        }
+
+        PolymorphicPutByIdStructureList(PolymorphicAccessStructureListStubRoutineType stubRoutine, Structure* firstOldStructure, Structure* firstNewStructure, StructureChain* firstChain)
+        {
+            list[0].set(stubRoutine, firstOldStructure, firstNewStructure, firstChain);
+        }
+
+        void derefStructures(int count)
+        {
+            for (int i = 0; i < count; ++i) {
+                PolymorphicStubInfo& info = list[i];
+
+                ASSERT(info.oldStructure);
+                info.oldStructure->deref();
+
+                if (info.newStructure) {
+                    info.newStructure->deref();
+                    info.chain->deref();
+                }
+            }
+        }
+    };
+
     struct Instruction {
         Instruction(Opcode opcode)
         {
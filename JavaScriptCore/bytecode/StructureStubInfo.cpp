@@ -63,6 +63,12 @@ void StructureStubInfo::deref()
     case access_put_by_id_replace:
         u.putByIdReplace.baseObjectStructure->deref();
         return;
+    case access_put_by_id_list: {
+        PolymorphicPutByIdStructureList* polymorphicStructures = u.putByIdList.structureList;
+        polymorphicStructures->derefStructures(u.putByIdList.listSize);
+        delete polymorphicStructures;
+        return;
+    }
     case access_get_by_id:
     case access_put_by_id:
     case access_get_by_id_generic:
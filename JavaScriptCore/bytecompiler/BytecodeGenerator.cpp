@@ -153,10 +153,12 @@ void BytecodeGenerator::generate()
     if ((m_codeType == FunctionCode && !m_codeBlock->needsFullScopeChain() && !m_codeBlock->usesArguments()) || m_codeType == EvalCode)
         symbolTable().clear();
         
-    m_codeBlock->setIsNumericCompareFunction(instructions() == m_globalData->numericCompareFunction(m_scopeChain->globalObject()->globalExec()));
+    m_codeBlock->setCompareFunctionType(m_globalData->compareFunctionType(m_scopeChain->globalObject()->globalExec(), m_codeBlock));
 
 #if !ENABLE(OPCODE_SAMPLING)
-    if (!m_regeneratingForExceptionInfo && (m_codeType == FunctionCode || m_codeType == EvalCode))
+    // The bytecode cache saves the exception info along with the code, and
+    // clears it once it has.
+    if (!m_regeneratingForExceptionInfo && !m_recordsScopedPropertyLookups && (m_codeType == FunctionCode || m_codeType == EvalCode))
         m_codeBlock->clearExceptionInfo();
 #endif
 
@@ -222,6 +224,7 @@ BytecodeGenerator::BytecodeGenerator(ProgramNode* programNode, const Debugger* d
     , m_emitNodeDepth(0)
     , m_regeneratingForExceptionInfo(false)
     , m_codeBlockBeingRegeneratedFrom(0)
+    , m_recordsScopedPropertyLookups(false)
 {
     if (m_shouldEmitDebugHooks)
         m_codeBlock->setNeedsFullScopeChain(true);
@@ -306,6 +309,7 @@ BytecodeGenerator::BytecodeGenerator(FunctionBodyNode* functionBody, const Debug
     , m_emitNodeDepth(0)
     , m_regeneratingForExceptionInfo(false)
     , m_codeBlockBeingRegeneratedFrom(0)
+    , m_recordsScopedPropertyLookups(false)
 {
     if (m_shouldEmitDebugHooks)
         m_codeBlock->setNeedsFullScopeChain(true);
@@ -389,6 +393,7 @@ BytecodeGenerator::BytecodeGenerator(EvalNode* evalNode, const Debugger* debugge
     , m_emitNodeDepth(0)
     , m_regeneratingForExceptionInfo(false)
     , m_codeBlockBeingRegeneratedFrom(0)
+    , m_recordsScopedPropertyLookups(false)
 {
     if (m_shouldEmitDebugHooks || m_baseScopeDepth)
         m_codeBlock->setNeedsFullScopeChain(true);
@@ -1005,10 +1010,20 @@ bool BytecodeGenerator::findScopedProperty(const Identifier& property, int& inde
         return false;
     }
 
+    bool canOptimize = findScopedPropertyInScopeChain(*m_scopeChain, property, index, stackDepth, forWriting, globalObject);
+    if (m_recordsScopedPropertyLookups) {
+        ScopedPropertyLookup lookup = { property, forWriting, canOptimize, index, stackDepth, !!globalObject };
+        m_scopedPropertyLookups.append(lookup);
+    }
+    return canOptimize;
+}
+
+bool BytecodeGenerator::findScopedPropertyInScopeChain(const ScopeChain& scopeChain, const Identifier& property, int& index, size_t& stackDepth, bool forWriting, JSObject*& globalObject)
+{
     size_t depth = 0;
     
-    ScopeChainIterator iter = m_scopeChain->begin();
-    ScopeChainIterator end = m_scopeChain->end();
+    ScopeChainIterator iter = scopeChain.begin();
+    ScopeChainIterator end = scopeChain.end();
     for (; iter != end; ++iter, ++depth) {
         JSObject* currentScope = *iter;
         if (!currentScope->isVariableObject())
@@ -1231,6 +1246,15 @@ RegisterID* BytecodeGenerator::emitGetById(RegisterID* dst, RegisterID* base, co
     return dst;
 }
 
+RegisterID* BytecodeGenerator::emitGetArgumentsLength(RegisterID* dst, RegisterID* argumentsRegister)
+{
+    emitOpcode(op_get_arguments_length);
+    instructions().append(dst->index());
+    instructions().append(argumentsRegister->index());
+    instructions().append(addConstant(propertyNames().length));
+    return dst;
+}
+
 RegisterID* BytecodeGenerator::emitPutById(RegisterID* base, const Identifier& property, RegisterID* value)
 {
 #if ENABLE(JIT)
@@ -1299,6 +1323,15 @@ RegisterID* BytecodeGenerator::emitGetByVal(RegisterID* dst, RegisterID* base, R
     return dst;
 }
 
+RegisterID* BytecodeGenerator::emitGetArgumentByVal(RegisterID* dst, RegisterID* argumentsRegister, RegisterID* property)
+{
+    emitOpcode(op_get_argument_by_val);
+    instructions().append(dst->index());
+    instructions().append(argumentsRegister->index());
+    instructions().append(property->index());
+    return dst;
+}
+
 RegisterID* BytecodeGenerator::emitPutByVal(RegisterID* base, RegisterID* property, RegisterID* value)
 {
     emitOpcode(op_put_by_val);
@@ -1392,6 +1425,14 @@ void BytecodeGenerator::createArgumentsIfNecessary()
         emitOpcode(op_create_arguments);
 }
 
+bool BytecodeGenerator::activationMayEscape() const
+{
+    // A function that needs an activation only for a with or catch scope
+    // creates no function that could capture its scope chain, so the
+    // activation is unreachable once the call returns.
+    return m_shouldEmitDebugHooks || m_scopeNode->usesEval() || m_scopeNode->containsClosures();
+}
+
 RegisterID* BytecodeGenerator::emitCallEval(RegisterID* dst, RegisterID* func, RegisterID* thisRegister, ArgumentsNode* argumentsNode, unsigned divot, unsigned startOffset, unsigned endOffset)
 {
     createArgumentsIfNecessary();
@@ -1508,7 +1549,7 @@ RegisterID* BytecodeGenerator::emitCallVarargs(RegisterID* dst, RegisterID* func
 
 RegisterID* BytecodeGenerator::emitReturn(RegisterID* src)
 {
-    if (m_codeBlock->needsFullScopeChain()) {
+    if (m_codeBlock->needsFullScopeChain() && activationMayEscape()) {
         emitOpcode(op_tear_off_activation);
         instructions().append(m_activationRegisterIndex);
     } else if (m_codeBlock->usesArguments() && m_codeBlock->m_numParameters > 1)
@@ -68,6 +68,17 @@ namespace JSC {
         RefPtr<RegisterID> propertyRegister;
     };
 
+    // What findScopedProperty learned from the scope chain about a property.
+    // Code generated using it is only valid for scope chains that agree.
+    struct ScopedPropertyLookup {
+        Identifier property;
+        bool forWriting;
+        bool canOptimize;
+        int index;
+        size_t depth;
+        bool hasGlobalObject;
+    };
+
     class BytecodeGenerator : public FastAllocBase {
     public:
         typedef DeclarationStacks::VarStack VarStack;
@@ -108,6 +119,12 @@ namespace JSC {
         // to the scope containing this codeblock.
         bool findScopedProperty(const Identifier&, int& index, size_t& depth, bool forWriting, JSObject*& globalObject);
 
+        // The part of findScopedProperty that depends on the scope chain.
+        static bool findScopedPropertyInScopeChain(const ScopeChain&, const Identifier&, int& index, size_t& depth, bool forWriting, JSObject*& globalObject);
+
+        void setRecordsScopedPropertyLookups() { m_recordsScopedPropertyLookups = true; }
+        const Vector<ScopedPropertyLookup>& scopedPropertyLookups() const { return m_scopedPropertyLookups; }
+
         // Returns the register storing "this"
         RegisterID* thisRegister() { return &m_thisRegister; }
 
@@ -300,9 +317,11 @@ namespace JSC {
         void emitMethodCheck();
 
         RegisterID* emitGetById(RegisterID* dst, RegisterID* base, const Identifier& property);
+        RegisterID* emitGetArgumentsLength(RegisterID* dst, RegisterID* argumentsRegister);
         RegisterID* emitPutById(RegisterID* base, const Identifier& property, RegisterID* value);
         RegisterID* emitDeleteById(RegisterID* dst, RegisterID* base, const Identifier&);
         RegisterID* emitGetByVal(RegisterID* dst, RegisterID* base, RegisterID* property);
+        RegisterID* emitGetArgumentByVal(RegisterID* dst, RegisterID* argumentsRegister, RegisterID* property);
         RegisterID* emitPutByVal(RegisterID* base, RegisterID* property, RegisterID* value);
         RegisterID* emitDeleteByVal(RegisterID* dst, RegisterID* base, RegisterID* property);
         RegisterID* emitPutByIndex(RegisterID* base, unsigned index, RegisterID* value);
@@ -467,6 +486,7 @@ namespace JSC {
         RegisterID* emitThrowExpressionTooDeepException();
 
         void createArgumentsIfNecessary();
+        bool activationMayEscape() const;
 
         bool m_shouldEmitDebugHooks;
         bool m_shouldEmitProfileHooks;
@@ -523,6 +543,9 @@ namespace JSC {
         bool m_regeneratingForExceptionInfo;
         CodeBlock* m_codeBlockBeingRegeneratedFrom;
 
+        bool m_recordsScopedPropertyLookups;
+        Vector<ScopedPropertyLookup> m_scopedPropertyLookups;
+
         static const unsigned s_maxEmitNodeDepth = 5000;
     };
 
@@ -55,7 +55,7 @@ namespace JSC {
         }
 
     protected:
-        static const unsigned StructureFlags = OverridesGetOwnPropertySlot | OverridesMarkChildren | JSObject::StructureFlags;
+        static const unsigned StructureFlags = OverridesGetOwnPropertySlot | OverridesMarkChildren | HasWriteBarrieredChildren | JSObject::StructureFlags;
 
     private:
         JSActivation* m_activation;
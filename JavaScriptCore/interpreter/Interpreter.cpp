@@ -81,6 +81,31 @@ static ALWAYS_INLINE unsigned bytecodeOffsetForPC(CallFrame* callFrame, CodeBloc
 #endif
 }
 
+// Publishes the first frame of a call from C++ into JavaScript to the sampling
+// profiler, until the call returns.
+class TopCallFrameScope : public Noncopyable {
+public:
+#if ENABLE(SAMPLING_PROFILER)
+    TopCallFrameScope(CallFrame* callFrame)
+        : m_topCallFrameSlot(callFrame->globalData().topCallFrame)
+        , m_savedTopCallFrame(m_topCallFrameSlot)
+    {
+        m_topCallFrameSlot = callFrame;
+    }
+
+    ~TopCallFrameScope()
+    {
+        m_topCallFrameSlot = m_savedTopCallFrame;
+    }
+
+private:
+    CallFrame*& m_topCallFrameSlot;
+    CallFrame* m_savedTopCallFrame;
+#else
+    TopCallFrameScope(CallFrame*) { }
+#endif
+};
+
 // Returns the depth of the scope chain within a given call frame.
 static int depth(CodeBlock* codeBlock, ScopeChain& sc)
 {
@@ -616,6 +641,7 @@ JSValue Interpreter::execute(ProgramExecutable* program, CallFrame* callFrame, S
     JSValue result;
     {
         SamplingTool::CallRecord callRecord(m_sampler.get());
+        TopCallFrameScope topCallFrameScope(newCallFrame);
 
         m_reentryDepth++;
 #if ENABLE(JIT)
@@ -682,6 +708,7 @@ JSValue Interpreter::execute(FunctionExecutable* functionExecutable, CallFrame*
     JSValue result;
     {
         SamplingTool::CallRecord callRecord(m_sampler.get());
+        TopCallFrameScope topCallFrameScope(newCallFrame);
 
         m_reentryDepth++;
 #if ENABLE(JIT)
@@ -750,6 +777,7 @@ JSValue Interpreter::execute(CallFrameClosure& closure, JSValue* exception)
     JSValue result;
     {
         SamplingTool::CallRecord callRecord(m_sampler.get());
+        TopCallFrameScope topCallFrameScope(closure.newCallFrame);
         
         m_reentryDepth++;
 #if ENABLE(JIT)
@@ -844,6 +872,7 @@ JSValue Interpreter::execute(EvalExecutable* eval, CallFrame* callFrame, JSObjec
     JSValue result;
     {
         SamplingTool::CallRecord callRecord(m_sampler.get());
+        TopCallFrameScope topCallFrameScope(newCallFrame);
 
         m_reentryDepth++;
 #if ENABLE(JIT)
@@ -2076,6 +2105,7 @@ JSValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
         ASSERT((*iter)->isVariableObject());
         JSVariableObject* scope = static_cast<JSVariableObject*>(*iter);
         scope->registerAt(index) = JSValue(callFrame->r(value).jsValue());
+        Heap::writeBarrier(scope);
         vPC += OPCODE_LENGTH(op_put_scoped_var);
         NEXT_INSTRUCTION();
     }
@@ -2460,6 +2490,7 @@ skip_id_custom_self:
 
            Generic property access: Gets the property named by identifier
            property from the value base, and puts the result in register dst.
+           Lookups go through the megamorphic cache.
         */
         int dst = vPC[1].u.operand;
         int base = vPC[2].u.operand;
@@ -2467,9 +2498,14 @@ skip_id_custom_self:
 
         Identifier& ident = callFrame->codeBlock()->identifier(property);
         JSValue baseValue = callFrame->r(base).jsValue();
-        PropertySlot slot(baseValue);
-        JSValue result = baseValue.get(callFrame, ident, slot);
-        CHECK_FOR_EXCEPTION();
+        MegamorphicCache& megamorphicCache = callFrame->globalData().megamorphicCache;
+        JSValue result;
+        if (!megamorphicCache.get(baseValue, ident, result)) {
+            PropertySlot slot(baseValue);
+            result = baseValue.get(callFrame, ident, slot);
+            CHECK_FOR_EXCEPTION();
+            megamorphicCache.add(baseValue, ident, slot);
+        }
 
         callFrame->r(dst) = result;
         vPC += OPCODE_LENGTH(op_get_by_id_generic);
@@ -2622,6 +2658,34 @@ skip_id_custom_self:
         uncacheGetByID(callFrame->codeBlock(), vPC);
         NEXT_INSTRUCTION();
     }
+    DEFINE_OPCODE(op_get_arguments_length) {
+        /* get_arguments_length dst(r) arguments(r) property(id)
+
+           Gets arguments.length, and puts the result in register dst.
+           If the arguments object has not been created, the length is
+           read from the call frame and the object is left uncreated;
+           otherwise register arguments holds whatever "arguments" now
+           refers to, and its property is read as by op_get_by_id.
+        */
+        int dst = vPC[1].u.operand;
+        int argumentsRegister = vPC[2].u.operand;
+        int property = vPC[3].u.operand;
+
+        JSValue arguments = callFrame->r(argumentsRegister).jsValue();
+        if (!arguments) {
+            callFrame->r(dst) = jsNumber(callFrame, callFrame->argumentCount() - 1);
+            vPC += OPCODE_LENGTH(op_get_arguments_length);
+            NEXT_INSTRUCTION();
+        }
+
+        Identifier& ident = callFrame->codeBlock()->identifier(property);
+        PropertySlot slot(arguments);
+        JSValue result = arguments.get(callFrame, ident, slot);
+        CHECK_FOR_EXCEPTION();
+        callFrame->r(dst) = result;
+        vPC += OPCODE_LENGTH(op_get_arguments_length);
+        NEXT_INSTRUCTION();
+    }
     DEFINE_OPCODE(op_put_by_id) {
         /* put_by_id base(r) property(id) value(r) nop(n) nop(n) nop(n) nop(n)
 
@@ -2843,6 +2907,53 @@ skip_id_custom_self:
         vPC += OPCODE_LENGTH(op_get_by_val);
         NEXT_INSTRUCTION();
     }
+    DEFINE_OPCODE(op_get_argument_by_val) {
+        /* get_argument_by_val dst(r) arguments(r) property(r)
+
+           Gets arguments[property], and puts the result in register dst.
+           If the arguments object has not been created and property names
+           an argument that was passed, the argument is read from the call
+           frame. Otherwise the arguments object is created if need be, and
+           the property is read as by op_get_by_val.
+        */
+        int dst = vPC[1].u.operand;
+        int argumentsRegister = vPC[2].u.operand;
+        int property = vPC[3].u.operand;
+
+        JSValue baseValue = callFrame->r(argumentsRegister).jsValue();
+        JSValue subscript = callFrame->r(property).jsValue();
+
+        if (!baseValue) {
+            if (subscript.isUInt32() && subscript.asUInt32() < static_cast<uint32_t>(callFrame->argumentCount() - 1)) {
+                callFrame->r(dst) = Arguments::argumentFromCallFrame(callFrame, subscript.asUInt32());
+                vPC += OPCODE_LENGTH(op_get_argument_by_val);
+                NEXT_INSTRUCTION();
+            }
+
+            ASSERT(argumentsRegister == RegisterFile::ArgumentsRegister);
+            Arguments* arguments;
+            if (callFrame->codeBlock()->m_numParameters == 1)
+                arguments = new (globalData) Arguments(callFrame, Arguments::NoParameters);
+            else
+                arguments = new (globalData) Arguments(callFrame);
+            callFrame->setCalleeArguments(arguments);
+            callFrame->r(RegisterFile::ArgumentsRegister) = JSValue(arguments);
+            baseValue = arguments;
+        }
+
+        JSValue result;
+        if (subscript.isUInt32())
+            result = baseValue.get(callFrame, subscript.asUInt32());
+        else {
+            Identifier property(callFrame, subscript.toString(callFrame));
+            result = baseValue.get(callFrame, property);
+        }
+
+        CHECK_FOR_EXCEPTION();
+        callFrame->r(dst) = result;
+        vPC += OPCODE_LENGTH(op_get_argument_by_val);
+        NEXT_INSTRUCTION();
+    }
     DEFINE_OPCODE(op_put_by_val) {
         /* put_by_val base(r) property(r) value(r)
 
@@ -3631,14 +3742,14 @@ skip_id_custom_self:
            Copy all arguments to new memory allocated on the heap,
            and make the 'arguments' object use this memory in the
            future when looking up named parameters, but not any
-           extra arguments. If an activation object exists for the
-           current function context, then the tear_off_activation
-           opcode should be used instead.
+           extra arguments. If the current function context has an
+           activation object that may outlive the call, then the
+           tear_off_activation opcode should be used instead.
 
            This opcode should only be used immediately before op_ret.
         */
 
-        ASSERT(callFrame->codeBlock()->usesArguments() && !callFrame->codeBlock()->needsFullScopeChain());
+        ASSERT(callFrame->codeBlock()->usesArguments());
 
         if (callFrame->optionalCalleeArguments())
             callFrame->optionalCalleeArguments()->copyRegisters();
@@ -236,6 +236,8 @@ void JIT::privateCompileMainPass()
         DEFINE_OP(op_enter_with_activation)
         DEFINE_OP(op_eq)
         DEFINE_OP(op_eq_null)
+        DEFINE_OP(op_get_arguments_length)
+        DEFINE_OP(op_get_argument_by_val)
         DEFINE_OP(op_get_by_id)
         DEFINE_OP(op_get_by_val)
         DEFINE_OP(op_get_by_pname)
@@ -395,6 +397,8 @@ void JIT::privateCompileSlowCases()
         DEFINE_SLOWCASE_OP(op_div)
 #endif
         DEFINE_SLOWCASE_OP(op_eq)
+        DEFINE_SLOWCASE_OP(op_get_arguments_length)
+        DEFINE_SLOWCASE_OP(op_get_argument_by_val)
         DEFINE_SLOWCASE_OP(op_get_by_id)
         DEFINE_SLOWCASE_OP(op_get_by_val)
         DEFINE_SLOWCASE_OP(op_get_by_pname)
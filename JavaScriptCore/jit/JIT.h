@@ -65,6 +65,7 @@ namespace JSC {
     struct Instruction;
     struct OperandTypes;
     struct PolymorphicAccessStructureList;
+    struct PolymorphicPutByIdStructureList;
     struct SimpleJumpTable;
     struct StringJumpTable;
     struct StructureStubInfo;
@@ -337,6 +338,17 @@ namespace JSC {
             jit.privateCompilePutByIdTransition(stubInfo, oldStructure, newStructure, cachedOffset, chain, returnAddress);
         }
 
+        static void compilePutByIdReplaceList(JSGlobalData* globalData, CodeBlock* codeBlock, StructureStubInfo* stubInfo, PolymorphicPutByIdStructureList* polymorphicStructures, int currentIndex, Structure* structure, size_t cachedOffset, ReturnAddressPtr returnAddress)
+        {
+            JIT jit(globalData, codeBlock);
+            jit.privateCompilePutByIdReplaceList(stubInfo, polymorphicStructures, currentIndex, structure, cachedOffset, returnAddress);
+        }
+        static void compilePutByIdTransitionList(JSGlobalData* globalData, CodeBlock* codeBlock, StructureStubInfo* stubInfo, PolymorphicPutByIdStructureList* polymorphicStructures, int currentIndex, Structure* oldStructure, Structure* newStructure, size_t cachedOffset, StructureChain* chain, ReturnAddressPtr returnAddress)
+        {
+            JIT jit(globalData, codeBlock);
+            jit.privateCompilePutByIdTransitionList(stubInfo, polymorphicStructures, currentIndex, oldStructure, newStructure, cachedOffset, chain, returnAddress);
+        }
+
         static void compileCTIMachineTrampolines(JSGlobalData* globalData, RefPtr<ExecutablePool>* executablePool, TrampolineStructure *trampolines)
         {
             JIT jit(globalData);
@@ -380,9 +392,15 @@ namespace JSC {
         void privateCompileGetByIdChainList(StructureStubInfo*, PolymorphicAccessStructureList*, int, Structure*, StructureChain* chain, size_t count, const Identifier&, const PropertySlot&, size_t cachedOffset, CallFrame* callFrame);
         void privateCompileGetByIdChain(StructureStubInfo*, Structure*, StructureChain*, size_t count, const Identifier&, const PropertySlot&, size_t cachedOffset, ReturnAddressPtr returnAddress, CallFrame* callFrame);
         void privateCompilePutByIdTransition(StructureStubInfo*, Structure*, Structure*, size_t cachedOffset, StructureChain*, ReturnAddressPtr returnAddress);
+        void privateCompilePutByIdReplaceList(StructureStubInfo*, PolymorphicPutByIdStructureList*, int, Structure*, size_t cachedOffset, ReturnAddressPtr returnAddress);
+        void privateCompilePutByIdTransitionList(StructureStubInfo*, PolymorphicPutByIdStructureList*, int, Structure* oldStructure, Structure* newStructure, size_t cachedOffset, StructureChain*, ReturnAddressPtr returnAddress);
 
         void privateCompileCTIMachineTrampolines(RefPtr<ExecutablePool>* executablePool, JSGlobalData* data, TrampolineStructure *trampolines);
         void privateCompilePatchGetArrayLength(ReturnAddressPtr returnAddress);
+#if ENABLE(JIT_INTRINSICS)
+        void privateCompileIntrinsicThunks(Label nativeCallThunk, Label* intrinsicThunks);
+        void emitLoadStringCharacterForIntrinsic(JumpList& slowCases);
+#endif
 
         void addSlowCase(Jump);
         void addSlowCase(JumpList);
@@ -408,6 +426,8 @@ namespace JSC {
         Address addressFor(unsigned index, RegisterID base = callFrameRegister);
 
         void testPrototype(Structure*, JumpList& failureCases);
+        CodeLocationLabel compilePutByIdReplaceStub(Structure*, size_t cachedOffset, CodeLocationLabel failureTarget);
+        CodeLocationLabel compilePutByIdTransitionStub(Structure* oldStructure, Structure* newStructure, size_t cachedOffset, StructureChain*, CodeLocationLabel failureTarget);
 
 #if USE(JSVALUE32_64)
         Address tagFor(unsigned index, RegisterID base = callFrameRegister);
@@ -784,6 +804,8 @@ namespace JSC {
         void emit_op_enter_with_activation(Instruction*);
         void emit_op_eq(Instruction*);
         void emit_op_eq_null(Instruction*);
+        void emit_op_get_arguments_length(Instruction*);
+        void emit_op_get_argument_by_val(Instruction*);
         void emit_op_get_by_id(Instruction*);
         void emit_op_get_by_val(Instruction*);
         void emit_op_get_by_pname(Instruction*);
@@ -879,6 +901,8 @@ namespace JSC {
         void emitSlow_op_convert_this(Instruction*, Vector<SlowCaseEntry>::iterator&);
         void emitSlow_op_div(Instruction*, Vector<SlowCaseEntry>::iterator&);
         void emitSlow_op_eq(Instruction*, Vector<SlowCaseEntry>::iterator&);
+        void emitSlow_op_get_arguments_length(Instruction*, Vector<SlowCaseEntry>::iterator&);
+        void emitSlow_op_get_argument_by_val(Instruction*, Vector<SlowCaseEntry>::iterator&);
         void emitSlow_op_get_by_id(Instruction*, Vector<SlowCaseEntry>::iterator&);
         void emitSlow_op_get_by_val(Instruction*, Vector<SlowCaseEntry>::iterator&);
         void emitSlow_op_get_by_pname(Instruction*, Vector<SlowCaseEntry>::iterator&);
@@ -958,6 +982,7 @@ namespace JSC {
         void restoreReturnAddressBeforeReturn(Address);
 
         void emitTimeoutCheck();
+        void emitWriteBarrier(RegisterID owner, RegisterID scratch1, RegisterID scratch2);
 #ifndef NDEBUG
         void printBytecodeOperandTypes(unsigned src1, unsigned src2);
 #endif
@@ -82,6 +82,13 @@ namespace JSC {
             return m_ref.m_code.dataLocation();
         }
 
+        // Unlike size(), safe to call before the code has been generated.
+        bool contains(void* pointerIntoCode) const
+        {
+            char* code = static_cast<char*>(m_ref.m_code.executableAddress());
+            return code && pointerIntoCode >= code && pointerIntoCode < code + m_ref.m_size;
+        }
+
         size_t size()
         {
             ASSERT(m_ref.m_code.executableAddress());
@@ -225,6 +225,44 @@ ALWAYS_INLINE JIT::Jump JIT::checkStructure(RegisterID reg, Structure* structure
     return branchPtr(NotEqual, Address(reg, OBJECT_OFFSETOF(JSCell, m_structure)), ImmPtr(structure));
 }
 
+static inline int32_t atomShift()
+{
+    int32_t shift = 0;
+    for (size_t atomSize = ATOM_SIZE; atomSize > 1; atomSize >>= 1)
+        ++shift;
+    return shift;
+}
+
+// Mirrors Heap::writeBarrier(): if 'owner' is marked, dirties its card in its CollectorBlock.
+ALWAYS_INLINE void JIT::emitWriteBarrier(RegisterID owner, RegisterID scratch1, RegisterID scratch2)
+{
+    // Load the word of the mark bitmap that holds owner's bit, and test the bit.
+    move(owner, scratch1);
+    andPtr(Imm32(BLOCK_OFFSET_MASK), scratch1);
+    rshift32(Imm32(atomShift() + 5), scratch1);
+    move(owner, scratch2);
+    andPtr(Imm32(static_cast<int32_t>(BLOCK_MASK)), scratch2);
+    load32(BaseIndex(scratch2, scratch1, TimesFour, OBJECT_OFFSETOF(CollectorBlock, marked)), scratch1);
+    move(owner, scratch2);
+    rshift32(Imm32(atomShift()), scratch2);
+    and32(Imm32(0x1F), scratch2);
+    rshift32(scratch2, scratch1);
+    Jump unmarked = branchTest32(Zero, scratch1, Imm32(1));
+
+    move(owner, scratch1);
+    andPtr(Imm32(BLOCK_OFFSET_MASK & ~CARD_OFFSET_MASK), scratch1);
+    rshift32(Imm32(CARD_SHIFT - 2), scratch1); // Card index, scaled by sizeof(uint32_t).
+    move(owner, scratch2);
+    andPtr(Imm32(static_cast<int32_t>(BLOCK_MASK)), scratch2);
+    addPtr(scratch2, scratch1);
+    store32(Imm32(1), Address(scratch1, OBJECT_OFFSETOF(CollectorBlock, cards)));
+    unmarked.link(this);
+#if USE(JSVALUE32_64)
+    unmap(scratch1);
+    unmap(scratch2);
+#endif
+}
+
 ALWAYS_INLINE void JIT::linkSlowCaseIfNotJSCell(Vector<SlowCaseEntry>::iterator& iter, int vReg)
 {
     if (!m_codeBlock->isKnownNotImmediate(vReg))
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2010 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "JIT.h"
+
+#if ENABLE(JIT_INTRINSICS)
+
+#include "JITInlineMethods.h"
+#include "JSArray.h"
+#include "JSString.h"
+
+namespace JSC {
+
+// An intrinsic thunk is entered in place of ctiNativeCallThunk, with the callee
+// frame set up and "this" and the arguments just below its header. Whatever it
+// cannot handle, it passes on to ctiNativeCallThunk untouched.
+static inline int argumentOffset(int argumentCountIncludingThis, int argument)
+{
+    // Argument 0 is "this".
+    return (argument - argumentCountIncludingThis - RegisterFile::CallFrameHeaderSize) * static_cast<int>(sizeof(Register));
+}
+
+// Loads the character of a flat string "this" at an int32 index into regT0.
+void JIT::emitLoadStringCharacterForIntrinsic(JumpList& slowCases)
+{
+    loadPtr(Address(callFrameRegister, argumentOffset(2, 0)), regT0);
+    loadPtr(Address(callFrameRegister, argumentOffset(2, 1)), regT1);
+    slowCases.append(emitJumpIfNotJSCell(regT0));
+    slowCases.append(branchPtr(NotEqual, Address(regT0), ImmPtr(m_globalData->jsStringVPtr)));
+    slowCases.append(branchTest32(NonZero, Address(regT0, OBJECT_OFFSETOF(JSString, m_fiberCount))));
+    slowCases.append(emitJumpIfNotImmediateInteger(regT1));
+    zeroExtend32ToPtr(regT1, regT1);
+    slowCases.append(branch32(AboveOrEqual, regT1, Address(regT0, OBJECT_OFFSETOF(JSString, m_length))));
+
+    loadPtr(Address(regT0, OBJECT_OFFSETOF(JSString, m_value) + OBJECT_OFFSETOF(UString, m_rep)), regT0);
+    loadPtr(Address(regT0, OBJECT_OFFSETOF(UStringImpl, m_data)), regT0);
+    load16(BaseIndex(regT0, regT1, TimesTwo, 0), regT0);
+}
+
+void JIT::privateCompileIntrinsicThunks(Label nativeCallThunk, Label* intrinsicThunks)
+{
+    Address argumentCount(callFrameRegister, RegisterFile::ArgumentCount * static_cast<int>(sizeof(Register)));
+
+    // (1) Math.abs
+    {
+        intrinsicThunks[MathAbsIntrinsic] = align();
+        JumpList slowCases;
+        slowCases.append(branch32(NotEqual, argumentCount, Imm32(2)));
+        loadPtr(Address(callFrameRegister, argumentOffset(2, 1)), regT0);
+
+        Jump notInteger = emitJumpIfNotImmediateInteger(regT0);
+        Jump positive = branch32(GreaterThanOrEqual, regT0, Imm32(0));
+        slowCases.append(branchNeg32(Overflow, regT0));
+        positive.link(this);
+        emitFastArithIntToImmNoCheck(regT0, regT0);
+        emitGetFromCallFrameHeaderPtr(RegisterFile::CallerFrame, callFrameRegister);
+        ret();
+
+        // Clearing the sign bit of the double is fabs(), NaN included.
+        notInteger.link(this);
+        slowCases.append(emitJumpIfNotImmediateNumber(regT0));
+        addPtr(tagTypeNumberRegister, regT0);
+        move(ImmPtr(reinterpret_cast<void*>(0x7fffffffffffffffll)), regT1);
+        andPtr(regT1, regT0);
+        movePtrToDouble(regT0, fpRegT0);
+
+        // Like jsNumber(), return a whole result as an int32.
+        JumpList notInt32;
+        branchConvertDoubleToInt32(fpRegT0, regT1, notInt32, fpRegT1);
+        emitFastArithIntToImmNoCheck(regT1, regT0);
+        emitGetFromCallFrameHeaderPtr(RegisterFile::CallerFrame, callFrameRegister);
+        ret();
+
+        notInt32.link(this);
+        subPtr(tagTypeNumberRegister, regT0);
+        emitGetFromCallFrameHeaderPtr(RegisterFile::CallerFrame, callFrameRegister);
+        ret();
+
+        slowCases.linkTo(nativeCallThunk, this);
+    }
+
+    // (2) Math.floor
+    {
+        intrinsicThunks[MathFloorIntrinsic] = align();
+        JumpList slowCases;
+        slowCases.append(branch32(NotEqual, argumentCount, Imm32(2)));
+        loadPtr(Address(callFrameRegister, argumentOffset(2, 1)), regT0);
+
+        Jump notInteger = emitJumpIfNotImmediateInteger(regT0);
+        emitGetFromCallFrameHeaderPtr(RegisterFile::CallerFrame, callFrameRegister);
+        ret();
+
+        notInteger.link(this);
+        slowCases.append(emitJumpIfNotImmediateNumber(regT0));
+        addPtr(tagTypeNumberRegister, regT0);
+        movePtrToDouble(regT0, fpRegT0);
+
+        // Truncation rounds towards zero, so a negative fraction comes out one too big.
+        slowCases.append(branchTruncateDoubleToInt32(fpRegT0, regT1));
+        convertInt32ToDouble(regT1, fpRegT1);
+        Jump rounded = branchDouble(DoubleLessThanOrEqual, fpRegT1, fpRegT0);
+        sub32(Imm32(1), regT1);
+        rounded.link(this);
+
+        // The floor of -0 is -0, which an int32 cannot hold.
+        Jump nonZero = branchTest32(NonZero, regT1);
+        slowCases.append(branchTestPtr(Signed, regT0));
+        nonZero.link(this);
+
+        emitFastArithIntToImmNoCheck(regT1, regT0);
+        emitGetFromCallFrameHeaderPtr(RegisterFile::CallerFrame, callFrameRegister);
+        ret();
+
+        slowCases.linkTo(nativeCallThunk, this);
+    }
+
+    // (3) Math.max and Math.min, of two int32s
+    for (int isMax = 0; isMax < 2; ++isMax) {
+        intrinsicThunks[isMax ? MathMaxIntrinsic : MathMinIntrinsic] = align();
+        JumpList slowCases;
+        slowCases.append(branch32(NotEqual, argumentCount, Imm32(3)));
+        loadPtr(Address(callFrameRegister, argumentOffset(3, 1)), regT0);
+        loadPtr(Address(callFrameRegister, argumentOffset(3, 2)), regT1);
+        slowCases.append(emitJumpIfNotImmediateInteger(regT0));
+        slowCases.append(emitJumpIfNotImmediateInteger(regT1));
+
+        Jump keepFirst = branch32(isMax ? GreaterThanOrEqual : LessThanOrEqual, regT0, regT1);
+        move(regT1, regT0);
+        keepFirst.link(this);
+        emitGetFromCallFrameHeaderPtr(RegisterFile::CallerFrame, callFrameRegister);
+        ret();
+
+        slowCases.linkTo(nativeCallThunk, this);
+    }
+
+    // (4) Math.sqrt, whose result is always boxed as a double
+    {
+        intrinsicThunks[MathSqrtIntrinsic] = align();
+        JumpList slowCases;
+        slowCases.append(branch32(NotEqual, argumentCount, Imm32(2)));
+        loadPtr(Address(callFrameRegister, argumentOffset(2, 1)), regT0);
+
+        Jump notInteger = emitJumpIfNotImmediateInteger(regT0);
+        convertInt32ToDouble(regT0, fpRegT0);
+        Jump haveDouble = jump();
+
+        notInteger.link(this);
+        slowCases.append(emitJumpIfNotImmediateNumber(regT0));
+        addPtr(tagTypeNumberRegister, regT0);
+        movePtrToDouble(regT0, fpRegT0);
+
+        haveDouble.link(this);
+        sqrtDouble(fpRegT0, fpRegT0);
+        moveDoubleToPtr(fpRegT0, regT0);
+        subPtr(tagTypeNumberRegister, regT0);
+        emitGetFromCallFrameHeaderPtr(RegisterFile::CallerFrame, callFrameRegister);
+        ret();
+
+        slowCases.linkTo(nativeCallThunk, this);
+    }
+
+    // (5) String.prototype.charCodeAt
+    {
+        intrinsicThunks[StringCharCodeAtIntrinsic] = align();
+        JumpList slowCases;
+        slowCases.append(branch32(NotEqual, argumentCount, Imm32(2)));
+        emitLoadStringCharacterForIntrinsic(slowCases);
+        emitFastArithIntToImmNoCheck(regT0, regT0);
+        emitGetFromCallFrameHeaderPtr(RegisterFile::CallerFrame, callFrameRegister);
+        ret();
+
+        slowCases.linkTo(nativeCallThunk, this);
+    }
+
+    // (6) String.prototype.charAt, for characters whose single character string already exists
+    {
+        intrinsicThunks[StringCharAtIntrinsic] = align();
+        JumpList slowCases;
+        slowCases.append(branch32(NotEqual, argumentCount, Imm32(2)));
+        emitLoadStringCharacterForIntrinsic(slowCases);
+        slowCases.append(branch32(AboveOrEqual, regT0, Imm32(0x100)));
+        move(ImmPtr(m_globalData->smallStrings.singleCharacterStrings()), regT1);
+        loadPtr(BaseIndex(regT1, regT0, ScalePtr, 0), regT0);
+        slowCases.append(branchTestPtr(Zero, regT0));
+        emitGetFromCallFrameHeaderPtr(RegisterFile::CallerFrame, callFrameRegister);
+        ret();
+
+        slowCases.linkTo(nativeCallThunk, this);
+    }
+
+    // (7) Array.prototype.push, of one value onto an array with room for it in its vector
+    {
+        intrinsicThunks[ArrayPushIntrinsic] = align();
+        JumpList slowCases;
+        slowCases.append(branch32(NotEqual, argumentCount, Imm32(2)));
+        loadPtr(Address(callFrameRegister, argumentOffset(2, 0)), regT0);
+        slowCases.append(emitJumpIfNotJSCell(regT0));
+        slowCases.append(branchPtr(NotEqual, Address(regT0), ImmPtr(m_globalData->jsArrayVPtr)));
+        loadPtr(Address(regT0, OBJECT_OFFSETOF(JSArray, m_storage)), regT2);
+        load32(Address(regT2, OBJECT_OFFSETOF(ArrayStorage, m_length)), regT1);
+        slowCases.append(branch32(AboveOrEqual, regT1, Address(regT0, OBJECT_OFFSETOF(JSArray, m_vectorLength))));
+        loadPtr(Address(callFrameRegister, argumentOffset(2, 1)), regT3);
+        storePtr(regT3, BaseIndex(regT2, regT1, ScalePtr, OBJECT_OFFSETOF(ArrayStorage, m_vector[0])));
+        add32(Imm32(1), Address(regT2, OBJECT_OFFSETOF(ArrayStorage, m_numValuesInVector)));
+        add32(Imm32(1), regT1);
+        store32(regT1, Address(regT2, OBJECT_OFFSETOF(ArrayStorage, m_length)));
+        emitWriteBarrier(regT0, regT2, regT3);
+        emitFastArithIntToImmNoCheck(regT1, regT0);
+        emitGetFromCallFrameHeaderPtr(RegisterFile::CallerFrame, callFrameRegister);
+        ret();
+
+        slowCases.linkTo(nativeCallThunk, this);
+    }
+}
+
+} // namespace JSC
+
+#endif // ENABLE(JIT_INTRINSICS)
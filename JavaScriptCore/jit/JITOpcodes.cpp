@@ -152,6 +152,13 @@ void JIT::privateCompileCTIMachineTrampolines(RefPtr<ExecutablePool>* executable
     emitGetFromCallFrameHeaderPtr(RegisterFile::CallerFrame, regT1);
     emitGetFromCallFrameHeaderPtr(RegisterFile::ScopeChain, regT1, regT1);
     emitPutToCallFrameHeader(regT1, RegisterFile::ScopeChain);
+
+#if ENABLE(SAMPLING_PROFILER)
+    // Host functions have no code block, which is how the sampling profiler
+    // tells their frames apart.
+    emitPutImmediateToCallFrameHeader(0, RegisterFile::CodeBlock);
+    storePtr(callFrameRegister, &m_globalData->topCallFrame);
+#endif
     
 #if CPU(X86)
     emitGetFromCallFrameHeader32(RegisterFile::ArgumentCount, regT0);
@@ -618,13 +625,14 @@ void JIT::emit_op_put_scoped_var(Instruction* currentInstruction)
     int skip = currentInstruction[2].u.operand + m_codeBlock->needsFullScopeChain();
     int value = currentInstruction[3].u.operand;
 
-    emitLoad(value, regT1, regT0);
-
     emitGetFromCallFrameHeaderPtr(RegisterFile::ScopeChain, regT2);
     while (skip--)
         loadPtr(Address(regT2, OBJECT_OFFSETOF(ScopeChainNode, next)), regT2);
 
     loadPtr(Address(regT2, OBJECT_OFFSETOF(ScopeChainNode, object)), regT2);
+    emitWriteBarrier(regT2, regT0, regT1);
+
+    emitLoad(value, regT1, regT0);
     loadPtr(Address(regT2, OBJECT_OFFSETOF(JSVariableObject, d)), regT2);
     loadPtr(Address(regT2, OBJECT_OFFSETOF(JSVariableObject::JSVariableObjectData, registers)), regT2);
 
@@ -1640,6 +1648,13 @@ void JIT::privateCompileCTIMachineTrampolines(RefPtr<ExecutablePool>* executable
     emitGetFromCallFrameHeaderPtr(RegisterFile::CallerFrame, regT1);
     emitGetFromCallFrameHeaderPtr(RegisterFile::ScopeChain, regT1, regT1);
     emitPutToCallFrameHeader(regT1, RegisterFile::ScopeChain);
+
+#if ENABLE(SAMPLING_PROFILER)
+    // Host functions have no code block, which is how the sampling profiler
+    // tells their frames apart.
+    emitPutImmediateToCallFrameHeader(0, RegisterFile::CodeBlock);
+    storePtr(callFrameRegister, &m_globalData->topCallFrame);
+#endif
     
 
 #if CPU(X86_64)
@@ -1916,6 +1931,10 @@ void JIT::privateCompileCTIMachineTrampolines(RefPtr<ExecutablePool>* executable
     restoreReturnAddressBeforeReturn(regT2);
     ret();
     
+#if ENABLE(JIT_INTRINSICS)
+    Label intrinsicThunks[NumberOfIntrinsics];
+    privateCompileIntrinsicThunks(nativeCallThunk, intrinsicThunks);
+#endif
 
 #if ENABLE(JIT_OPTIMIZE_PROPERTY_ACCESS)
     Call string_failureCases1Call = makeTailRecursiveCall(string_failureCases1);
@@ -1945,6 +1964,10 @@ void JIT::privateCompileCTIMachineTrampolines(RefPtr<ExecutablePool>* executable
     trampolines->ctiVirtualCallLink = trampolineAt(finalCode, virtualCallLinkBegin);
     trampolines->ctiVirtualCall = trampolineAt(finalCode, virtualCallBegin);
     trampolines->ctiNativeCallThunk = trampolineAt(finalCode, nativeCallThunk);
+#if ENABLE(JIT_INTRINSICS)
+    for (unsigned i = 0; i < NumberOfIntrinsics; ++i)
+        trampolines->ctiIntrinsicThunks[i] = trampolineAt(finalCode, intrinsicThunks[i]);
+#endif
 #if ENABLE(JIT_OPTIMIZE_MOD)
     trampolines->ctiSoftModulo = trampolineAt(finalCode, softModBegin);
 #endif
@@ -2143,6 +2166,7 @@ void JIT::emit_op_put_scoped_var(Instruction* currentInstruction)
         loadPtr(Address(regT1, OBJECT_OFFSETOF(ScopeChainNode, next)), regT1);
 
     loadPtr(Address(regT1, OBJECT_OFFSETOF(ScopeChainNode, object)), regT1);
+    emitWriteBarrier(regT1, regT2, regT3);
     emitPutVariableObjectRegister(regT0, regT1, currentInstruction[1].u.operand);
 }
 
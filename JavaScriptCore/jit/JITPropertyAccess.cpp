@@ -139,6 +139,77 @@ void JIT::emitSlow_op_get_by_pname(Instruction* currentInstruction, Vector<SlowC
     stubCall.call(dst);
 }
 
+void JIT::emit_op_get_arguments_length(Instruction* currentInstruction)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned argumentsRegister = currentInstruction[2].u.operand;
+
+    addSlowCase(branchTestPtr(NonZero, addressFor(argumentsRegister)));
+    emitGetFromCallFrameHeader32(RegisterFile::ArgumentCount, regT0);
+    sub32(Imm32(1), regT0);
+    emitFastArithReTagImmediate(regT0, regT0);
+    emitPutVirtualRegister(dst, regT0);
+}
+
+void JIT::emitSlow_op_get_arguments_length(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned argumentsRegister = currentInstruction[2].u.operand;
+    unsigned ident = currentInstruction[3].u.operand;
+
+    linkSlowCase(iter); // arguments object created
+
+    JITStubCall stubCall(this, cti_op_get_by_id_generic);
+    stubCall.addArgument(argumentsRegister, regT2);
+    stubCall.addArgument(ImmPtr(&m_codeBlock->identifier(ident)));
+    stubCall.call(dst);
+}
+
+void JIT::emit_op_get_argument_by_val(Instruction* currentInstruction)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned argumentsRegister = currentInstruction[2].u.operand;
+    unsigned property = currentInstruction[3].u.operand;
+    int numParameters = m_codeBlock->m_numParameters - 1;
+
+    addSlowCase(branchTestPtr(NonZero, addressFor(argumentsRegister)));
+    emitGetVirtualRegister(property, regT1);
+    emitJumpSlowCaseIfNotImmediateInteger(regT1);
+#if USE(JSVALUE64)
+    zeroExtend32ToPtr(regT1, regT1);
+#else
+    emitFastArithImmToInt(regT1);
+#endif
+    emitGetFromCallFrameHeader32(RegisterFile::ArgumentCount, regT2);
+    sub32(Imm32(1), regT2);
+    addSlowCase(branch32(AboveOrEqual, regT1, regT2));
+
+    // Named parameters are read from their own registers; the caller left any
+    // others argumentCount registers further down, where Arguments finds them.
+    Jump isNamedParameter = branch32(Below, regT1, Imm32(numParameters));
+    add32(Imm32(1), regT2);
+    subPtr(regT2, regT1);
+    isNamedParameter.link(this);
+    loadPtr(BaseIndex(callFrameRegister, regT1, ScalePtr, (-RegisterFile::CallFrameHeaderSize - numParameters) * static_cast<int>(sizeof(Register))), regT0);
+    emitPutVirtualRegister(dst, regT0);
+}
+
+void JIT::emitSlow_op_get_argument_by_val(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned argumentsRegister = currentInstruction[2].u.operand;
+    unsigned property = currentInstruction[3].u.operand;
+
+    linkSlowCase(iter); // arguments object created
+    linkSlowCase(iter); // property int32 check
+    linkSlowCase(iter); // argument count check
+
+    JITStubCall stubCall(this, cti_op_get_argument_by_val);
+    stubCall.addArgument(Imm32(argumentsRegister));
+    stubCall.addArgument(property, regT2);
+    stubCall.call(dst);
+}
+
 void JIT::emit_op_put_by_val(Instruction* currentInstruction)
 {
     unsigned base = currentInstruction[1].u.operand;
@@ -156,6 +227,7 @@ void JIT::emit_op_put_by_val(Instruction* currentInstruction)
     emitJumpSlowCaseIfNotJSCell(regT0, base);
     addSlowCase(branchPtr(NotEqual, Address(regT0), ImmPtr(m_globalData->jsArrayVPtr)));
     addSlowCase(branch32(AboveOrEqual, regT1, Address(regT0, OBJECT_OFFSETOF(JSArray, m_vectorLength))));
+    emitWriteBarrier(regT0, regT2, regT3);
 
     loadPtr(Address(regT0, OBJECT_OFFSETOF(JSArray, m_storage)), regT2);
 
@@ -446,6 +518,9 @@ void JIT::emit_op_put_by_id(Instruction* currentInstruction)
     // Jump to a slow case if either the base object is an immediate, or if the Structure does not match.
     emitJumpSlowCaseIfNotJSCell(regT0, baseVReg);
 
+    // The barrier is planted ahead of the patchable sequence so as not to disturb its offsets.
+    emitWriteBarrier(regT0, regT2, regT3);
+
     BEGIN_UNINTERRUPTED_SEQUENCE(sequencePutById);
 
     Label hotPathBegin(this);
@@ -533,7 +608,38 @@ void JIT::testPrototype(Structure* structure, JumpList& failureCases)
     failureCases.append(branchPtr(NotEqual, Address(regT2), regT3));
 }
 
-void JIT::privateCompilePutByIdTransition(StructureStubInfo* stubInfo, Structure* oldStructure, Structure* newStructure, size_t cachedOffset, StructureChain* chain, ReturnAddressPtr returnAddress)
+// Compiles a stub for put_by_id's slow case call that stores into an object of the given Structure.
+// Any other base is passed to failureTarget, or to cti_op_put_by_id_list if there is none.
+CodeLocationLabel JIT::compilePutByIdReplaceStub(Structure* structure, size_t cachedOffset, CodeLocationLabel failureTarget)
+{
+    JumpList failureCases;
+    // Check eax is an object of the right Structure.
+    failureCases.append(emitJumpIfNotJSCell(regT0));
+    failureCases.append(branchPtr(NotEqual, Address(regT0, OBJECT_OFFSETOF(JSCell, m_structure)), ImmPtr(structure)));
+
+    // The hot path has already run the write barrier.
+    compilePutDirectOffset(regT0, regT1, structure, cachedOffset);
+    ret();
+
+    Call failureCall;
+    if (!failureTarget) {
+        failureCases.link(this);
+        restoreArgumentReferenceForTrampoline();
+        failureCall = tailRecursiveCall();
+    }
+
+    LinkBuffer patchBuffer(this, m_codeBlock->executablePool());
+
+    if (!failureTarget)
+        patchBuffer.link(failureCall, FunctionPtr(cti_op_put_by_id_list));
+    else
+        patchBuffer.link(failureCases, failureTarget);
+
+    return patchBuffer.finalizeCodeAddendum();
+}
+
+// As above, but adds the property, moving the object from oldStructure to newStructure.
+CodeLocationLabel JIT::compilePutByIdTransitionStub(Structure* oldStructure, Structure* newStructure, size_t cachedOffset, StructureChain* chain, CodeLocationLabel failureTarget)
 {
     JumpList failureCases;
     // Check eax is an object of the right Structure.
@@ -571,6 +677,7 @@ void JIT::privateCompilePutByIdTransition(StructureStubInfo* stubInfo, Structure
     sub32(Imm32(1), AbsoluteAddress(oldStructure->addressOfCount()));
     add32(Imm32(1), AbsoluteAddress(newStructure->addressOfCount()));
     storePtr(ImmPtr(newStructure), Address(regT0, OBJECT_OFFSETOF(JSCell, m_structure)));
+    emitWriteBarrier(regT0, regT2, regT3);
 
     // write the value
     compilePutDirectOffset(regT0, regT1, newStructure, cachedOffset);
@@ -578,25 +685,63 @@ void JIT::privateCompilePutByIdTransition(StructureStubInfo* stubInfo, Structure
     ret();
     
     ASSERT(!failureCases.empty());
-    failureCases.link(this);
-    restoreArgumentReferenceForTrampoline();
-    Call failureCall = tailRecursiveCall();
+    Call failureCall;
+    if (!failureTarget) {
+        failureCases.link(this);
+        restoreArgumentReferenceForTrampoline();
+        failureCall = tailRecursiveCall();
+    }
 
     LinkBuffer patchBuffer(this, m_codeBlock->executablePool());
 
-    patchBuffer.link(failureCall, FunctionPtr(cti_op_put_by_id_fail));
+    if (!failureTarget)
+        patchBuffer.link(failureCall, FunctionPtr(cti_op_put_by_id_list));
+    else
+        patchBuffer.link(failureCases, failureTarget);
 
     if (willNeedStorageRealloc) {
         ASSERT(m_calls.size() == 1);
         patchBuffer.link(m_calls[0].from, FunctionPtr(cti_op_put_by_id_transition_realloc));
     }
     
-    CodeLocationLabel entryLabel = patchBuffer.finalizeCodeAddendum();
+    return patchBuffer.finalizeCodeAddendum();
+}
+
+void JIT::privateCompilePutByIdTransition(StructureStubInfo* stubInfo, Structure* oldStructure, Structure* newStructure, size_t cachedOffset, StructureChain* chain, ReturnAddressPtr returnAddress)
+{
+    CodeLocationLabel entryLabel = compilePutByIdTransitionStub(oldStructure, newStructure, cachedOffset, chain, CodeLocationLabel());
     stubInfo->stubRoutine = entryLabel;
     RepatchBuffer repatchBuffer(m_codeBlock);
     repatchBuffer.relinkCallerToTrampoline(returnAddress, entryLabel);
 }
 
+void JIT::privateCompilePutByIdReplaceList(StructureStubInfo*, PolymorphicPutByIdStructureList* polymorphicStructures, int currentIndex, Structure* structure, size_t cachedOffset, ReturnAddressPtr returnAddress)
+{
+    // Chain the new stub in front of the last one, so that misses work their way down the list.
+    CodeLocationLabel lastStubBegin = polymorphicStructures->list[currentIndex - 1].stubRoutine;
+    CodeLocationLabel entryLabel = compilePutByIdReplaceStub(structure, cachedOffset, lastStubBegin);
+
+    structure->ref();
+    polymorphicStructures->list[currentIndex].set(entryLabel, structure);
+
+    RepatchBuffer repatchBuffer(m_codeBlock);
+    repatchBuffer.relinkCallerToTrampoline(returnAddress, entryLabel);
+}
+
+void JIT::privateCompilePutByIdTransitionList(StructureStubInfo*, PolymorphicPutByIdStructureList* polymorphicStructures, int currentIndex, Structure* oldStructure, Structure* newStructure, size_t cachedOffset, StructureChain* chain, ReturnAddressPtr returnAddress)
+{
+    CodeLocationLabel lastStubBegin = polymorphicStructures->list[currentIndex - 1].stubRoutine;
+    CodeLocationLabel entryLabel = compilePutByIdTransitionStub(oldStructure, newStructure, cachedOffset, chain, lastStubBegin);
+
+    oldStructure->ref();
+    newStructure->ref();
+    chain->ref();
+    polymorphicStructures->list[currentIndex].set(entryLabel, oldStructure, newStructure, chain);
+
+    RepatchBuffer repatchBuffer(m_codeBlock);
+    repatchBuffer.relinkCallerToTrampoline(returnAddress, entryLabel);
+}
+
 void JIT::patchGetByIdSelf(CodeBlock* codeBlock, StructureStubInfo* stubInfo, Structure* structure, size_t cachedOffset, ReturnAddressPtr returnAddress)
 {
     RepatchBuffer repatchBuffer(codeBlock);
@@ -641,9 +786,8 @@ void JIT::patchPutByIdReplace(CodeBlock* codeBlock, StructureStubInfo* stubInfo,
 {
     RepatchBuffer repatchBuffer(codeBlock);
 
-    // We don't want to patch more than once - in future go to cti_op_put_by_id_generic.
-    // Should probably go to cti_op_put_by_id_fail, but that doesn't do anything interesting right now.
-    repatchBuffer.relinkCallerToFunction(returnAddress, FunctionPtr(cti_op_put_by_id_generic));
+    // Further Structures seen here are given stubs of their own, chained behind the hot path.
+    repatchBuffer.relinkCallerToFunction(returnAddress, FunctionPtr(cti_op_put_by_id_list));
 
     int offset = sizeof(JSValue) * cachedOffset;
 
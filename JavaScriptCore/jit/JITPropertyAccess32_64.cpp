@@ -103,6 +103,73 @@ void JIT::emit_op_del_by_id(Instruction* currentInstruction)
 }
 
 
+void JIT::emit_op_get_arguments_length(Instruction* currentInstruction)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned argumentsRegister = currentInstruction[2].u.operand;
+
+    addSlowCase(branch32(NotEqual, tagFor(argumentsRegister), Imm32(JSValue::EmptyValueTag)));
+    emitGetFromCallFrameHeader32(RegisterFile::ArgumentCount, regT0);
+    sub32(Imm32(1), regT0);
+    emitStoreInt32(dst, regT0);
+}
+
+void JIT::emitSlow_op_get_arguments_length(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned argumentsRegister = currentInstruction[2].u.operand;
+    unsigned ident = currentInstruction[3].u.operand;
+
+    linkSlowCase(iter); // arguments object created
+
+    JITStubCall stubCall(this, cti_op_get_by_id_generic);
+    stubCall.addArgument(argumentsRegister);
+    stubCall.addArgument(ImmPtr(&m_codeBlock->identifier(ident)));
+    stubCall.call(dst);
+}
+
+void JIT::emit_op_get_argument_by_val(Instruction* currentInstruction)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned argumentsRegister = currentInstruction[2].u.operand;
+    unsigned property = currentInstruction[3].u.operand;
+    int numParameters = m_codeBlock->m_numParameters - 1;
+
+    addSlowCase(branch32(NotEqual, tagFor(argumentsRegister), Imm32(JSValue::EmptyValueTag)));
+    emitLoad(property, regT3, regT2);
+    addSlowCase(branch32(NotEqual, regT3, Imm32(JSValue::Int32Tag)));
+    emitGetFromCallFrameHeader32(RegisterFile::ArgumentCount, regT3);
+    sub32(Imm32(1), regT3);
+    addSlowCase(branch32(AboveOrEqual, regT2, regT3));
+
+    // Named parameters are read from their own registers; the caller left any
+    // others argumentCount registers further down, where Arguments finds them.
+    Jump isNamedParameter = branch32(Below, regT2, Imm32(numParameters));
+    add32(Imm32(1), regT3);
+    sub32(regT3, regT2);
+    isNamedParameter.link(this);
+    int offset = (-RegisterFile::CallFrameHeaderSize - numParameters) * static_cast<int>(sizeof(Register));
+    load32(BaseIndex(callFrameRegister, regT2, TimesEight, offset + OBJECT_OFFSETOF(JSValue, u.asBits.tag)), regT1);
+    load32(BaseIndex(callFrameRegister, regT2, TimesEight, offset + OBJECT_OFFSETOF(JSValue, u.asBits.payload)), regT0);
+    emitStore(dst, regT1, regT0);
+}
+
+void JIT::emitSlow_op_get_argument_by_val(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned argumentsRegister = currentInstruction[2].u.operand;
+    unsigned property = currentInstruction[3].u.operand;
+
+    linkSlowCase(iter); // arguments object created
+    linkSlowCase(iter); // property int32 check
+    linkSlowCase(iter); // argument count check
+
+    JITStubCall stubCall(this, cti_op_get_argument_by_val);
+    stubCall.addArgument(Imm32(argumentsRegister));
+    stubCall.addArgument(property);
+    stubCall.call(dst);
+}
+
 #if !ENABLE(JIT_OPTIMIZE_PROPERTY_ACCESS)
 
 /* ------------------------------ BEGIN: !ENABLE(JIT_OPTIMIZE_PROPERTY_ACCESS) ------------------------------ */
@@ -322,6 +389,7 @@ void JIT::emit_op_put_by_val(Instruction* currentInstruction)
     emitJumpSlowCaseIfNotJSCell(base, regT1);
     addSlowCase(branchPtr(NotEqual, Address(regT0), ImmPtr(m_globalData->jsArrayVPtr)));
     addSlowCase(branch32(AboveOrEqual, regT2, Address(regT0, OBJECT_OFFSETOF(JSArray, m_vectorLength))));
+    emitWriteBarrier(regT0, regT1, regT3);
     
     loadPtr(Address(regT0, OBJECT_OFFSETOF(JSArray, m_storage)), regT3);
     
@@ -456,10 +524,15 @@ void JIT::emit_op_put_by_id(Instruction* currentInstruction)
     int base = currentInstruction[1].u.operand;
     int value = currentInstruction[3].u.operand;
     
-    emitLoad2(base, regT1, regT0, value, regT3, regT2);
+    emitLoad(base, regT1, regT0);
     
     emitJumpSlowCaseIfNotJSCell(base, regT1);
     
+    // The barrier is planted ahead of the patchable sequence so as not to disturb its offsets;
+    // the value is loaded afterwards since the barrier needs two scratch registers.
+    emitWriteBarrier(regT0, regT2, regT3);
+    emitLoad(value, regT3, regT2);
+    
     BEGIN_UNINTERRUPTED_SEQUENCE(sequencePutById);
     
     Label hotPathBegin(this);
@@ -490,10 +563,14 @@ void JIT::emitSlow_op_put_by_id(Instruction* currentInstruction, Vector<SlowCase
 {
     int base = currentInstruction[1].u.operand;
     int ident = currentInstruction[2].u.operand;
+    int value = currentInstruction[3].u.operand;
     
     linkSlowCaseIfNotJSCell(iter, base);
     linkSlowCase(iter);
     
+    // The value may not have been loaded yet if the base was not a cell.
+    emitLoad(value, regT3, regT2);
+    
     JITStubCall stubCall(this, cti_op_put_by_id);
     stubCall.addArgument(regT1, regT0);
     stubCall.addArgument(ImmPtr(&(m_codeBlock->identifier(ident))));
@@ -551,7 +628,44 @@ void JIT::testPrototype(Structure* structure, JumpList& failureCases)
     failureCases.append(branchPtr(NotEqual, AbsoluteAddress(&asCell(structure->m_prototype)->m_structure), ImmPtr(asCell(structure->m_prototype)->m_structure)));
 }
 
-void JIT::privateCompilePutByIdTransition(StructureStubInfo* stubInfo, Structure* oldStructure, Structure* newStructure, size_t cachedOffset, StructureChain* chain, ReturnAddressPtr returnAddress)
+// Compiles a stub for put_by_id's slow case call that stores into an object of the given Structure.
+// Any other base is passed to failureTarget, or to cti_op_put_by_id_list if there is none.
+CodeLocationLabel JIT::compilePutByIdReplaceStub(Structure* structure, size_t cachedOffset, CodeLocationLabel failureTarget)
+{
+    // It is assumed that regT0 contains the basePayload and regT1 contains the baseTag.  The value can be found on the stack.
+    
+    JumpList failureCases;
+    failureCases.append(branch32(NotEqual, regT1, Imm32(JSValue::CellTag)));
+    failureCases.append(branchPtr(NotEqual, Address(regT0, OBJECT_OFFSETOF(JSCell, m_structure)), ImmPtr(structure)));
+    
+    // The hot path has already run the write barrier.
+    load32(Address(stackPointerRegister, offsetof(struct JITStackFrame, args[2]) + sizeof(void*)), regT3);
+    load32(Address(stackPointerRegister, offsetof(struct JITStackFrame, args[2]) + sizeof(void*) + 4), regT2);
+    
+    // Write the value
+    compilePutDirectOffset(regT0, regT2, regT3, structure, cachedOffset);
+    
+    ret();
+    
+    Call failureCall;
+    if (!failureTarget) {
+        failureCases.link(this);
+        restoreArgumentReferenceForTrampoline();
+        failureCall = tailRecursiveCall();
+    }
+    
+    LinkBuffer patchBuffer(this, m_codeBlock->executablePool());
+    
+    if (!failureTarget)
+        patchBuffer.link(failureCall, FunctionPtr(cti_op_put_by_id_list));
+    else
+        patchBuffer.link(failureCases, failureTarget);
+    
+    return patchBuffer.finalizeCodeAddendum();
+}
+
+// As above, but adds the property, moving the object from oldStructure to newStructure.
+CodeLocationLabel JIT::compilePutByIdTransitionStub(Structure* oldStructure, Structure* newStructure, size_t cachedOffset, StructureChain* chain, CodeLocationLabel failureTarget)
 {
     // It is assumed that regT0 contains the basePayload and regT1 contains the baseTag.  The value can be found on the stack.
     
@@ -586,6 +700,7 @@ void JIT::privateCompilePutByIdTransition(StructureStubInfo* stubInfo, Structure
     sub32(Imm32(1), AbsoluteAddress(oldStructure->addressOfCount()));
     add32(Imm32(1), AbsoluteAddress(newStructure->addressOfCount()));
     storePtr(ImmPtr(newStructure), Address(regT0, OBJECT_OFFSETOF(JSCell, m_structure)));
+    emitWriteBarrier(regT0, regT2, regT3);
     
     load32(Address(stackPointerRegister, offsetof(struct JITStackFrame, args[2]) + sizeof(void*)), regT3);
     load32(Address(stackPointerRegister, offsetof(struct JITStackFrame, args[2]) + sizeof(void*) + 4), regT2);
@@ -596,25 +711,63 @@ void JIT::privateCompilePutByIdTransition(StructureStubInfo* stubInfo, Structure
     ret();
     
     ASSERT(!failureCases.empty());
-    failureCases.link(this);
-    restoreArgumentReferenceForTrampoline();
-    Call failureCall = tailRecursiveCall();
+    Call failureCall;
+    if (!failureTarget) {
+        failureCases.link(this);
+        restoreArgumentReferenceForTrampoline();
+        failureCall = tailRecursiveCall();
+    }
     
     LinkBuffer patchBuffer(this, m_codeBlock->executablePool());
     
-    patchBuffer.link(failureCall, FunctionPtr(cti_op_put_by_id_fail));
+    if (!failureTarget)
+        patchBuffer.link(failureCall, FunctionPtr(cti_op_put_by_id_list));
+    else
+        patchBuffer.link(failureCases, failureTarget);
     
     if (willNeedStorageRealloc) {
         ASSERT(m_calls.size() == 1);
         patchBuffer.link(m_calls[0].from, FunctionPtr(cti_op_put_by_id_transition_realloc));
     }
     
-    CodeLocationLabel entryLabel = patchBuffer.finalizeCodeAddendum();
+    return patchBuffer.finalizeCodeAddendum();
+}
+
+void JIT::privateCompilePutByIdTransition(StructureStubInfo* stubInfo, Structure* oldStructure, Structure* newStructure, size_t cachedOffset, StructureChain* chain, ReturnAddressPtr returnAddress)
+{
+    CodeLocationLabel entryLabel = compilePutByIdTransitionStub(oldStructure, newStructure, cachedOffset, chain, CodeLocationLabel());
     stubInfo->stubRoutine = entryLabel;
     RepatchBuffer repatchBuffer(m_codeBlock);
     repatchBuffer.relinkCallerToTrampoline(returnAddress, entryLabel);
 }
 
+void JIT::privateCompilePutByIdReplaceList(StructureStubInfo*, PolymorphicPutByIdStructureList* polymorphicStructures, int currentIndex, Structure* structure, size_t cachedOffset, ReturnAddressPtr returnAddress)
+{
+    // Chain the new stub in front of the last one, so that misses work their way down the list.
+    CodeLocationLabel lastStubBegin = polymorphicStructures->list[currentIndex - 1].stubRoutine;
+    CodeLocationLabel entryLabel = compilePutByIdReplaceStub(structure, cachedOffset, lastStubBegin);
+    
+    structure->ref();
+    polymorphicStructures->list[currentIndex].set(entryLabel, structure);
+    
+    RepatchBuffer repatchBuffer(m_codeBlock);
+    repatchBuffer.relinkCallerToTrampoline(returnAddress, entryLabel);
+}
+
+void JIT::privateCompilePutByIdTransitionList(StructureStubInfo*, PolymorphicPutByIdStructureList* polymorphicStructures, int currentIndex, Structure* oldStructure, Structure* newStructure, size_t cachedOffset, StructureChain* chain, ReturnAddressPtr returnAddress)
+{
+    CodeLocationLabel lastStubBegin = polymorphicStructures->list[currentIndex - 1].stubRoutine;
+    CodeLocationLabel entryLabel = compilePutByIdTransitionStub(oldStructure, newStructure, cachedOffset, chain, lastStubBegin);
+    
+    oldStructure->ref();
+    newStructure->ref();
+    chain->ref();
+    polymorphicStructures->list[currentIndex].set(entryLabel, oldStructure, newStructure, chain);
+    
+    RepatchBuffer repatchBuffer(m_codeBlock);
+    repatchBuffer.relinkCallerToTrampoline(returnAddress, entryLabel);
+}
+
 void JIT::patchGetByIdSelf(CodeBlock* codeBlock, StructureStubInfo* stubInfo, Structure* structure, size_t cachedOffset, ReturnAddressPtr returnAddress)
 {
     RepatchBuffer repatchBuffer(codeBlock);
@@ -660,9 +813,8 @@ void JIT::patchPutByIdReplace(CodeBlock* codeBlock, StructureStubInfo* stubInfo,
 {
     RepatchBuffer repatchBuffer(codeBlock);
     
-    // We don't want to patch more than once - in future go to cti_op_put_by_id_generic.
-    // Should probably go to cti_op_put_by_id_fail, but that doesn't do anything interesting right now.
-    repatchBuffer.relinkCallerToFunction(returnAddress, FunctionPtr(cti_op_put_by_id_generic));
+    // Further Structures seen here are given stubs of their own, chained behind the hot path.
+    repatchBuffer.relinkCallerToFunction(returnAddress, FunctionPtr(cti_op_put_by_id_list));
     
     int offset = sizeof(JSValue) * cachedOffset;
     
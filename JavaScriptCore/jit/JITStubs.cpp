@@ -33,6 +33,7 @@
 #if ENABLE(JIT)
 
 #include "Arguments.h"
+#include "ArrayPrototype.h"
 #include "CallFrame.h"
 #include "CodeBlock.h"
 #include "Collector.h"
@@ -49,6 +50,7 @@
 #include "JSPropertyNameIterator.h"
 #include "JSStaticScopeObject.h"
 #include "JSString.h"
+#include "MathObject.h"
 #include "ObjectPrototype.h"
 #include "Operations.h"
 #include "Parser.h"
@@ -56,7 +58,9 @@
 #include "RegExpObject.h"
 #include "RegExpPrototype.h"
 #include "Register.h"
+#include "SamplingProfiler.h"
 #include "SamplingTool.h"
+#include "StringPrototype.h"
 #include <wtf/StdLibExtras.h>
 #include <stdarg.h>
 #include <stdio.h>
@@ -835,6 +839,32 @@ JITThunks::JITThunks(JSGlobalData* globalData)
 #endif
 }
 
+MacroAssemblerCodePtr JITThunks::hostFunctionStub(NativeFunction function)
+{
+#if ENABLE(JIT_INTRINSICS)
+    MacroAssemblerCodePtr* intrinsicThunks = m_trampolineStructure.ctiIntrinsicThunks;
+    if (function == mathProtoFuncAbs)
+        return intrinsicThunks[MathAbsIntrinsic];
+    if (function == mathProtoFuncFloor)
+        return intrinsicThunks[MathFloorIntrinsic];
+    if (function == mathProtoFuncMax)
+        return intrinsicThunks[MathMaxIntrinsic];
+    if (function == mathProtoFuncMin)
+        return intrinsicThunks[MathMinIntrinsic];
+    if (function == mathProtoFuncSqrt)
+        return intrinsicThunks[MathSqrtIntrinsic];
+    if (function == stringProtoFuncCharAt)
+        return intrinsicThunks[StringCharAtIntrinsic];
+    if (function == stringProtoFuncCharCodeAt)
+        return intrinsicThunks[StringCharCodeAtIntrinsic];
+    if (function == arrayProtoFuncPush)
+        return intrinsicThunks[ArrayPushIntrinsic];
+#else
+    UNUSED_PARAM(function);
+#endif
+    return ctiNativeCallThunk();
+}
+
 #if ENABLE(JIT_OPTIMIZE_PROPERTY_ACCESS)
 
 NEVER_INLINE void JITThunks::tryCachePutByID(CallFrame* callFrame, CodeBlock* codeBlock, ReturnAddressPtr returnAddress, JSValue baseValue, const PutPropertySlot& slot, StructureStubInfo* stubInfo)
@@ -984,6 +1014,17 @@ NEVER_INLINE void JITThunks::tryCacheGetByID(CallFrame* callFrame, CodeBlock* co
 #define SETUP_VA_LISTL_ARGS
 #endif
 
+#if ENABLE(SAMPLING_PROFILER)
+// Stub functions do not keep the JIT's call frame register, so they tell a
+// running sampling profiler which frame called them.
+#define PUBLISH_TOP_CALL_FRAME(stackFrame) do { \
+        if (UNLIKELY(stackFrame.globalData->isSamplingProfilerRunning)) \
+            stackFrame.globalData->topCallFrame = stackFrame.callFrame; \
+    } while (0)
+#else
+#define PUBLISH_TOP_CALL_FRAME(stackFrame) do { } while (0)
+#endif
+
 #ifndef NDEBUG
 
 extern "C" {
@@ -1014,13 +1055,13 @@ struct StackHack {
     ReturnAddressPtr savedReturnAddress;
 };
 
-#define STUB_INIT_STACK_FRAME(stackFrame) SETUP_VA_LISTL_ARGS; JITStackFrame& stackFrame = *reinterpret_cast<JITStackFrame*>(STUB_ARGS); StackHack stackHack(stackFrame)
+#define STUB_INIT_STACK_FRAME(stackFrame) SETUP_VA_LISTL_ARGS; JITStackFrame& stackFrame = *reinterpret_cast<JITStackFrame*>(STUB_ARGS); StackHack stackHack(stackFrame); PUBLISH_TOP_CALL_FRAME(stackFrame)
 #define STUB_SET_RETURN_ADDRESS(returnAddress) stackHack.savedReturnAddress = ReturnAddressPtr(returnAddress)
 #define STUB_RETURN_ADDRESS stackHack.savedReturnAddress
 
 #else
 
-#define STUB_INIT_STACK_FRAME(stackFrame) SETUP_VA_LISTL_ARGS; JITStackFrame& stackFrame = *reinterpret_cast<JITStackFrame*>(STUB_ARGS)
+#define STUB_INIT_STACK_FRAME(stackFrame) SETUP_VA_LISTL_ARGS; JITStackFrame& stackFrame = *reinterpret_cast<JITStackFrame*>(STUB_ARGS); PUBLISH_TOP_CALL_FRAME(stackFrame)
 #define STUB_SET_RETURN_ADDRESS(returnAddress) *stackFrame.returnAddressSlot() = ReturnAddressPtr(returnAddress)
 #define STUB_RETURN_ADDRESS *stackFrame.returnAddressSlot()
 
@@ -1261,6 +1302,13 @@ DEFINE_STUB_FUNCTION(int, timeout_check)
     JSGlobalData* globalData = stackFrame.globalData;
     TimeoutChecker& timeoutChecker = globalData->timeoutChecker;
 
+#if ENABLE(SAMPLING_PROFILER)
+    // Long-running loops may not collect garbage often enough to keep the
+    // sampling profiler's buffer from filling up.
+    if (globalData->samplingProfiler)
+        globalData->samplingProfiler->processSamples();
+#endif
+
     if (globalData->terminator.shouldTerminate()) {
         globalData->exception = createTerminatedExecutionException(globalData);
         VM_THROW_EXCEPTION_AT_END();
@@ -1323,8 +1371,14 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_generic)
     Identifier& ident = stackFrame.args[1].identifier();
 
     JSValue baseValue = stackFrame.args[0].jsValue();
+    MegamorphicCache& megamorphicCache = stackFrame.globalData->megamorphicCache;
+    JSValue result;
+    if (megamorphicCache.get(baseValue, ident, result))
+        return JSValue::encode(result);
+
     PropertySlot slot(baseValue);
-    JSValue result = baseValue.get(callFrame, ident, slot);
+    result = baseValue.get(callFrame, ident, slot);
+    megamorphicCache.add(baseValue, ident, slot);
 
     CHECK_FOR_EXCEPTION_AT_END();
     return JSValue::encode(result);
@@ -1351,15 +1405,77 @@ DEFINE_STUB_FUNCTION(void, op_put_by_id)
     CHECK_FOR_EXCEPTION_AT_END();
 }
 
-DEFINE_STUB_FUNCTION(void, op_put_by_id_fail)
+static PolymorphicPutByIdStructureList* getPolymorphicPutByIdStructureListSlot(StructureStubInfo* stubInfo, int& listIndex)
+{
+    PolymorphicPutByIdStructureList* polymorphicStructureList = 0;
+    listIndex = 1;
+
+    switch (stubInfo->accessType) {
+    case access_put_by_id_replace:
+        // The replace is done in the hot path, so it has no stub of its own.
+        polymorphicStructureList = new PolymorphicPutByIdStructureList(CodeLocationLabel(), stubInfo->u.putByIdReplace.baseObjectStructure);
+        stubInfo->initPutByIdList(polymorphicStructureList, 2);
+        break;
+    case access_put_by_id_transition:
+        polymorphicStructureList = new PolymorphicPutByIdStructureList(stubInfo->stubRoutine, stubInfo->u.putByIdTransition.previousStructure, stubInfo->u.putByIdTransition.structure, stubInfo->u.putByIdTransition.chain);
+        stubInfo->stubRoutine = CodeLocationLabel();
+        stubInfo->initPutByIdList(polymorphicStructureList, 2);
+        break;
+    case access_put_by_id_list:
+        polymorphicStructureList = stubInfo->u.putByIdList.structureList;
+        listIndex = stubInfo->u.putByIdList.listSize;
+        stubInfo->u.putByIdList.listSize++;
+        break;
+    default:
+        ASSERT_NOT_REACHED();
+    }
+
+    ASSERT(listIndex < POLYMORPHIC_LIST_CACHE_SIZE);
+    return polymorphicStructureList;
+}
+
+// Reached when none of the cases cached for a put_by_id match; caches this one too, until the list is full.
+DEFINE_STUB_FUNCTION(void, op_put_by_id_list)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
 
     CallFrame* callFrame = stackFrame.callFrame;
     Identifier& ident = stackFrame.args[1].identifier();
 
+    JSValue baseValue = stackFrame.args[0].jsValue();
     PutPropertySlot slot;
-    stackFrame.args[0].jsValue().put(callFrame, ident, stackFrame.args[2].jsValue(), slot);
+    baseValue.put(callFrame, ident, stackFrame.args[2].jsValue(), slot);
+
+    CodeBlock* codeBlock = callFrame->codeBlock();
+    StructureStubInfo* stubInfo = &codeBlock->getStubInfo(STUB_RETURN_ADDRESS);
+
+    // Relinking to cti_op_put_by_id_generic would cut the cached cases off, so a full list
+    // just stops growing.
+    bool listIsFull = stubInfo->accessType == access_put_by_id_list && stubInfo->u.putByIdList.listSize == POLYMORPHIC_LIST_CACHE_SIZE;
+
+    if (!listIsFull
+        && baseValue.isCell()
+        && slot.isCacheable()
+        && !asCell(baseValue)->structure()->isUncacheableDictionary()
+        && slot.base() == baseValue) {
+
+        JSCell* baseCell = asCell(baseValue);
+        Structure* structure = baseCell->structure();
+
+        if (slot.type() != PutPropertySlot::NewProperty) {
+            int listIndex;
+            PolymorphicPutByIdStructureList* polymorphicStructureList = getPolymorphicPutByIdStructureListSlot(stubInfo, listIndex);
+            JIT::compilePutByIdReplaceList(callFrame->scopeChain()->globalData, codeBlock, stubInfo, polymorphicStructureList, listIndex, structure, slot.cachedOffset(), STUB_RETURN_ADDRESS);
+        } else if (!structure->isDictionary()) {
+            // put_by_id_transition checks the prototype chain for setters.
+            normalizePrototypeChain(callFrame, baseCell);
+
+            int listIndex;
+            PolymorphicPutByIdStructureList* polymorphicStructureList = getPolymorphicPutByIdStructureListSlot(stubInfo, listIndex);
+            StructureChain* prototypeChain = structure->prototypeChain(callFrame);
+            JIT::compilePutByIdTransitionList(callFrame->scopeChain()->globalData, codeBlock, stubInfo, polymorphicStructureList, listIndex, structure->previousID(), structure, slot.cachedOffset(), prototypeChain, STUB_RETURN_ADDRESS);
+        }
+    }
 
     CHECK_FOR_EXCEPTION_AT_END();
 }
@@ -1643,9 +1759,17 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_proto_list_full)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
 
+    const Identifier& ident = stackFrame.args[1].identifier();
+
     JSValue baseValue = stackFrame.args[0].jsValue();
+    MegamorphicCache& megamorphicCache = stackFrame.globalData->megamorphicCache;
+    JSValue result;
+    if (megamorphicCache.get(baseValue, ident, result))
+        return JSValue::encode(result);
+
     PropertySlot slot(baseValue);
-    JSValue result = baseValue.get(stackFrame.callFrame, stackFrame.args[1].identifier(), slot);
+    result = baseValue.get(stackFrame.callFrame, ident, slot);
+    megamorphicCache.add(baseValue, ident, slot);
 
     CHECK_FOR_EXCEPTION_AT_END();
     return JSValue::encode(result);
@@ -1945,7 +2069,7 @@ DEFINE_STUB_FUNCTION(void, op_tear_off_arguments)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
 
-    ASSERT(stackFrame.callFrame->codeBlock()->usesArguments() && !stackFrame.callFrame->codeBlock()->needsFullScopeChain());
+    ASSERT(stackFrame.callFrame->codeBlock()->usesArguments());
     if (stackFrame.callFrame->optionalCalleeArguments())
         stackFrame.callFrame->optionalCalleeArguments()->copyRegisters();
 }
@@ -2108,6 +2232,43 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_val)
     CHECK_FOR_EXCEPTION_AT_END();
     return JSValue::encode(result);
 }
+
+DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_argument_by_val)
+{
+    STUB_INIT_STACK_FRAME(stackFrame);
+
+    CallFrame* callFrame = stackFrame.callFrame;
+
+    int argumentsRegister = stackFrame.args[0].int32();
+    JSValue subscript = stackFrame.args[1].jsValue();
+    JSValue baseValue = callFrame->registers()[argumentsRegister].jsValue();
+
+    if (!baseValue) {
+        if (subscript.isUInt32() && subscript.asUInt32() < static_cast<uint32_t>(callFrame->argumentCount() - 1))
+            return JSValue::encode(Arguments::argumentFromCallFrame(callFrame, subscript.asUInt32()));
+
+        ASSERT(argumentsRegister == RegisterFile::ArgumentsRegister);
+        Arguments* arguments;
+        if (callFrame->codeBlock()->m_numParameters == 1)
+            arguments = new (stackFrame.globalData) Arguments(callFrame, Arguments::NoParameters);
+        else
+            arguments = new (stackFrame.globalData) Arguments(callFrame);
+        callFrame->setCalleeArguments(arguments);
+        callFrame[RegisterFile::ArgumentsRegister] = JSValue(arguments);
+        baseValue = arguments;
+    }
+
+    JSValue result;
+    if (subscript.isUInt32())
+        result = baseValue.get(callFrame, subscript.asUInt32());
+    else {
+        Identifier property(callFrame, subscript.toString(callFrame));
+        result = baseValue.get(callFrame, property);
+    }
+
+    CHECK_FOR_EXCEPTION_AT_END();
+    return JSValue::encode(result);
+}
     
 DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_val_string)
 {
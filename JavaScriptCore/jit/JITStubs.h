@@ -29,6 +29,7 @@
 #ifndef JITStubs_h
 #define JITStubs_h
 
+#include "CallData.h"
 #include "MacroAssemblerCodeRef.h"
 #include "Register.h"
 
@@ -73,12 +74,31 @@ namespace JSC {
         ReturnAddressPtr returnAddress() { return ReturnAddressPtr(asPointer); }
     };
     
+#if ENABLE(JIT_INTRINSICS)
+    // Host functions whose thunk handles their common cases inline, falling
+    // back to ctiNativeCallThunk for the rest.
+    enum Intrinsic {
+        MathAbsIntrinsic,
+        MathFloorIntrinsic,
+        MathMaxIntrinsic,
+        MathMinIntrinsic,
+        MathSqrtIntrinsic,
+        StringCharAtIntrinsic,
+        StringCharCodeAtIntrinsic,
+        ArrayPushIntrinsic,
+        NumberOfIntrinsics
+    };
+#endif
+
     struct TrampolineStructure {
         MacroAssemblerCodePtr ctiStringLengthTrampoline;
         MacroAssemblerCodePtr ctiVirtualCallLink;
         MacroAssemblerCodePtr ctiVirtualCall;
         MacroAssemblerCodePtr ctiNativeCallThunk;
         MacroAssemblerCodePtr ctiSoftModulo;
+#if ENABLE(JIT_INTRINSICS)
+        MacroAssemblerCodePtr ctiIntrinsicThunks[NumberOfIntrinsics];
+#endif
     };
 
 #if CPU(X86_64)
@@ -275,6 +295,9 @@ namespace JSC {
         MacroAssemblerCodePtr ctiNativeCallThunk() { return m_trampolineStructure.ctiNativeCallThunk; }
         MacroAssemblerCodePtr ctiSoftModulo() { return m_trampolineStructure.ctiSoftModulo; }
 
+        // The code a NativeExecutable for the given function should run.
+        MacroAssemblerCodePtr hostFunctionStub(NativeFunction);
+
     private:
         RefPtr<ExecutablePool> m_executablePool;
 
@@ -294,6 +317,7 @@ extern "C" {
     EncodedJSValue JIT_STUB cti_op_del_by_id(STUB_ARGS_DECLARATION);
     EncodedJSValue JIT_STUB cti_op_del_by_val(STUB_ARGS_DECLARATION);
     EncodedJSValue JIT_STUB cti_op_div(STUB_ARGS_DECLARATION);
+    EncodedJSValue JIT_STUB cti_op_get_argument_by_val(STUB_ARGS_DECLARATION);
     EncodedJSValue JIT_STUB cti_op_get_by_id(STUB_ARGS_DECLARATION);
     EncodedJSValue JIT_STUB cti_op_get_by_id_array_fail(STUB_ARGS_DECLARATION);
     EncodedJSValue JIT_STUB cti_op_get_by_id_generic(STUB_ARGS_DECLARATION);
@@ -375,8 +399,8 @@ extern "C" {
     void JIT_STUB cti_op_profile_did_call(STUB_ARGS_DECLARATION);
     void JIT_STUB cti_op_profile_will_call(STUB_ARGS_DECLARATION);
     void JIT_STUB cti_op_put_by_id(STUB_ARGS_DECLARATION);
-    void JIT_STUB cti_op_put_by_id_fail(STUB_ARGS_DECLARATION);
     void JIT_STUB cti_op_put_by_id_generic(STUB_ARGS_DECLARATION);
+    void JIT_STUB cti_op_put_by_id_list(STUB_ARGS_DECLARATION);
     void JIT_STUB cti_op_put_by_index(STUB_ARGS_DECLARATION);
     void JIT_STUB cti_op_put_by_val(STUB_ARGS_DECLARATION);
     void JIT_STUB cti_op_put_by_val_byte_array(STUB_ARGS_DECLARATION);
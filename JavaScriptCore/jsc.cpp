@@ -22,6 +22,7 @@
 
 #include "config.h"
 
+#include "BytecodeCache.h"
 #include "BytecodeGenerator.h"
 #include "Completion.h"
 #include "CurrentTime.h"
@@ -31,6 +32,7 @@
 #include "JSLock.h"
 #include "JSString.h"
 #include "PrototypeFunction.h"
+#include "SamplingProfiler.h"
 #include "SamplingTool.h"
 #include <math.h>
 #include <stdio.h>
@@ -79,6 +81,8 @@ static JSValue JSC_HOST_CALL functionRun(ExecState*, JSObject*, JSValue, const A
 static JSValue JSC_HOST_CALL functionLoad(ExecState*, JSObject*, JSValue, const ArgList&);
 static JSValue JSC_HOST_CALL functionCheckSyntax(ExecState*, JSObject*, JSValue, const ArgList&);
 static JSValue JSC_HOST_CALL functionReadline(ExecState*, JSObject*, JSValue, const ArgList&);
+static JSValue JSC_HOST_CALL functionRegExpCacheStatistics(ExecState*, JSObject*, JSValue, const ArgList&);
+static JSValue JSC_HOST_CALL functionBytecodeCacheStatistics(ExecState*, JSObject*, JSValue, const ArgList&);
 static NO_RETURN_WITH_VALUE JSValue JSC_HOST_CALL functionQuit(ExecState*, JSObject*, JSValue, const ArgList&);
 
 #if ENABLE(SAMPLING_FLAGS)
@@ -101,11 +105,15 @@ struct Options {
     Options()
         : interactive(false)
         , dump(false)
+        , bytecodeCachePath(0)
+        , samplingProfilePath(0)
     {
     }
 
     bool interactive;
     bool dump;
+    const char* bytecodeCachePath;
+    const char* samplingProfilePath;
     Vector<Script> scripts;
     Vector<UString> arguments;
 };
@@ -159,6 +167,8 @@ GlobalObject::GlobalObject(const Vector<UString>& arguments)
     putDirectFunction(globalExec(), new (globalExec()) NativeFunctionWrapper(globalExec(), prototypeFunctionStructure(), 1, Identifier(globalExec(), "load"), functionLoad));
     putDirectFunction(globalExec(), new (globalExec()) NativeFunctionWrapper(globalExec(), prototypeFunctionStructure(), 1, Identifier(globalExec(), "checkSyntax"), functionCheckSyntax));
     putDirectFunction(globalExec(), new (globalExec()) NativeFunctionWrapper(globalExec(), prototypeFunctionStructure(), 0, Identifier(globalExec(), "readline"), functionReadline));
+    putDirectFunction(globalExec(), new (globalExec()) NativeFunctionWrapper(globalExec(), prototypeFunctionStructure(), 0, Identifier(globalExec(), "regExpCacheStatistics"), functionRegExpCacheStatistics));
+    putDirectFunction(globalExec(), new (globalExec()) NativeFunctionWrapper(globalExec(), prototypeFunctionStructure(), 0, Identifier(globalExec(), "bytecodeCacheStatistics"), functionBytecodeCacheStatistics));
 
 #if ENABLE(SAMPLING_FLAGS)
     putDirectFunction(globalExec(), new (globalExec()) NativeFunctionWrapper(globalExec(), prototypeFunctionStructure(), 1, Identifier(globalExec(), "setSamplingFlags"), functionSetSamplingFlags));
@@ -290,6 +300,30 @@ JSValue JSC_HOST_CALL functionReadline(ExecState* exec, JSObject*, JSValue, cons
     return jsString(exec, line.data());
 }
 
+JSValue JSC_HOST_CALL functionRegExpCacheStatistics(ExecState* exec, JSObject*, JSValue, const ArgList&)
+{
+    RegExpCache& cache = exec->globalData().regExpCache;
+    JSObject* statistics = constructEmptyObject(exec);
+    statistics->putDirect(Identifier(exec, "hits"), jsNumber(exec, cache.hits()));
+    statistics->putDirect(Identifier(exec, "misses"), jsNumber(exec, cache.misses()));
+    statistics->putDirect(Identifier(exec, "size"), jsNumber(exec, cache.size()));
+    statistics->putDirect(Identifier(exec, "maxEntries"), jsNumber(exec, cache.maxEntries()));
+    return statistics;
+}
+
+// Returns null unless a bytecode cache was given with -b.
+JSValue JSC_HOST_CALL functionBytecodeCacheStatistics(ExecState* exec, JSObject*, JSValue, const ArgList&)
+{
+    BytecodeCache* cache = exec->globalData().bytecodeCache.get();
+    if (!cache)
+        return jsNull();
+    JSObject* statistics = constructEmptyObject(exec);
+    statistics->putDirect(Identifier(exec, "hits"), jsNumber(exec, cache->hits()));
+    statistics->putDirect(Identifier(exec, "misses"), jsNumber(exec, cache->misses()));
+    statistics->putDirect(Identifier(exec, "size"), jsNumber(exec, cache->size()));
+    return statistics;
+}
+
 JSValue JSC_HOST_CALL functionQuit(ExecState* exec, JSObject*, JSValue, const ArgList&)
 {
     // Technically, destroying the heap in the middle of JS execution is a no-no,
@@ -455,11 +489,16 @@ static void runInteractive(GlobalObject* globalObject)
 static NO_RETURN void printUsageStatement(JSGlobalData* globalData, bool help = false)
 {
     fprintf(stderr, "Usage: jsc [options] [files] [-- arguments]\n");
+    fprintf(stderr, "  -b file    Reuses function bytecode saved in file, and saves it there on exit\n");
     fprintf(stderr, "  -d         Dumps bytecode (debug builds only)\n");
     fprintf(stderr, "  -e         Evaluate argument as script code\n");
     fprintf(stderr, "  -f         Specifies a source file (deprecated)\n");
+    fprintf(stderr, "  -g         Uses generational (nursery) garbage collection\n");
     fprintf(stderr, "  -h|--help  Prints this help message\n");
     fprintf(stderr, "  -i         Enables interactive mode (default if no files are specified)\n");
+#if ENABLE(SAMPLING_PROFILER)
+    fprintf(stderr, "  -p file    Samples the JavaScript stack, and writes it to file as collapsed stacks on exit\n");
+#endif
 #if HAVE(SIGNAL_H)
     fprintf(stderr, "  -s         Installs signal handlers that exit on a crash (Unix platforms only)\n");
 #endif
@@ -485,14 +524,32 @@ static void parseArguments(int argc, char** argv, Options& options, JSGlobalData
             options.scripts.append(Script(false, argv[i]));
             continue;
         }
+        if (!strcmp(arg, "-b")) {
+            if (++i == argc)
+                printUsageStatement(globalData);
+            options.bytecodeCachePath = argv[i];
+            continue;
+        }
         if (!strcmp(arg, "-i")) {
             options.interactive = true;
             continue;
         }
+#if ENABLE(SAMPLING_PROFILER)
+        if (!strcmp(arg, "-p")) {
+            if (++i == argc)
+                printUsageStatement(globalData);
+            options.samplingProfilePath = argv[i];
+            continue;
+        }
+#endif
         if (!strcmp(arg, "-d")) {
             options.dump = true;
             continue;
         }
+        if (!strcmp(arg, "-g")) {
+            globalData->heap.setCollectorMode(GenerationalCollectorMode);
+            continue;
+        }
         if (!strcmp(arg, "-s")) {
 #if HAVE(SIGNAL_H)
             signal(SIGILL, _exit);
@@ -525,11 +582,38 @@ int jscmain(int argc, char** argv, JSGlobalData* globalData)
     Options options;
     parseArguments(argc, argv, options, globalData);
 
+    if (options.bytecodeCachePath) {
+        globalData->bytecodeCache.set(new BytecodeCache);
+        globalData->bytecodeCache->load(options.bytecodeCachePath);
+    }
+
+#if ENABLE(SAMPLING_PROFILER)
+    if (options.samplingProfilePath) {
+        globalData->samplingProfiler.set(new SamplingProfiler(globalData));
+        globalData->samplingProfiler->start(0, SamplingProfiler::defaultSamplesPerSecond);
+    }
+#endif
+
     GlobalObject* globalObject = new (globalData) GlobalObject(options.arguments);
     bool success = runWithScripts(globalObject, options.scripts, options.dump);
     if (options.interactive && success)
         runInteractive(globalObject);
 
+    if (options.bytecodeCachePath && !globalData->bytecodeCache->save(options.bytecodeCachePath))
+        fprintf(stderr, "Could not save bytecode cache: %s\n", options.bytecodeCachePath);
+
+#if ENABLE(SAMPLING_PROFILER)
+    if (options.samplingProfilePath) {
+        globalData->samplingProfiler->stop();
+        CString stacks = globalData->samplingProfiler->collapsedStacks().UTF8String();
+        FILE* file = fopen(options.samplingProfilePath, "w");
+        if (!file || fwrite(stacks.data(), 1, stacks.length(), file) != stacks.length())
+            fprintf(stderr, "Could not write sampling profile: %s\n", options.samplingProfilePath);
+        if (file)
+            fclose(file);
+    }
+#endif
+
     return success ? 0 : 3;
 }
 
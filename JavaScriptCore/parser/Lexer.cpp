@@ -33,6 +33,10 @@
 #include <string.h>
 #include <wtf/Assertions.h>
 
+#if CPU(X86_SSE2)
+#include <emmintrin.h>
+#endif
+
 using namespace WTF;
 using namespace Unicode;
 
@@ -47,6 +51,9 @@ namespace JSC {
 
 static const UChar byteOrderMark = 0xFEFF;
 
+// Any integer with this many decimal digits is exactly representable as a double.
+static const size_t maximumDigitsForExactInteger = 15;
+
 Lexer::Lexer(JSGlobalData* globalData)
     : m_isReparsing(false)
     , m_globalData(globalData)
@@ -132,6 +139,14 @@ ALWAYS_INLINE void Lexer::shift4()
     m_code += 4;
 }
 
+ALWAYS_INLINE void Lexer::shiftTo(const UChar* position)
+{
+    ASSERT(position >= currentCharacter());
+    ASSERT(position <= m_codeEnd);
+    m_code = position;
+    shift4();
+}
+
 void Lexer::setCode(const SourceCode& source, ParserArena& arena)
 {
     m_arena = &arena.identifierArena();
@@ -139,6 +154,9 @@ void Lexer::setCode(const SourceCode& source, ParserArena& arena)
     m_lineNumber = source.firstLine();
     m_delimited = false;
     m_lastToken = -1;
+    m_braceDepth = 0;
+    m_skippedFunctionBodyDepth = -1;
+    m_functionBodyIsNext = false;
 
     const UChar* data = source.provider()->data();
 
@@ -202,6 +220,18 @@ ALWAYS_INLINE const Identifier* Lexer::makeIdentifier(const UChar* characters, s
     return &m_arena->makeIdentifier(m_globalData, characters, length);
 }
 
+ALWAYS_INLINE const Identifier* Lexer::makeSkippedIdentifier(const UChar* characters, size_t length)
+{
+    // Getter and setter definitions are the only place the syntax check looks at an identifier.
+    if (length == 3 && characters[1] == 'e' && characters[2] == 't') {
+        if (characters[0] == 'g')
+            return &m_globalData->propertyNames->get;
+        if (characters[0] == 's')
+            return &m_globalData->propertyNames->set;
+    }
+    return &m_globalData->propertyNames->nullIdentifier;
+}
+
 inline bool Lexer::lastTokenWasRestrKeyword() const
 {
     return m_lastToken == CONTINUE || m_lastToken == BREAK || m_lastToken == RETURN || m_lastToken == THROW;
@@ -248,6 +278,138 @@ static inline int singleEscape(int c)
     }
 }
 
+// The skip functions below find the end of a run of characters that the lexer
+// can pass over without looking at them one by one, so the run costs a single
+// shiftTo() instead of a shift1() per character. Each returns a position at or
+// before the first character that ends the run; the character-at-a-time loops
+// in lex() carry on from there, so a skip function may stop early whenever the
+// fast check is inconclusive.
+
+#if CPU(X86_SSE2)
+
+static const int charactersPerChunk = sizeof(__m128i) / sizeof(UChar);
+
+static ALWAYS_INLINE __m128i loadChunk(const UChar* p)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+static ALWAYS_INLINE __m128i charactersEqual(__m128i chunk, UChar c)
+{
+    return _mm_cmpeq_epi16(chunk, _mm_set1_epi16(c));
+}
+
+static ALWAYS_INLINE __m128i charactersInRange(__m128i chunk, UChar low, UChar high)
+{
+    // c - low <= high - low as unsigned 16-bit values: the saturating subtract is
+    // zero exactly when it holds.
+    __m128i offset = _mm_sub_epi16(chunk, _mm_set1_epi16(low));
+    return _mm_cmpeq_epi16(_mm_subs_epu16(offset, _mm_set1_epi16(high - low)), _mm_setzero_si128());
+}
+
+// Returns the first character of the chunk at p that is not in the run, or 0
+// if they all are.
+static ALWAYS_INLINE const UChar* endOfRunInChunk(const UChar* p, __m128i inRun)
+{
+    unsigned outOfRun = ~_mm_movemask_epi8(inRun) & 0xFFFF;
+    if (!outOfRun)
+        return 0;
+#if COMPILER(MSVC)
+    unsigned long index;
+    _BitScanForward(&index, outOfRun);
+#else
+    unsigned index = __builtin_ctz(outOfRun);
+#endif
+    return p + index / sizeof(UChar);
+}
+
+#endif
+
+static inline const UChar* skipIdentifierPart(const UChar* p, const UChar* end)
+{
+#if CPU(X86_SSE2)
+    for (; end - p >= charactersPerChunk; p += charactersPerChunk) {
+        __m128i chunk = loadChunk(p);
+        // Setting the 0x20 bit maps A-Z onto a-z and nothing else onto a-z.
+        __m128i letters = charactersInRange(_mm_or_si128(chunk, _mm_set1_epi16(0x20)), 'a', 'z');
+        __m128i others = _mm_or_si128(charactersInRange(chunk, '0', '9'), _mm_or_si128(charactersEqual(chunk, '$'), charactersEqual(chunk, '_')));
+        if (const UChar* endOfRun = endOfRunInChunk(p, _mm_or_si128(letters, others)))
+            return endOfRun;
+    }
+#endif
+    while (p < end && (isASCIIAlphanumeric(*p) || *p == '$' || *p == '_'))
+        ++p;
+    return p;
+}
+
+static inline const UChar* skipSpacesAndTabs(const UChar* p, const UChar* end)
+{
+#if CPU(X86_SSE2)
+    for (; end - p >= charactersPerChunk; p += charactersPerChunk) {
+        __m128i chunk = loadChunk(p);
+        if (const UChar* endOfRun = endOfRunInChunk(p, _mm_or_si128(charactersEqual(chunk, ' '), charactersEqual(chunk, '\t'))))
+            return endOfRun;
+    }
+#endif
+    while (p < end && (*p == ' ' || *p == '\t'))
+        ++p;
+    return p;
+}
+
+// Stops at the quote, a backslash, line terminators and anything else that the
+// string literal loop in lex() treats specially.
+static inline const UChar* skipPlainStringCharacters(const UChar* p, const UChar* end, UChar quote)
+{
+#if CPU(X86_SSE2)
+    for (; end - p >= charactersPerChunk; p += charactersPerChunk) {
+        __m128i chunk = loadChunk(p);
+        __m128i special = _mm_or_si128(charactersEqual(chunk, quote), charactersEqual(chunk, '\\'));
+        __m128i plain = _mm_andnot_si128(special, charactersInRange(chunk, 0xE, 0x200D));
+        if (const UChar* endOfRun = endOfRunInChunk(p, plain))
+            return endOfRun;
+    }
+#endif
+    while (p < end && *p != quote && *p != '\\' && !((static_cast<unsigned>(*p) - 0xE) & 0x2000))
+        ++p;
+    return p;
+}
+
+#if CPU(X86_SSE2)
+static ALWAYS_INLINE __m128i lineTerminators(__m128i chunk)
+{
+    __m128i crOrLF = _mm_or_si128(charactersEqual(chunk, '\n'), charactersEqual(chunk, '\r'));
+    return _mm_or_si128(crOrLF, charactersEqual(_mm_and_si128(chunk, _mm_set1_epi16(~1)), 0x2028));
+}
+#endif
+
+static inline const UChar* skipSingleLineCommentCharacters(const UChar* p, const UChar* end)
+{
+#if CPU(X86_SSE2)
+    for (; end - p >= charactersPerChunk; p += charactersPerChunk) {
+        if (const UChar* endOfRun = endOfRunInChunk(p, _mm_xor_si128(lineTerminators(loadChunk(p)), _mm_set1_epi16(-1))))
+            return endOfRun;
+    }
+#endif
+    while (p < end && !Lexer::isLineTerminator(*p))
+        ++p;
+    return p;
+}
+
+static inline const UChar* skipMultiLineCommentCharacters(const UChar* p, const UChar* end)
+{
+#if CPU(X86_SSE2)
+    for (; end - p >= charactersPerChunk; p += charactersPerChunk) {
+        __m128i chunk = loadChunk(p);
+        __m128i special = _mm_or_si128(lineTerminators(chunk), charactersEqual(chunk, '*'));
+        if (const UChar* endOfRun = endOfRunInChunk(p, _mm_xor_si128(special, _mm_set1_epi16(-1))))
+            return endOfRun;
+    }
+#endif
+    while (p < end && *p != '*' && !Lexer::isLineTerminator(*p))
+        ++p;
+    return p;
+}
+
 inline void Lexer::record8(int c)
 {
     ASSERT(c >= 0);
@@ -276,11 +438,17 @@ int Lexer::lex(void* p1, void* p2)
     YYSTYPE* lvalp = static_cast<YYSTYPE*>(p1);
     YYLTYPE* llocp = static_cast<YYLTYPE*>(p2);
     int token = 0;
+    const HashEntry* keyword;
     m_terminator = false;
 
 start:
-    while (isWhiteSpace(m_current))
+    while (isWhiteSpace(m_current)) {
+        if (m_next1 == ' ' || m_next1 == '\t') {
+            shiftTo(skipSpacesAndTabs(currentCharacter() + 2, m_codeEnd));
+            continue;
+        }
         shift1();
+    }
 
     int startOffset = currentOffset();
 
@@ -514,11 +682,19 @@ start:
         case '{':
             lvalp->intValue = currentOffset();
             shift1();
+            if (m_functionBodyIsNext) {
+                if (!isSkippingFunctionBody())
+                    m_skippedFunctionBodyDepth = m_braceDepth;
+                m_functionBodyIsNext = false;
+            }
+            ++m_braceDepth;
             token = OPENBRACE;
             break;
         case '}':
             lvalp->intValue = currentOffset();
             shift1();
+            if (--m_braceDepth == m_skippedFunctionBodyDepth)
+                m_skippedFunctionBodyDepth = -1;
             m_delimited = true;
             token = CLOSEBRACE;
             break;
@@ -563,6 +739,7 @@ startString: {
     shift1();
 
     const UChar* stringStart = currentCharacter();
+    shiftTo(skipPlainStringCharacters(stringStart, m_codeEnd, stringQuoteCharacter));
     while (m_current != stringQuoteCharacter) {
         // Fast check for characters that require special handling.
         // Catches -1, \n, \r, \, 0x2028, and 0x2029 as efficiently
@@ -573,7 +750,7 @@ startString: {
         }
         shift1();
     }
-    lvalp->ident = makeIdentifier(stringStart, currentCharacter() - stringStart);
+    lvalp->ident = isSkippingFunctionBody() ? &m_globalData->propertyNames->nullIdentifier : makeIdentifier(stringStart, currentCharacter() - stringStart);
     shift1();
     m_atLineStart = false;
     m_delimited = false;
@@ -660,11 +837,18 @@ startIdentifierWithBackslash:
 
 startIdentifierOrKeyword: {
     const UChar* identifierStart = currentCharacter();
-    shift1();
+    shiftTo(skipIdentifierPart(identifierStart + 1, m_codeEnd));
     while (isIdentPart(m_current))
         shift1();
     if (LIKELY(m_current != '\\')) {
-        lvalp->ident = makeIdentifier(identifierStart, currentCharacter() - identifierStart);
+        size_t length = currentCharacter() - identifierStart;
+        if (isSkippingFunctionBody()) {
+            lvalp->ident = makeSkippedIdentifier(identifierStart, length);
+            keyword = m_keywordTable.entry(m_globalData, identifierStart, length);
+        } else {
+            lvalp->ident = makeIdentifier(identifierStart, length);
+            keyword = m_keywordTable.entry(m_globalData, *lvalp->ident);
+        }
         goto doneIdentifierOrKeyword;
     }
     m_buffer16.append(identifierStart, currentCharacter() - identifierStart);
@@ -692,6 +876,7 @@ inIdentifierAfterCharacterCheck:
     goto doneIdentifier;
 
 inSingleLineComment:
+    shiftTo(skipSingleLineCommentCharacters(currentCharacter(), m_codeEnd));
     while (!isLineTerminator(m_current)) {
         if (UNLIKELY(m_current == -1))
             return 0;
@@ -706,6 +891,7 @@ inSingleLineComment:
 
 inMultiLineComment:
     shift2();
+    shiftTo(skipMultiLineCommentCharacters(currentCharacter(), m_codeEnd));
     while (m_current != '*' || m_next1 != '/') {
         if (isLineTerminator(m_current))
             shiftLineTerminator();
@@ -714,6 +900,7 @@ inMultiLineComment:
             if (UNLIKELY(m_current == -1))
                 goto returnError;
         }
+        shiftTo(skipMultiLineCommentCharacters(currentCharacter(), m_codeEnd));
     }
     shift2();
     m_atLineStart = false;
@@ -833,6 +1020,19 @@ startNumber:
         goto inExponentIndicator;
     }
 
+    // Short integer literals are common enough to skip strtod.
+    if (m_buffer8.size() <= maximumDigitsForExactInteger) {
+        double dval = 0;
+        const char* end = m_buffer8.end();
+        for (const char* p = m_buffer8.data(); p < end; ++p)
+            dval = dval * 10 + (*p - '0');
+
+        m_buffer8.resize(0);
+
+        lvalp->doubleValue = dval;
+        goto doneNumeric;
+    }
+
     // Fall through into doneNumber.
 
 doneNumber:
@@ -861,26 +1061,27 @@ doneSemicolon:
 doneIdentifier:
     m_atLineStart = false;
     m_delimited = false;
-    lvalp->ident = makeIdentifier(m_buffer16.data(), m_buffer16.size());
+    lvalp->ident = isSkippingFunctionBody() ? makeSkippedIdentifier(m_buffer16.data(), m_buffer16.size()) : makeIdentifier(m_buffer16.data(), m_buffer16.size());
     m_buffer16.resize(0);
     token = IDENT;
     goto returnToken;
 
-doneIdentifierOrKeyword: {
+doneIdentifierOrKeyword:
     m_atLineStart = false;
     m_delimited = false;
     m_buffer16.resize(0);
-    const HashEntry* entry = m_keywordTable.entry(m_globalData, *lvalp->ident);
-    token = entry ? entry->lexerValue() : IDENT;
+    token = keyword ? keyword->lexerValue() : IDENT;
+    if (token == FUNCTION)
+        m_functionBodyIsNext = true;
     goto returnToken;
-}
+
 
 doneString:
     // Atomize constant strings in case they're later used in property lookup.
     shift1();
     m_atLineStart = false;
     m_delimited = false;
-    lvalp->ident = makeIdentifier(m_buffer16.data(), m_buffer16.size());
+    lvalp->ident = isSkippingFunctionBody() ? &m_globalData->propertyNames->nullIdentifier : makeIdentifier(m_buffer16.data(), m_buffer16.size());
     m_buffer16.resize(0);
     token = STRING;
 
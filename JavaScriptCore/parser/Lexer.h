@@ -68,6 +68,7 @@ namespace JSC {
         void shift2();
         void shift3();
         void shift4();
+        void shiftTo(const UChar*);
         void shiftLineTerminator();
 
         void record8(int);
@@ -80,6 +81,9 @@ namespace JSC {
         const UChar* currentCharacter() const;
 
         const Identifier* makeIdentifier(const UChar* characters, size_t length);
+        const Identifier* makeSkippedIdentifier(const UChar* characters, size_t length);
+
+        bool isSkippingFunctionBody() const { return m_skippedFunctionBodyDepth >= 0; }
 
         bool lastTokenWasRestrKeyword() const;
 
@@ -93,6 +97,15 @@ namespace JSC {
         bool m_delimited; // encountered delimiter like "'" and "}" on last run
         int m_lastToken;
 
+        // The parser only checks the syntax of nested function bodies; they are
+        // parsed again when first called. Tokens inside them therefore carry
+        // no identifier or string values, which spares the identifier table
+        // and the arena. The brace depth at which the outermost such body
+        // opened is m_skippedFunctionBodyDepth, or -1 outside one.
+        int m_braceDepth;
+        int m_skippedFunctionBodyDepth;
+        bool m_functionBodyIsNext;
+
         const SourceCode* m_source;
         const UChar* m_code;
         const UChar* m_codeStart;
@@ -1399,6 +1399,7 @@ namespace JSC {
         bool usesArguments() const { return m_features & ArgumentsFeature; }
         void setUsesArguments() { m_features |= ArgumentsFeature; }
         bool usesThis() const { return m_features & ThisFeature; }
+        bool containsClosures() const { return m_features & ClosureFeature; }
         bool needsActivation() const { return m_features & (EvalFeature | ClosureFeature | WithFeature | CatchFeature); }
 
         VarStack& varStack() { ASSERT(m_data); return m_data->m_varStack; }
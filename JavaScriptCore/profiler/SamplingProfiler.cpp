@@ -0,0 +1,701 @@
+/*
+ * Copyright (C) 2010 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "SamplingProfiler.h"
+
+#if ENABLE(SAMPLING_PROFILER)
+
+#include "CallFrame.h"
+#include "CodeBlock.h"
+#include "CollectorHeapIterator.h"
+#include "Executable.h"
+#include "Interpreter.h"
+#include "JSFunction.h"
+#include "JSGlobalData.h"
+#include "JSString.h"
+#include "StringBuilder.h"
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+
+#if OS(DARWIN)
+#include <mach/mach.h>
+#include <mach/thread_act.h>
+#else
+#include <semaphore.h>
+#include <signal.h>
+#include <ucontext.h>
+#endif
+
+namespace JSC {
+
+// Enough for a few seconds of samples between two calls to processSamples().
+static const unsigned bufferCapacity = 1 << 16;
+static const unsigned bufferMask = bufferCapacity - 1;
+
+// Deeper stacks keep their innermost frames.
+static const unsigned maxStackDepth = 128;
+
+static inline void memoryBarrier()
+{
+#if COMPILER(GCC)
+    __sync_synchronize();
+#elif COMPILER(MSVC)
+    MemoryBarrier();
+#endif
+}
+
+// Code blocks are identified by a serial number as well as their address, so
+// that a sample of a code block that has since been destroyed cannot be
+// mistaken for a new code block allocated at the same address.
+typedef HashMap<CodeBlock*, unsigned> CodeBlockRegistry;
+
+// Code blocks are only registered while a profiler runs. Every thread that
+// compiles code then registers its code blocks, so the registry is split by
+// address, with a lock for each part. Threads running independent context
+// groups then seldom wait on one another.
+static const unsigned codeBlockRegistryStripeCount = 16;
+
+struct CodeBlockRegistryStripe {
+    CodeBlockRegistryStripe()
+        : lastSerial(0)
+    {
+    }
+
+    Mutex mutex;
+    CodeBlockRegistry codeBlocks;
+    unsigned lastSerial;
+};
+
+static CodeBlockRegistryStripe* codeBlockRegistryStripes;
+
+// Written with every stripe's mutex held. Code block creation and destruction
+// read it first without a lock, to skip the registry when nothing is sampling.
+static SamplingProfiler* volatile runningProfiler;
+
+// Locks the whole registry, always in the same order.
+class CodeBlockRegistryLocker : public Noncopyable {
+public:
+    CodeBlockRegistryLocker()
+    {
+        for (unsigned i = 0; i < codeBlockRegistryStripeCount; ++i)
+            codeBlockRegistryStripes[i].mutex.lock();
+    }
+
+    ~CodeBlockRegistryLocker()
+    {
+        for (unsigned i = codeBlockRegistryStripeCount; i; --i)
+            codeBlockRegistryStripes[i - 1].mutex.unlock();
+    }
+};
+
+static inline unsigned stripeIndexForCodeBlock(CodeBlock* codeBlock)
+{
+    return PtrHash<CodeBlock*>::hash(codeBlock) % codeBlockRegistryStripeCount;
+}
+
+// Returns 0 for anything that is not a live code block, including the values
+// the hash table reserves for itself. The whole registry must be locked.
+static inline unsigned serialForCodeBlock(CodeBlock* codeBlock)
+{
+    if (!codeBlock || codeBlock == reinterpret_cast<CodeBlock*>(-1))
+        return 0;
+    return codeBlockRegistryStripes[stripeIndexForCodeBlock(codeBlock)].codeBlocks.get(codeBlock);
+}
+
+// The stripe's mutex must be held. Registering a code block twice keeps its
+// first serial.
+static void registerCodeBlock(CodeBlock* codeBlock)
+{
+    // Each stripe hands out the serials congruent to its index, so serials are
+    // unique across stripes, and never 0.
+    unsigned index = stripeIndexForCodeBlock(codeBlock);
+    CodeBlockRegistryStripe& stripe = codeBlockRegistryStripes[index];
+    std::pair<CodeBlockRegistry::iterator, bool> result = stripe.codeBlocks.add(codeBlock, 0);
+    if (result.second)
+        result.first->second = ++stripe.lastSerial * codeBlockRegistryStripeCount + index;
+}
+
+// A sampled thread that exits without stopping its profiler must not be sent
+// any more signals, so it says so on its way out, from the destructor of a
+// thread-specific value. The value is the generation of the profiler run, in
+// case the thread outlives the run.
+static pthread_key_t sampledThreadKey;
+static Mutex* sampledThreadMutex;
+static uintptr_t sampledThreadGeneration;
+static bool sampledThreadHasExited;
+
+static void sampledThreadExiting(void* generation)
+{
+    MutexLocker locker(*sampledThreadMutex);
+    if (reinterpret_cast<uintptr_t>(generation) == sampledThreadGeneration)
+        sampledThreadHasExited = true;
+}
+
+void SamplingProfiler::initializeThreading()
+{
+    codeBlockRegistryStripes = new CodeBlockRegistryStripe[codeBlockRegistryStripeCount];
+    sampledThreadMutex = new Mutex;
+    pthread_key_create(&sampledThreadKey, sampledThreadExiting);
+}
+
+void SamplingProfiler::codeBlockCreated(CodeBlock* codeBlock)
+{
+    // The sampled thread's code blocks are created and destroyed by the thread
+    // that has its global data, as are profilers started and stopped, so none
+    // of them is missed by checking without the lock.
+    if (!runningProfiler)
+        return;
+    MutexLocker locker(codeBlockRegistryStripes[stripeIndexForCodeBlock(codeBlock)].mutex);
+    if (runningProfiler)
+        registerCodeBlock(codeBlock);
+}
+
+void SamplingProfiler::codeBlockDestroyed(CodeBlock* codeBlock)
+{
+    if (!runningProfiler)
+        return;
+    CodeBlockRegistryStripe& stripe = codeBlockRegistryStripes[stripeIndexForCodeBlock(codeBlock)];
+    MutexLocker locker(stripe.mutex);
+    stripe.codeBlocks.remove(codeBlock);
+}
+
+#if !OS(DARWIN)
+
+// Other POSIX systems have no call to suspend a thread, so the sampled thread
+// is sent a signal, and waits in its handler until the sample has been taken.
+static const int suspendSignal = SIGUSR2;
+
+// A thread that blocks the signal, or is not scheduled for a while, is given
+// up on. The request is withdrawn, so that the handler returns at once if it
+// runs later on.
+static const long suspendTimeoutInNanoseconds = 10 * 1000 * 1000;
+
+enum SuspendState { NoSuspendRequest, SuspendRequested, ThreadSuspended };
+static volatile int suspendState;
+
+static sem_t threadSuspended;
+static sem_t threadResumed;
+static void* volatile suspendedPC;
+static CallFrame* volatile suspendedCallFrame;
+
+static void suspendedThreadSignalHandler(int, siginfo_t*, void* context)
+{
+    if (!__sync_bool_compare_and_swap(&suspendState, SuspendRequested, ThreadSuspended))
+        return;
+
+    int savedErrno = errno;
+
+    mcontext_t& machineContext = static_cast<ucontext_t*>(context)->uc_mcontext;
+#if CPU(X86_64)
+    suspendedPC = reinterpret_cast<void*>(machineContext.gregs[REG_RIP]);
+    suspendedCallFrame = reinterpret_cast<CallFrame*>(machineContext.gregs[REG_R13]);
+#elif CPU(X86)
+    suspendedPC = reinterpret_cast<void*>(machineContext.gregs[REG_EIP]);
+    suspendedCallFrame = reinterpret_cast<CallFrame*>(machineContext.gregs[REG_EDI]);
+#else
+#error "The sampling profiler does not know the call frame register on this platform"
+#endif
+
+    sem_post(&threadSuspended);
+    while (sem_wait(&threadResumed) && errno == EINTR) { }
+
+    errno = savedErrno;
+}
+
+static void installSuspendSignalHandler()
+{
+    static bool installed;
+    if (installed)
+        return;
+    installed = true;
+
+    sem_init(&threadSuspended, 0, 0);
+    sem_init(&threadResumed, 0, 0);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = suspendedThreadSignalHandler;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigfillset(&action.sa_mask);
+    sigaction(suspendSignal, &action, 0);
+}
+
+// Returns false if the thread did not enter the signal handler in time.
+static bool waitForSuspendedThread()
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += suspendTimeoutInNanoseconds;
+    if (deadline.tv_nsec >= 1000 * 1000 * 1000) {
+        deadline.tv_nsec -= 1000 * 1000 * 1000;
+        ++deadline.tv_sec;
+    }
+
+    while (sem_timedwait(&threadSuspended, &deadline)) {
+        if (errno != EINTR)
+            return false;
+    }
+    return true;
+}
+
+#endif // !OS(DARWIN)
+
+SamplingProfiler::SamplingProfiler(JSGlobalData* globalData)
+    : m_globalData(globalData)
+    , m_isRunning(false)
+    , m_intervalInMicroseconds(0)
+    , m_samplingThread(0)
+    , m_writeIndex(0)
+    , m_readIndex(0)
+    , m_droppedSampleCount(0)
+    , m_sampleCount(0)
+{
+    // Frame 0 is never used, so that no call tree key is the empty pair, and
+    // node 0 is the root of the call tree.
+    m_frameNames.append(UString());
+    m_callTree.append(CallTreeNode(0, 0));
+}
+
+SamplingProfiler::~SamplingProfiler()
+{
+    stop();
+}
+
+bool SamplingProfiler::start(CallFrame* callFrame, unsigned samplesPerSecond)
+{
+    ASSERT(!m_isRunning);
+    if (!samplesPerSecond)
+        samplesPerSecond = defaultSamplesPerSecond;
+
+    {
+        CodeBlockRegistryLocker locker;
+        if (runningProfiler)
+            return false;
+        runningProfiler = this;
+#if !OS(DARWIN)
+        installSuspendSignalHandler();
+#endif
+        registerExistingCodeBlocks(callFrame);
+    }
+
+    {
+        MutexLocker locker(*sampledThreadMutex);
+        ++sampledThreadGeneration;
+        sampledThreadHasExited = false;
+        pthread_setspecific(sampledThreadKey, reinterpret_cast<void*>(sampledThreadGeneration));
+    }
+
+    m_globalData->topCallFrame = callFrame;
+    m_globalData->isSamplingProfilerRunning = true;
+    m_thread = pthread_self();
+    m_intervalInMicroseconds = std::max(1000000 / samplesPerSecond, 1u);
+    m_buffer.resize(bufferCapacity);
+    m_writeIndex = 0;
+    m_readIndex = 0;
+    m_isRunning = true;
+    m_samplingThread = createThread(threadStartFunc, this, "JavaScriptCore::Profiler");
+    return true;
+}
+
+void SamplingProfiler::stop()
+{
+    if (!m_isRunning)
+        return;
+
+    m_isRunning = false;
+    waitForThreadCompletion(m_samplingThread, 0);
+    m_globalData->isSamplingProfilerRunning = false;
+    if (pthread_equal(pthread_self(), m_thread))
+        pthread_setspecific(sampledThreadKey, 0);
+    processSamples();
+    m_buffer.clear();
+
+    CodeBlockRegistryLocker locker;
+    runningProfiler = 0;
+    for (unsigned i = 0; i < codeBlockRegistryStripeCount; ++i)
+        codeBlockRegistryStripes[i].codeBlocks.clear();
+}
+
+void* SamplingProfiler::threadStartFunc(void* profiler)
+{
+    static_cast<SamplingProfiler*>(profiler)->samplingThread();
+    return 0;
+}
+
+void SamplingProfiler::samplingThread()
+{
+    while (m_isRunning) {
+        usleep(m_intervalInMicroseconds);
+        takeSample();
+    }
+}
+
+bool SamplingProfiler::suspendThread(void*& pc, CallFrame*& callFrame)
+{
+#if OS(DARWIN)
+    mach_port_t thread = pthread_mach_thread_np(m_thread);
+    if (thread_suspend(thread) != KERN_SUCCESS)
+        return false;
+
+#if CPU(X86_64)
+    x86_thread_state64_t state;
+    mach_msg_type_number_t count = x86_THREAD_STATE64_COUNT;
+    thread_state_flavor_t flavor = x86_THREAD_STATE64;
+#elif CPU(X86)
+    i386_thread_state_t state;
+    mach_msg_type_number_t count = i386_THREAD_STATE_COUNT;
+    thread_state_flavor_t flavor = i386_THREAD_STATE;
+#else
+#error "The sampling profiler does not know the call frame register on this platform"
+#endif
+
+    if (thread_get_state(thread, flavor, reinterpret_cast<thread_state_t>(&state), &count) != KERN_SUCCESS) {
+        thread_resume(thread);
+        return false;
+    }
+
+#if __DARWIN_UNIX03
+#if CPU(X86_64)
+    pc = reinterpret_cast<void*>(state.__rip);
+    callFrame = reinterpret_cast<CallFrame*>(state.__r13);
+#else
+    pc = reinterpret_cast<void*>(state.__eip);
+    callFrame = reinterpret_cast<CallFrame*>(state.__edi);
+#endif
+#else // !__DARWIN_UNIX03
+#if CPU(X86_64)
+    pc = reinterpret_cast<void*>(state.rip);
+    callFrame = reinterpret_cast<CallFrame*>(state.r13);
+#else
+    pc = reinterpret_cast<void*>(state.eip);
+    callFrame = reinterpret_cast<CallFrame*>(state.edi);
+#endif
+#endif // __DARWIN_UNIX03
+    return true;
+#else
+    suspendState = SuspendRequested;
+    memoryBarrier();
+    if (pthread_kill(m_thread, suspendSignal)) {
+        suspendState = NoSuspendRequest;
+        return false;
+    }
+    if (!waitForSuspendedThread()) {
+        if (__sync_bool_compare_and_swap(&suspendState, SuspendRequested, NoSuspendRequest))
+            return false;
+        // The handler started just as the wait timed out.
+        while (sem_wait(&threadSuspended) && errno == EINTR) { }
+    }
+    pc = suspendedPC;
+    callFrame = suspendedCallFrame;
+    return true;
+#endif
+}
+
+void SamplingProfiler::resumeThread()
+{
+#if OS(DARWIN)
+    thread_resume(pthread_mach_thread_np(m_thread));
+#else
+    suspendState = NoSuspendRequest;
+    sem_post(&threadResumed);
+#endif
+}
+
+static inline bool isFrameInRegisterFile(CallFrame* callFrame, const RegisterFile& registerFile)
+{
+    // Compared as integers: the register may hold any value, and the compiler
+    // is free to rearrange pointer comparisons in ways that wrap around.
+    uintptr_t registers = reinterpret_cast<uintptr_t>(callFrame->registers());
+    if (registers & (sizeof(Register) - 1))
+        return false;
+    uintptr_t start = reinterpret_cast<uintptr_t>(registerFile.start() + RegisterFile::CallFrameHeaderSize);
+    uintptr_t end = reinterpret_cast<uintptr_t>(registerFile.end());
+    return registers >= start && registers <= end;
+}
+
+void SamplingProfiler::registerExistingCodeBlocks(CallFrame* callFrame)
+{
+    // Code that runs from now on belongs to a function, or is on the stack, or
+    // has yet to be compiled, which registers it.
+    LiveObjectIterator it = m_globalData->heap.primaryHeapBegin();
+    LiveObjectIterator heapEnd = m_globalData->heap.primaryHeapEnd();
+    for ( ; it != heapEnd; ++it) {
+        if (!(*it)->inherits(&JSFunction::info))
+            continue;
+        JSFunction* function = asFunction(*it);
+        if (function->executable()->isHostFunction() || !function->jsExecutable()->isGenerated())
+            continue;
+        registerCodeBlock(&function->jsExecutable()->generatedBytecode());
+    }
+
+    const RegisterFile& registerFile = m_globalData->interpreter->registerFile();
+    for (callFrame = callFrame ? callFrame->removeHostCallFrameFlag() : 0; callFrame && isFrameInRegisterFile(callFrame, registerFile); ) {
+        if (CodeBlock* codeBlock = callFrame->codeBlock())
+            registerCodeBlock(codeBlock);
+        CallFrame* callerFrame = callFrame->callerFrame()->removeHostCallFrameFlag();
+        if (callerFrame >= callFrame)
+            break;
+        callFrame = callerFrame;
+    }
+}
+
+void SamplingProfiler::takeSample()
+{
+    // Locking the registry before suspending the thread means the thread is
+    // never stopped while it holds one of the registry's locks.
+    CodeBlockRegistryLocker locker;
+    MutexLocker threadLocker(*sampledThreadMutex);
+    if (sampledThreadHasExited)
+        return;
+
+    unsigned writeIndex = m_writeIndex;
+    if (writeIndex - m_readIndex > bufferCapacity - maxStackDepth - 2) {
+        ++m_droppedSampleCount;
+        return;
+    }
+
+    void* pc;
+    CallFrame* callFrame;
+    if (!suspendThread(pc, callFrame))
+        return;
+
+    // JIT code keeps the current call frame in a register. Anywhere else - in
+    // stub functions, host functions and the runtime - the register may hold
+    // anything, so the frame last published by the JIT is used instead.
+    const RegisterFile& registerFile = m_globalData->interpreter->registerFile();
+    bool inJITCode = false;
+    if (callFrame && isFrameInRegisterFile(callFrame, registerFile)) {
+        CodeBlock* codeBlock = callFrame->codeBlock();
+        inJITCode = serialForCodeBlock(codeBlock) && codeBlock->getJITCode().contains(pc);
+    }
+    if (!inJITCode)
+        callFrame = m_globalData->topCallFrame;
+
+    unsigned frameCount = recordFrames(callFrame, writeIndex + 1);
+
+    resumeThread();
+
+    FrameRecord& stackStart = m_buffer[writeIndex & bufferMask];
+    stackStart.type = FrameRecord::StackStart;
+    stackStart.data = frameCount;
+    stackStart.pointer = 0;
+
+    memoryBarrier();
+    m_writeIndex = writeIndex + frameCount + 1;
+}
+
+unsigned SamplingProfiler::recordFrames(CallFrame* callFrame, unsigned writeIndex)
+{
+    // Called with the thread suspended: nothing here may allocate, and every
+    // pointer is checked before it is followed.
+    const RegisterFile& registerFile = m_globalData->interpreter->registerFile();
+    unsigned frameCount = 0;
+    while (callFrame && frameCount < maxStackDepth && isFrameInRegisterFile(callFrame, registerFile)) {
+        FrameRecord& record = m_buffer[(writeIndex + frameCount) & bufferMask];
+        if (CodeBlock* codeBlock = callFrame->codeBlock()) {
+            unsigned serial = serialForCodeBlock(codeBlock);
+            if (!serial)
+                break;
+            record.type = FrameRecord::JSFrame;
+            record.data = serial;
+            record.pointer = codeBlock;
+        } else {
+            record.type = FrameRecord::HostFrame;
+            record.data = 0;
+            record.pointer = callFrame->callee();
+        }
+        ++frameCount;
+
+        // Callers are always below their callees in the register file.
+        CallFrame* callerFrame = callFrame->callerFrame()->removeHostCallFrameFlag();
+        if (callerFrame >= callFrame)
+            break;
+        callFrame = callerFrame;
+    }
+    return frameCount;
+}
+
+void SamplingProfiler::processSamples()
+{
+    unsigned writeIndex = m_writeIndex;
+    memoryBarrier();
+
+    Vector<unsigned, 64> frames;
+    {
+        CodeBlockRegistryLocker locker;
+        unsigned readIndex = m_readIndex;
+        while (readIndex != writeIndex) {
+            const FrameRecord& stackStart = m_buffer[readIndex & bufferMask];
+            ASSERT(stackStart.type == FrameRecord::StackStart);
+            unsigned frameCount = stackStart.data;
+
+            frames.shrink(0);
+            if (frameCount == maxStackDepth)
+                frames.append(frameForName("(truncated)"));
+            for (unsigned i = frameCount; i; --i)
+                frames.append(frameForRecord(m_buffer[(readIndex + i) & bufferMask]));
+            if (frames.isEmpty())
+                frames.append(frameForName("(native code)"));
+            addStack(frames);
+
+            readIndex += frameCount + 1;
+        }
+    }
+
+    // Host functions are only known to be alive until the next collection.
+    m_hostFunctionFrames.clear();
+
+    memoryBarrier();
+    m_readIndex = writeIndex;
+}
+
+static UString nameForCodeBlock(CodeBlock* codeBlock)
+{
+    ScriptExecutable* executable = codeBlock->ownerExecutable();
+
+    StringBuilder builder;
+    switch (codeBlock->codeType()) {
+    case GlobalCode:
+        builder.append("(program)");
+        break;
+    case EvalCode:
+        builder.append("(eval)");
+        break;
+    case FunctionCode: {
+        const UString& name = static_cast<FunctionExecutable*>(executable)->name().ustring();
+        builder.append(name.isEmpty() ? UString("(anonymous function)") : name);
+        break;
+    }
+    }
+    builder.append(' ');
+    builder.append(executable->sourceURL());
+    builder.append(':');
+    builder.append(UString::from(executable->lineNo()));
+    return builder.build();
+}
+
+unsigned SamplingProfiler::frameForRecord(const FrameRecord& record)
+{
+    switch (record.type) {
+    case FrameRecord::JSFrame: {
+        HashMap<unsigned, unsigned>::iterator it = m_codeBlockFrames.find(record.data);
+        if (it != m_codeBlockFrames.end())
+            return it->second;
+
+        CodeBlock* codeBlock = static_cast<CodeBlock*>(record.pointer);
+        if (serialForCodeBlock(codeBlock) != record.data)
+            return frameForName("(unknown)");
+        unsigned frame = frameForName(nameForCodeBlock(codeBlock));
+        m_codeBlockFrames.set(record.data, frame);
+        return frame;
+    }
+    case FrameRecord::HostFrame: {
+        // A host frame's callee is read from a frame that was not known to be
+        // complete, so it is only trusted if it is a cell of this heap.
+        JSCell* cell = static_cast<JSCell*>(record.pointer);
+        if (!cell || !m_globalData->heap.isAllocatedCell(cell) || !cell->isObject())
+            return frameForName("(native code)");
+        JSObject* callee = asObject(cell);
+
+        HashMap<JSObject*, unsigned>::iterator it = m_hostFunctionFrames.find(callee);
+        if (it != m_hostFunctionFrames.end())
+            return it->second;
+
+        JSValue nameValue = callee->getDirect(m_globalData->propertyNames->name);
+        // getDirect returns the empty value for functions with no name of their own.
+        UString name = nameValue && nameValue.isString() ? asString(nameValue)->tryGetValue() : UString();
+        unsigned frame = frameForName(makeString(name.isEmpty() ? UString("(anonymous function)") : name, " [native]"));
+        m_hostFunctionFrames.set(callee, frame);
+        return frame;
+    }
+    case FrameRecord::StackStart:
+        break;
+    }
+    ASSERT_NOT_REACHED();
+    return 0;
+}
+
+unsigned SamplingProfiler::frameForName(const UString& name)
+{
+    // Semicolons separate frames and newlines separate stacks.
+    UString sanitizedName = name;
+    for (unsigned i = 0; i < name.size(); ++i) {
+        if (name[i] != ';' && name[i] != '\n')
+            continue;
+        StringBuilder builder;
+        for (unsigned j = 0; j < name.size(); ++j)
+            builder.append(name[j] == ';' ? ',' : name[j] == '\n' ? ' ' : name[j]);
+        sanitizedName = builder.build();
+        break;
+    }
+
+    std::pair<HashMap<RefPtr<UString::Rep>, unsigned>::iterator, bool> result = m_frameNameIndices.add(sanitizedName.rep(), m_frameNames.size());
+    if (result.second)
+        m_frameNames.append(sanitizedName);
+    return result.first->second;
+}
+
+void SamplingProfiler::addStack(const Vector<unsigned, 64>& frames)
+{
+    unsigned node = 0;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        std::pair<HashMap<std::pair<unsigned, unsigned>, unsigned>::iterator, bool> result = m_callTreeChildren.add(std::make_pair(node, frames[i]), m_callTree.size());
+        if (result.second)
+            m_callTree.append(CallTreeNode(node, frames[i]));
+        node = result.first->second;
+    }
+    ++m_callTree[node].count;
+    ++m_sampleCount;
+}
+
+UString SamplingProfiler::collapsedStacks()
+{
+    processSamples();
+
+    StringBuilder builder;
+    Vector<unsigned, 64> path;
+    for (size_t i = 1; i < m_callTree.size(); ++i) {
+        const CallTreeNode& leaf = m_callTree[i];
+        if (!leaf.count)
+            continue;
+
+        path.shrink(0);
+        for (unsigned node = i; node; node = m_callTree[node].parent)
+            path.append(m_callTree[node].frame);
+        for (size_t j = path.size(); j; --j) {
+            builder.append(m_frameNames[path[j - 1]]);
+            builder.append(j > 1 ? ';' : ' ');
+        }
+        builder.append(UString::from(leaf.count));
+        builder.append('\n');
+    }
+    return builder.build();
+}
+
+} // namespace JSC
+
+#endif // ENABLE(SAMPLING_PROFILER)
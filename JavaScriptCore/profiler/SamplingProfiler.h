@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2010 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SamplingProfiler_h
+#define SamplingProfiler_h
+
+#if ENABLE(SAMPLING_PROFILER)
+
+#include "UString.h"
+#include <wtf/HashMap.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/RefPtr.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+#include <pthread.h>
+
+namespace JSC {
+
+    class CodeBlock;
+    class ExecState;
+    class JSGlobalData;
+    class JSObject;
+
+    typedef ExecState CallFrame;
+
+    // Samples the JavaScript stack of one thread at a fixed rate. A background
+    // thread briefly suspends the JavaScript thread, walks its call frames and
+    // copies what it finds into a ring buffer, without allocating or taking any
+    // lock the JavaScript thread might hold. The JavaScript thread turns the
+    // samples into names and counts later: at garbage collections, at timeout
+    // checks, and when the results are asked for.
+    //
+    // Only one profiler can be running in a process at a time.
+    class SamplingProfiler : public Noncopyable {
+    public:
+        static const unsigned defaultSamplesPerSecond = 1000;
+
+        SamplingProfiler(JSGlobalData*);
+        ~SamplingProfiler();
+
+        // Starts sampling the calling thread, whose innermost call frame, if it
+        // is running JavaScript, is callFrame. Sampling stops by itself if the
+        // thread exits. Fails if another profiler is already running.
+        bool start(CallFrame*, unsigned samplesPerSecond);
+        void stop();
+        bool isRunning() const { return m_isRunning; }
+
+        // Moves the samples in the ring buffer into the call tree.
+        void processSamples();
+
+        // Every distinct stack seen so far, outermost frame first, as lines of
+        // the form "outer;...;inner count" - the input format of the usual
+        // flame graph tools.
+        UString collapsedStacks();
+
+        unsigned sampleCount() const { return m_sampleCount; }
+        unsigned droppedSampleCount() const { return m_droppedSampleCount; }
+
+        // The profiler only trusts frames whose code block it knows to be alive.
+        // Code blocks are registered as they are created and destroyed while a
+        // profiler runs, and start() registers the ones that already exist.
+        static void initializeThreading();
+        static void codeBlockCreated(CodeBlock*);
+        static void codeBlockDestroyed(CodeBlock*);
+
+    private:
+        struct FrameRecord {
+            enum Type { StackStart, JSFrame, HostFrame };
+
+            Type type;
+            // The number of frames that follow for StackStart, the code block's
+            // registration serial for JSFrame.
+            unsigned data;
+            void* pointer;
+        };
+
+        struct CallTreeNode {
+            CallTreeNode(unsigned parent, unsigned frame)
+                : parent(parent)
+                , frame(frame)
+                , count(0)
+            {
+            }
+
+            unsigned parent;
+            unsigned frame;
+            unsigned count;
+        };
+
+        static void* threadStartFunc(void*);
+        void samplingThread();
+        void takeSample();
+        bool suspendThread(void*& pc, CallFrame*& callFrame);
+        void resumeThread();
+        unsigned recordFrames(CallFrame*, unsigned writeIndex);
+        void registerExistingCodeBlocks(CallFrame*);
+
+        unsigned frameForRecord(const FrameRecord&);
+        unsigned frameForName(const UString&);
+        void addStack(const Vector<unsigned, 64>& frames);
+
+        JSGlobalData* m_globalData;
+        volatile bool m_isRunning;
+        unsigned m_intervalInMicroseconds;
+        ThreadIdentifier m_samplingThread;
+        pthread_t m_thread;
+
+        // Written only by the sampling thread, read only by the JavaScript thread.
+        Vector<FrameRecord> m_buffer;
+        volatile unsigned m_writeIndex;
+        volatile unsigned m_readIndex;
+        volatile unsigned m_droppedSampleCount;
+
+        unsigned m_sampleCount;
+        Vector<UString> m_frameNames;
+        HashMap<RefPtr<UString::Rep>, unsigned> m_frameNameIndices;
+        HashMap<unsigned, unsigned> m_codeBlockFrames;
+        HashMap<JSObject*, unsigned> m_hostFunctionFrames;
+        Vector<CallTreeNode> m_callTree;
+        HashMap<std::pair<unsigned, unsigned>, unsigned> m_callTreeChildren;
+    };
+
+} // namespace JSC
+
+#endif // ENABLE(SAMPLING_PROFILER)
+
+#endif // SamplingProfiler_h
@@ -224,6 +224,10 @@ void Arguments::put(ExecState* exec, unsigned i, JSValue value, PutPropertySlot&
             d->registers[d->firstParameterIndex + i] = JSValue(value);
         else
             d->extraArguments[i - d->numParameters] = JSValue(value);
+        Heap::writeBarrier(this);
+        // Once torn off, the parameters may live in the activation's registers.
+        if (d->activation)
+            Heap::writeBarrier(d->activation);
         return;
     }
 
@@ -239,6 +243,10 @@ void Arguments::put(ExecState* exec, const Identifier& propertyName, JSValue val
             d->registers[d->firstParameterIndex + i] = JSValue(value);
         else
             d->extraArguments[i - d->numParameters] = JSValue(value);
+        Heap::writeBarrier(this);
+        // Once torn off, the parameters may live in the activation's registers.
+        if (d->activation)
+            Heap::writeBarrier(d->activation);
         return;
     }
 
@@ -81,6 +81,7 @@ namespace JSC {
         {
             d->activation = activation;
             d->registers = &activation->registerAt(0);
+            Heap::writeBarrier(this);
         }
 
         static PassRefPtr<Structure> createStructure(JSValue prototype) 
@@ -88,8 +89,12 @@ namespace JSC {
             return Structure::create(prototype, TypeInfo(ObjectType, StructureFlags), AnonymousSlotCount); 
         }
 
+        // Reads an argument straight from the call frame of a function that has
+        // not created its arguments object yet. The argument must have been passed.
+        static JSValue argumentFromCallFrame(CallFrame*, unsigned index);
+
     protected:
-        static const unsigned StructureFlags = OverridesGetOwnPropertySlot | OverridesMarkChildren | OverridesGetPropertyNames | JSObject::StructureFlags;
+        static const unsigned StructureFlags = OverridesGetOwnPropertySlot | OverridesMarkChildren | OverridesGetPropertyNames | HasWriteBarrieredChildren | JSObject::StructureFlags;
 
     private:
         void getArgumentsData(CallFrame*, JSFunction*&, ptrdiff_t& firstParameterIndex, Register*& argv, int& argc);
@@ -133,6 +138,20 @@ namespace JSC {
         firstParameterIndex = -RegisterFile::CallFrameHeaderSize - numParameters;
     }
 
+    ALWAYS_INLINE JSValue Arguments::argumentFromCallFrame(CallFrame* callFrame, unsigned index)
+    {
+        int numParameters = callFrame->callee()->jsExecutable()->parameterCount();
+        int argc = callFrame->argumentCount();
+        ASSERT(index < static_cast<unsigned>(argc - 1));
+
+        // Named parameters are read from their own registers, which may have
+        // been assigned to; any others were left where the caller put them.
+        ptrdiff_t offset = static_cast<ptrdiff_t>(index) - RegisterFile::CallFrameHeaderSize - numParameters;
+        if (index >= static_cast<unsigned>(numParameters))
+            offset -= argc;
+        return callFrame->registers()[offset].jsValue();
+    }
+
     inline Arguments::Arguments(CallFrame* callFrame)
         : JSObject(callFrame->lexicalGlobalObject()->argumentsStructure())
         , d(new ArgumentsData)
@@ -213,6 +232,7 @@ namespace JSC {
         memcpy(registerArray, d->registers - registerOffset, registerArraySize * sizeof(Register));
         d->registerArray.set(registerArray);
         d->registers = registerArray + registerOffset;
+        Heap::writeBarrier(this);
     }
 
     // This JSActivation function is defined here so it can get at Arguments::setRegisters.
@@ -232,6 +252,7 @@ namespace JSC {
 
         Register* registerArray = copyRegisterArray(d()->registers - registerOffset, registerArraySize);
         setRegisters(registerArray + registerOffset, registerArray);
+        Heap::writeBarrier(this);
         if (arguments && !arguments->isTornOff())
             static_cast<Arguments*>(arguments)->setActivation(this);
     }
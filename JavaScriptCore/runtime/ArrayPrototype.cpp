@@ -45,7 +45,6 @@ static JSValue JSC_HOST_CALL arrayProtoFuncToLocaleString(ExecState*, JSObject*,
 static JSValue JSC_HOST_CALL arrayProtoFuncConcat(ExecState*, JSObject*, JSValue, const ArgList&);
 static JSValue JSC_HOST_CALL arrayProtoFuncJoin(ExecState*, JSObject*, JSValue, const ArgList&);
 static JSValue JSC_HOST_CALL arrayProtoFuncPop(ExecState*, JSObject*, JSValue, const ArgList&);
-static JSValue JSC_HOST_CALL arrayProtoFuncPush(ExecState*, JSObject*, JSValue, const ArgList&);
 static JSValue JSC_HOST_CALL arrayProtoFuncReverse(ExecState*, JSObject*, JSValue, const ArgList&);
 static JSValue JSC_HOST_CALL arrayProtoFuncShift(ExecState*, JSObject*, JSValue, const ArgList&);
 static JSValue JSC_HOST_CALL arrayProtoFuncSlice(ExecState*, JSObject*, JSValue, const ArgList&);
@@ -68,10 +67,10 @@ static JSValue JSC_HOST_CALL arrayProtoFuncLastIndexOf(ExecState*, JSObject*, JS
 
 namespace JSC {
 
-static inline bool isNumericCompareFunction(ExecState* exec, CallType callType, const CallData& callData)
+static inline CompareFunctionType compareFunctionType(ExecState* exec, CallType callType, const CallData& callData)
 {
     if (callType != CallTypeJS)
-        return false;
+        return UnknownCompareFunction;
 
 #if ENABLE(JIT)
     // If the JIT is enabled then we need to preserve the invariant that every
@@ -82,7 +81,7 @@ static inline bool isNumericCompareFunction(ExecState* exec, CallType callType,
     CodeBlock& codeBlock = callData.js.functionExecutable->bytecode(exec, callData.js.scopeChain);
 #endif
 
-    return codeBlock.isNumericCompareFunction();
+    return codeBlock.compareFunctionType();
 }
 
 // ------------------------------ ArrayPrototype ----------------------------
@@ -384,13 +383,15 @@ JSValue JSC_HOST_CALL arrayProtoFuncShift(ExecState* exec, JSObject*, JSValue th
         result = jsUndefined();
     } else {
         result = thisObj->get(exec, 0);
-        for (unsigned k = 1; k < length; k++) {
-            if (JSValue obj = getProperty(exec, thisObj, k))
-                thisObj->put(exec, k - 1, obj);
-            else
-                thisObj->deleteProperty(exec, k - 1);
+        if (!isJSArray(&exec->globalData(), thisObj) || !asArray(thisObj)->shiftCount(0, 1)) {
+            for (unsigned k = 1; k < length; k++) {
+                if (JSValue obj = getProperty(exec, thisObj, k))
+                    thisObj->put(exec, k - 1, obj);
+                else
+                    thisObj->deleteProperty(exec, k - 1);
+            }
+            thisObj->deleteProperty(exec, length - 1);
         }
-        thisObj->deleteProperty(exec, length - 1);
         putProperty(exec, thisObj, exec->propertyNames().length, jsNumber(exec, length - 1));
     }
     return result;
@@ -450,12 +451,24 @@ JSValue JSC_HOST_CALL arrayProtoFuncSort(ExecState* exec, JSObject*, JSValue thi
     CallType callType = function.getCallData(callData);
 
     if (thisObj->classInfo() == &JSArray::info) {
-        if (isNumericCompareFunction(exec, callType, callData))
-            asArray(thisObj)->sortNumeric(exec, function, callType, callData);
-        else if (callType != CallTypeNone)
-            asArray(thisObj)->sort(exec, function, callType, callData);
-        else
-            asArray(thisObj)->sort(exec);
+        JSArray* array = asArray(thisObj);
+        switch (compareFunctionType(exec, callType, callData)) {
+        case NumericCompareFunction:
+            array->sortNumeric(exec, function, callType, callData);
+            break;
+        case ReverseNumericCompareFunction:
+            array->sortNumeric(exec, function, callType, callData, true);
+            break;
+        case RelationalCompareFunction:
+            array->sortRelational(exec, function, callType, callData);
+            break;
+        case UnknownCompareFunction:
+            if (callType != CallTypeNone)
+                array->sort(exec, function, callType, callData);
+            else
+                array->sort(exec);
+            break;
+        }
         return thisObj;
     }
 
@@ -532,23 +545,30 @@ JSValue JSC_HOST_CALL arrayProtoFuncSplice(ExecState* exec, JSObject*, JSValue t
     }
     resObj->setLength(deleteCount);
 
+    // The conversions of the arguments above may have changed the array.
+    JSArray* array = isJSArray(&exec->globalData(), thisObj) && asArray(thisObj)->length() == length ? asArray(thisObj) : 0;
+
     unsigned additionalArgs = std::max<int>(args.size() - 2, 0);
     if (additionalArgs != deleteCount) {
         if (additionalArgs < deleteCount) {
-            for (unsigned k = begin; k < length - deleteCount; ++k) {
-                if (JSValue v = getProperty(exec, thisObj, k + deleteCount))
-                    thisObj->put(exec, k + additionalArgs, v);
-                else
-                    thisObj->deleteProperty(exec, k + additionalArgs);
+            if (!array || !array->shiftCount(begin, deleteCount - additionalArgs)) {
+                for (unsigned k = begin; k < length - deleteCount; ++k) {
+                    if (JSValue v = getProperty(exec, thisObj, k + deleteCount))
+                        thisObj->put(exec, k + additionalArgs, v);
+                    else
+                        thisObj->deleteProperty(exec, k + additionalArgs);
+                }
+                for (unsigned k = length; k > length - deleteCount + additionalArgs; --k)
+                    thisObj->deleteProperty(exec, k - 1);
             }
-            for (unsigned k = length; k > length - deleteCount + additionalArgs; --k)
-                thisObj->deleteProperty(exec, k - 1);
         } else {
-            for (unsigned k = length - deleteCount; k > begin; --k) {
-                if (JSValue obj = getProperty(exec, thisObj, k + deleteCount - 1))
-                    thisObj->put(exec, k + additionalArgs - 1, obj);
-                else
-                    thisObj->deleteProperty(exec, k + additionalArgs - 1);
+            if (!array || !array->unshiftCount(begin, additionalArgs - deleteCount)) {
+                for (unsigned k = length - deleteCount; k > begin; --k) {
+                    if (JSValue obj = getProperty(exec, thisObj, k + deleteCount - 1))
+                        thisObj->put(exec, k + additionalArgs - 1, obj);
+                    else
+                        thisObj->deleteProperty(exec, k + additionalArgs - 1);
+                }
             }
         }
     }
@@ -566,7 +586,7 @@ JSValue JSC_HOST_CALL arrayProtoFuncUnShift(ExecState* exec, JSObject*, JSValue
     // 15.4.4.13
     unsigned length = thisObj->get(exec, exec->propertyNames().length).toUInt32(exec);
     unsigned nrArgs = args.size();
-    if (nrArgs) {
+    if (nrArgs && (!isJSArray(&exec->globalData(), thisObj) || !asArray(thisObj)->unshiftCount(0, nrArgs))) {
         for (unsigned k = length; k > 0; --k) {
             if (JSValue v = getProperty(exec, thisObj, k - 1))
                 thisObj->put(exec, k + nrArgs - 1, v);
@@ -37,6 +37,9 @@ namespace JSC {
         static const ClassInfo info;
     };
 
+    // The JIT inlines pushes onto arrays with spare capacity; see JITIntrinsics.cpp.
+    JSValue JSC_HOST_CALL arrayProtoFuncPush(ExecState*, JSObject*, JSValue, const ArgList&);
+
 } // namespace JSC
 
 #endif // ArrayPrototype_h
@@ -35,11 +35,13 @@
 #include "JSZombie.h"
 #include "MarkStack.h"
 #include "Nodes.h"
+#include "SamplingProfiler.h"
 #include "Tracing.h"
 #include <algorithm>
 #include <limits.h>
 #include <setjmp.h>
 #include <stdlib.h>
+#include <wtf/CurrentTime.h>
 #include <wtf/FastMalloc.h>
 #include <wtf/HashCountedSet.h>
 #include <wtf/UnusedParam.h>
@@ -92,6 +94,7 @@
 #define COLLECT_ON_EVERY_ALLOCATION 0
 
 using std::max;
+using std::min;
 
 namespace JSC {
 
@@ -100,6 +103,14 @@ namespace JSC {
 const size_t GROWTH_FACTOR = 2;
 const size_t LOW_WATER_FACTOR = 4;
 const size_t ALLOCATIONS_PER_COLLECTION = 3600;
+// In GenerationalCollectorMode, a full collection is scheduled once the cells
+// surviving nursery collections outnumber the cells that survived the last full
+// collection by this factor.
+const size_t OLD_GENERATION_GROWTH_FACTOR = 2;
+#if ENABLE(PARALLEL_MARKING)
+// Below this heap size, waking the marking threads costs more than it saves.
+const size_t MIN_BLOCKS_FOR_PARALLEL_MARKING = 4 * 1024 * 1024 / BLOCK_SIZE;
+#endif
 // This value has to be a macro to be used in max() without introducing
 // a PIC branch in Mach-O binaries, see <rdar://problem/5971391>.
 #define MIN_ARRAY_SIZE (static_cast<size_t>(14))
@@ -129,6 +140,15 @@ public:
 
 #endif
 
+// Leaves room to allocate as many bytes as survived the last collection, and
+// at least ALLOCATIONS_PER_COLLECTION cells, before collecting again.
+static size_t minBlockCount(size_t liveBytes)
+{
+    const size_t bytesPerBlock = ATOMS_PER_BLOCK * ATOM_SIZE;
+    size_t minBytes = liveBytes + max(ALLOCATIONS_PER_COLLECTION * CELL_SIZE, liveBytes);
+    return (minBytes + bytesPerBlock - 1) / bytesPerBlock;
+}
+
 Heap::Heap(JSGlobalData* globalData)
     : m_markListSet(0)
 #if ENABLE(JSC_MULTIPLE_THREADS)
@@ -142,7 +162,13 @@ Heap::Heap(JSGlobalData* globalData)
 {
     ASSERT(globalData);
     memset(&m_heap, 0, sizeof(CollectorHeap));
-    allocateBlock();
+    for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        CollectorSizeClass& sizeClass = m_heap.sizeClasses[i];
+        sizeClass.cellSize = SMALL_CELL_SIZE << i;
+        sizeClass.atomsPerCell = sizeClass.cellSize / ATOM_SIZE;
+        sizeClass.cellsPerBlock = ATOMS_PER_BLOCK / sizeClass.atomsPerCell;
+    }
+    m_heap.maxBlocks = minBlockCount(0);
 }
 
 Heap::~Heap()
@@ -165,6 +191,12 @@ void Heap::destroy()
     // (and thus the global data) before other objects that may use the global data.
     RefPtr<JSGlobalData> protect(m_globalData);
 
+#if ENABLE(SAMPLING_PROFILER)
+    // Naming the last samples needs the heap.
+    if (m_globalData->samplingProfiler)
+        m_globalData->samplingProfiler->stop();
+#endif
+
     delete m_markListSet;
     m_markListSet = 0;
 
@@ -189,7 +221,7 @@ void Heap::destroy()
     m_globalData = 0;
 }
 
-NEVER_INLINE CollectorBlock* Heap::allocateBlock()
+NEVER_INLINE CollectorBlock* Heap::allocateBlock(CollectorSizeClass& sizeClass)
 {
 #if OS(DARWIN)
     vm_address_t address = 0;
@@ -241,45 +273,52 @@ NEVER_INLINE CollectorBlock* Heap::allocateBlock()
 
     CollectorBlock* block = reinterpret_cast<CollectorBlock*>(address);
     block->heap = this;
-    clearMarkBits(block);
+    clearMarkBits(sizeClass, block);
 
     Structure* dummyMarkableCellStructure = m_globalData->dummyMarkableCellStructure.get();
-    for (size_t i = 0; i < HeapConstants::cellsPerBlock; ++i)
-        new (block->cells + i) JSCell(dummyMarkableCellStructure);
+    for (size_t i = 0; i < sizeClass.cellsPerBlock; ++i)
+        new (block->cell(sizeClass, i)) JSCell(dummyMarkableCellStructure);
     
     // Add block to blocks vector.
 
-    size_t numBlocks = m_heap.numBlocks;
-    if (m_heap.usedBlocks == numBlocks) {
+    size_t numBlocks = sizeClass.numBlocks;
+    if (sizeClass.usedBlocks == numBlocks) {
         static const size_t maxNumBlocks = ULONG_MAX / sizeof(CollectorBlock*) / GROWTH_FACTOR;
         if (numBlocks > maxNumBlocks)
             CRASH();
         numBlocks = max(MIN_ARRAY_SIZE, numBlocks * GROWTH_FACTOR);
-        m_heap.numBlocks = numBlocks;
-        m_heap.blocks = static_cast<CollectorBlock**>(fastRealloc(m_heap.blocks, numBlocks * sizeof(CollectorBlock*)));
+        sizeClass.numBlocks = numBlocks;
+        sizeClass.blocks = static_cast<CollectorBlock**>(fastRealloc(sizeClass.blocks, numBlocks * sizeof(CollectorBlock*)));
     }
-    m_heap.blocks[m_heap.usedBlocks++] = block;
+    // A new block has no dead cells to destroy.
+    if (sizeClass.sweptBlocks == sizeClass.usedBlocks)
+        ++sizeClass.sweptBlocks;
+    sizeClass.blocks[sizeClass.usedBlocks++] = block;
 
     return block;
 }
 
-NEVER_INLINE void Heap::freeBlock(size_t block)
+NEVER_INLINE void Heap::freeBlock(CollectorSizeClass& sizeClass, size_t block)
 {
     m_heap.didShrink = true;
 
-    ObjectIterator it(m_heap, block);
-    ObjectIterator end(m_heap, block + 1);
-    for ( ; it != end; ++it)
-        (*it)->~JSCell();
-    freeBlockPtr(m_heap.blocks[block]);
+    CollectorBlock* collectorBlock = sizeClass.blocks[block];
+    for (size_t i = 0; i < sizeClass.cellsPerBlock - 1; ++i)
+        collectorBlock->cell(sizeClass, i)->~JSCell();
+    freeBlockPtr(collectorBlock);
 
     // swap with the last block so we compact as we go
-    m_heap.blocks[block] = m_heap.blocks[m_heap.usedBlocks - 1];
-    m_heap.usedBlocks--;
+    sizeClass.blocks[block] = sizeClass.blocks[sizeClass.usedBlocks - 1];
+    sizeClass.usedBlocks--;
+
+    // Blocks are only freed right after marking, when either none or all of them have been swept.
+    ASSERT(!sizeClass.sweptBlocks || sizeClass.sweptBlocks == sizeClass.usedBlocks + 1);
+    if (sizeClass.sweptBlocks)
+        sizeClass.sweptBlocks = sizeClass.usedBlocks;
 
-    if (m_heap.numBlocks > MIN_ARRAY_SIZE && m_heap.usedBlocks < m_heap.numBlocks / LOW_WATER_FACTOR) {
-        m_heap.numBlocks = m_heap.numBlocks / GROWTH_FACTOR; 
-        m_heap.blocks = static_cast<CollectorBlock**>(fastRealloc(m_heap.blocks, m_heap.numBlocks * sizeof(CollectorBlock*)));
+    if (sizeClass.numBlocks > MIN_ARRAY_SIZE && sizeClass.usedBlocks < sizeClass.numBlocks / LOW_WATER_FACTOR) {
+        sizeClass.numBlocks = sizeClass.numBlocks / GROWTH_FACTOR; 
+        sizeClass.blocks = static_cast<CollectorBlock**>(fastRealloc(sizeClass.blocks, sizeClass.numBlocks * sizeof(CollectorBlock*)));
     }
 }
 
@@ -313,10 +352,9 @@ void Heap::freeBlocks()
     for (ProtectCountSet::iterator it = protectedValuesCopy.begin(); it != protectedValuesEnd; ++it)
         markCell(it->first);
 
-    m_heap.nextCell = 0;
-    m_heap.nextBlock = 0;
-    DeadObjectIterator it(m_heap, m_heap.nextBlock, m_heap.nextCell);
-    DeadObjectIterator end(m_heap, m_heap.usedBlocks);
+    resetAllocator();
+    DeadObjectIterator it(m_heap, 0, 0);
+    DeadObjectIterator end(m_heap, NUM_SIZE_CLASSES - 1, m_heap.sizeClasses[NUM_SIZE_CLASSES - 1].usedBlocks);
     for ( ; it != end; ++it)
         (*it)->~JSCell();
 
@@ -326,10 +364,12 @@ void Heap::freeBlocks()
     for (ProtectCountSet::iterator it = protectedValuesCopy.begin(); it != protectedValuesEnd; ++it)
         it->first->~JSCell();
 
-    for (size_t block = 0; block < m_heap.usedBlocks; ++block)
-        freeBlockPtr(m_heap.blocks[block]);
-
-    fastFree(m_heap.blocks);
+    for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        CollectorSizeClass& sizeClass = m_heap.sizeClasses[i];
+        for (size_t block = 0; block < sizeClass.usedBlocks; ++block)
+            freeBlockPtr(sizeClass.blocks[block]);
+        fastFree(sizeClass.blocks);
+    }
 
     memset(&m_heap, 0, sizeof(CollectorHeap));
 }
@@ -347,25 +387,26 @@ void Heap::recordExtraCost(size_t cost)
     // if a large value survives one garbage collection, there is not much point to
     // collecting more frequently as long as it stays alive.
 
-    if (m_heap.extraCost > maxExtraCost && m_heap.extraCost > m_heap.usedBlocks * BLOCK_SIZE / 2) {
-        // If the last iteration through the heap deallocated blocks, we need
-        // to clean up remaining garbage before marking. Otherwise, the conservative
-        // marking mechanism might follow a pointer to unmapped memory.
-        if (m_heap.didShrink)
-            sweep();
+    if (m_heap.extraCost > maxExtraCost && m_heap.extraCost > usedBlocks() * BLOCK_SIZE / 2) {
         reset();
     }
     m_heap.extraCost += cost;
 }
 
+void Heap::setCollectorMode(CollectorMode mode)
+{
+    // Write barriers and card marking are maintained in both modes, so the
+    // mode can be switched between any two collections.
+    m_heap.collectorMode = mode;
+}
+
 void* Heap::allocate(size_t s)
 {
-    typedef HeapConstants::Block Block;
-    typedef HeapConstants::Cell Cell;
-    
     ASSERT(JSLock::lockCount() > 0);
     ASSERT(JSLock::currentThreadIsHoldingLock());
-    ASSERT_UNUSED(s, s <= HeapConstants::cellSize);
+
+    CollectorSizeClass& sizeClass = m_heap.sizeClasses[sizeClassFor(s)];
+    bool didCollect = false;
 
     ASSERT(m_heap.operationInProgress == NoOperation);
 
@@ -376,76 +417,94 @@ void* Heap::allocate(size_t s)
 
 allocate:
 
-    // Fast case: find the next garbage cell and recycle it.
-
-    do {
-        ASSERT(m_heap.nextBlock < m_heap.usedBlocks);
-        Block* block = reinterpret_cast<Block*>(m_heap.blocks[m_heap.nextBlock]);
+    // Fast case: find the next garbage cell of this size and recycle it.
+
+    for ( ; sizeClass.nextBlock < sizeClass.usedBlocks; ++sizeClass.nextBlock) {
+        CollectorBlock* block = sizeClass.blocks[sizeClass.nextBlock];
+        if (sizeClass.nextBlock == sizeClass.sweptBlocks) {
+            // Destroy the block's dead cells before handing any of them out.
+            ASSERT(!sizeClass.nextCell);
+            m_heap.operationInProgress = Allocation;
+            sweepBlock(sizeClass, block);
+            m_heap.operationInProgress = NoOperation;
+            ++sizeClass.sweptBlocks;
+            ++m_heap.lazilySweptBlocks;
+        }
         do {
-            ASSERT(m_heap.nextCell < HeapConstants::cellsPerBlock);
-            if (!block->marked.get(m_heap.nextCell)) { // Always false for the last cell in the block
-                Cell* cell = block->cells + m_heap.nextCell;
-
-                m_heap.operationInProgress = Allocation;
-                JSCell* imp = reinterpret_cast<JSCell*>(cell);
-                imp->~JSCell();
-                m_heap.operationInProgress = NoOperation;
-
-                ++m_heap.nextCell;
+            ASSERT(sizeClass.nextCell < sizeClass.cellsPerBlock);
+            if (!block->isCellMarked(sizeClass, sizeClass.nextCell)) { // Always false for the last cell in the block
+                JSCell* cell = block->cell(sizeClass, sizeClass.nextCell);
+                ++sizeClass.nextCell;
                 return cell;
             }
-        } while (++m_heap.nextCell != HeapConstants::cellsPerBlock);
-        m_heap.nextCell = 0;
-    } while (++m_heap.nextBlock != m_heap.usedBlocks);
+        } while (++sizeClass.nextCell != sizeClass.cellsPerBlock);
+        sizeClass.nextCell = 0;
+    }
 
-    // Slow case: reached the end of the heap. Mark live objects and start over.
+    // Slow case: reached the end of this size class. Give it another block
+    // if the heap has room for one, or if marking has not freed any of its
+    // cells; otherwise, mark live objects and start over.
+
+    if (didCollect || usedBlocks() < m_heap.maxBlocks) {
+        allocateBlock(sizeClass);
+        goto allocate;
+    }
 
     reset();
+    didCollect = true;
     goto allocate;
 }
 
+size_t Heap::usedBlocks() const
+{
+    size_t result = 0;
+    for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i)
+        result += m_heap.sizeClasses[i].usedBlocks;
+    return result;
+}
+
 void Heap::resizeBlocks()
 {
     m_heap.didShrink = false;
 
-    size_t usedCellCount = markedCells();
-    size_t minCellCount = usedCellCount + max(ALLOCATIONS_PER_COLLECTION, usedCellCount);
-    size_t minBlockCount = (minCellCount + HeapConstants::cellsPerBlock - 1) / HeapConstants::cellsPerBlock;
+    size_t liveBytes = 0;
+    for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        const CollectorSizeClass& sizeClass = m_heap.sizeClasses[i];
+        liveBytes += (markedCells(sizeClass) - sizeClass.usedBlocks) * sizeClass.cellSize; // 1 cell per block is a dummy sentinel
+    }
 
-    size_t maxCellCount = 1.25f * minCellCount;
-    size_t maxBlockCount = (maxCellCount + HeapConstants::cellsPerBlock - 1) / HeapConstants::cellsPerBlock;
+    // Blocks are added on demand, up to m_heap.maxBlocks.
+    size_t minBlocks = minBlockCount(liveBytes);
+    size_t maxBlocks = 1.25f * minBlocks;
 
-    if (m_heap.usedBlocks < minBlockCount)
-        growBlocks(minBlockCount);
-    else if (m_heap.usedBlocks > maxBlockCount)
-        shrinkBlocks(maxBlockCount);
-}
-
-void Heap::growBlocks(size_t neededBlocks)
-{
-    ASSERT(m_heap.usedBlocks < neededBlocks);
-    while (m_heap.usedBlocks < neededBlocks)
-        allocateBlock();
+    if (usedBlocks() > maxBlocks)
+        shrinkBlocks(maxBlocks);
+    m_heap.maxBlocks = max(minBlocks, usedBlocks());
 }
 
 void Heap::shrinkBlocks(size_t neededBlocks)
 {
-    ASSERT(m_heap.usedBlocks > neededBlocks);
+    ASSERT(usedBlocks() > neededBlocks);
     
-    // Clear the always-on last bit, so isEmpty() isn't fooled by it.
-    for (size_t i = 0; i < m_heap.usedBlocks; ++i)
-        m_heap.blocks[i]->marked.clear(HeapConstants::cellsPerBlock - 1);
-
-    for (size_t i = 0; i != m_heap.usedBlocks && m_heap.usedBlocks != neededBlocks; ) {
-        if (m_heap.blocks[i]->marked.isEmpty()) {
-            freeBlock(i);
-        } else
-            ++i;
-    }
+    for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        CollectorSizeClass& sizeClass = m_heap.sizeClasses[i];
+        size_t lastCellAtom = (sizeClass.cellsPerBlock - 1) * sizeClass.atomsPerCell;
+
+        // Clear the always-on last bit, so isEmpty() isn't fooled by it.
+        for (size_t block = 0; block < sizeClass.usedBlocks; ++block)
+            sizeClass.blocks[block]->marked.clear(lastCellAtom);
+
+        for (size_t block = 0; block != sizeClass.usedBlocks && usedBlocks() != neededBlocks; ) {
+            if (sizeClass.blocks[block]->marked.isEmpty()) {
+                freeBlock(sizeClass, block);
+            } else
+                ++block;
+        }
 
-    // Reset the always-on last bit.
-    for (size_t i = 0; i < m_heap.usedBlocks; ++i)
-        m_heap.blocks[i]->marked.set(HeapConstants::cellsPerBlock - 1);
+        // Reset the always-on last bit.
+        for (size_t block = 0; block < sizeClass.usedBlocks; ++block)
+            sizeClass.blocks[block]->marked.set(lastCellAtom);
+    }
 }
 
 #if OS(WINCE)
@@ -696,32 +755,18 @@ inline bool isPointerAligned(void* p)
     return (((intptr_t)(p) & (sizeof(char*) - 1)) == 0);
 }
 
-// Cell size needs to be a power of two for isPossibleCell to be valid.
-COMPILE_ASSERT(sizeof(CollectorCell) % 2 == 0, Collector_cell_size_is_power_of_two);
-
-#if USE(JSVALUE32)
-static bool isHalfCellAligned(void *p)
-{
-    return (((intptr_t)(p) & (CELL_MASK >> 1)) == 0);
-}
-
-static inline bool isPossibleCell(void* p)
-{
-    return isHalfCellAligned(p) && p;
-}
-
-#else
+// Atom size needs to be a power of two for isPossibleCell to be valid.
+COMPILE_ASSERT(!(sizeof(CollectorAtom) & (sizeof(CollectorAtom) - 1)), Collector_atom_size_is_power_of_two);
 
-static inline bool isCellAligned(void *p)
+static inline bool isAtomAligned(void* p)
 {
-    return (((intptr_t)(p) & CELL_MASK) == 0);
+    return (((intptr_t)(p) & ATOM_MASK) == 0);
 }
 
 static inline bool isPossibleCell(void* p)
 {
-    return isCellAligned(p) && p;
+    return isAtomAligned(p) && p;
 }
-#endif // USE(JSVALUE32)
 
 void Heap::markConservatively(MarkStack& markStack, void* start, void* end)
 {
@@ -738,31 +783,59 @@ void Heap::markConservatively(MarkStack& markStack, void* start, void* end)
     char** p = static_cast<char**>(start);
     char** e = static_cast<char**>(end);
 
-    CollectorBlock** blocks = m_heap.blocks;
     while (p != e) {
         char* x = *p++;
         if (isPossibleCell(x)) {
-            size_t usedBlocks;
             uintptr_t xAsBits = reinterpret_cast<uintptr_t>(x);
-            xAsBits &= CELL_ALIGN_MASK;
-
             uintptr_t offset = xAsBits & BLOCK_OFFSET_MASK;
-            const size_t lastCellOffset = sizeof(CollectorCell) * (CELLS_PER_BLOCK - 1);
-            if (offset > lastCellOffset)
-                continue;
-
             CollectorBlock* blockAddr = reinterpret_cast<CollectorBlock*>(xAsBits - offset);
-            usedBlocks = m_heap.usedBlocks;
-            for (size_t block = 0; block < usedBlocks; block++) {
-                if (blocks[block] != blockAddr)
+
+            for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+                const CollectorSizeClass& sizeClass = m_heap.sizeClasses[i];
+                if (offset & (sizeClass.cellSize - 1))
                     continue;
-                markStack.append(reinterpret_cast<JSCell*>(xAsBits));
-                markStack.drain();
+                const size_t lastCellOffset = sizeClass.cellSize * (sizeClass.cellsPerBlock - 1);
+                if (offset > lastCellOffset)
+                    continue;
+
+                CollectorBlock** blocks = sizeClass.blocks;
+                size_t usedBlocks = sizeClass.usedBlocks;
+                for (size_t block = 0; block < usedBlocks; block++) {
+                    if (blocks[block] != blockAddr)
+                        continue;
+                    markStack.append(reinterpret_cast<JSCell*>(xAsBits));
+                }
             }
         }
     }
 }
 
+bool Heap::isAllocatedCell(const void* p)
+{
+    if (!isPossibleCell(const_cast<void*>(p)))
+        return false;
+
+    uintptr_t pAsBits = reinterpret_cast<uintptr_t>(p);
+    uintptr_t offset = pAsBits & BLOCK_OFFSET_MASK;
+    CollectorBlock* blockAddr = reinterpret_cast<CollectorBlock*>(pAsBits - offset);
+
+    for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        const CollectorSizeClass& sizeClass = m_heap.sizeClasses[i];
+        if (offset & (sizeClass.cellSize - 1))
+            continue;
+        if (offset > sizeClass.cellSize * (sizeClass.cellsPerBlock - 1))
+            continue;
+
+        for (size_t block = 0; block < sizeClass.usedBlocks; ++block) {
+            if (sizeClass.blocks[block] != blockAddr)
+                continue;
+            // Freed cells are reset to dummy cells by the sweeper.
+            return reinterpret_cast<const JSCell*>(p)->structure() != m_globalData->dummyMarkableCellStructure.get();
+        }
+    }
+    return false;
+}
+
 void NEVER_INLINE Heap::markCurrentThreadConservativelyInternal(MarkStack& markStack)
 {
     void* dummy;
@@ -994,37 +1067,79 @@ bool Heap::unprotect(JSValue k)
 void Heap::markProtectedObjects(MarkStack& markStack)
 {
     ProtectCountSet::iterator end = m_protectedValues.end();
-    for (ProtectCountSet::iterator it = m_protectedValues.begin(); it != end; ++it) {
+    for (ProtectCountSet::iterator it = m_protectedValues.begin(); it != end; ++it)
         markStack.append(it->first);
-        markStack.drain();
-    }
 }
 
 void Heap::clearMarkBits()
 {
-    for (size_t i = 0; i < m_heap.usedBlocks; ++i)
-        clearMarkBits(m_heap.blocks[i]);
+    for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        CollectorSizeClass& sizeClass = m_heap.sizeClasses[i];
+        for (size_t block = 0; block < sizeClass.usedBlocks; ++block)
+            clearMarkBits(sizeClass, sizeClass.blocks[block]);
+    }
 }
 
-void Heap::clearMarkBits(CollectorBlock* block)
+void Heap::clearMarkBits(CollectorSizeClass& sizeClass, CollectorBlock* block)
 {
     // allocate assumes that the last cell in every block is marked.
     block->marked.clearAll();
-    block->marked.set(HeapConstants::cellsPerBlock - 1);
+    block->marked.set((sizeClass.cellsPerBlock - 1) * sizeClass.atomsPerCell);
+
+    // A full collection traces every live cell, so no card needs rescanning.
+    memset(block->cards, 0, sizeof(block->cards));
+}
+
+void Heap::markDirtyCards(MarkStack& markStack)
+{
+    // Every marked cell survived an earlier collection. Queue the marked cells
+    // on dirty cards so that their children are traced again; any other marked
+    // cell can only point to marked cells. Cards are cleaned before tracing, and
+    // MarkStack re-dirties the cards of cells whose children it cannot track
+    // through write barriers.
+    for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        CollectorSizeClass& sizeClass = m_heap.sizeClasses[i];
+        size_t cellsPerCard = CARD_SIZE / sizeClass.cellSize;
+        for (size_t block = 0; block < sizeClass.usedBlocks; ++block) {
+            CollectorBlock* collectorBlock = sizeClass.blocks[block];
+            for (size_t card = 0; card < CARDS_PER_BLOCK; ++card) {
+                if (!collectorBlock->cards[card])
+                    continue;
+                collectorBlock->cards[card] = 0;
+
+                size_t end = min((card + 1) * cellsPerCard, sizeClass.cellsPerBlock - 1);
+                for (size_t cellIndex = card * cellsPerCard; cellIndex < end; ++cellIndex) {
+                    if (!collectorBlock->isCellMarked(sizeClass, cellIndex))
+                        continue;
+                    JSCell* cell = collectorBlock->cell(sizeClass, cellIndex);
+                    if (cell->structure()->typeInfo().type() >= CompoundType)
+                        markStack.appendMarkedCell(cell);
+                }
+            }
+        }
+    }
+}
+
+size_t Heap::markedCells() const
+{
+    size_t result = 0;
+    for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i)
+        result += markedCells(m_heap.sizeClasses[i]);
+    return result;
 }
 
-size_t Heap::markedCells(size_t startBlock, size_t startCell) const
+size_t Heap::markedCells(const CollectorSizeClass& sizeClass, size_t startBlock, size_t startCell) const
 {
-    ASSERT(startBlock <= m_heap.usedBlocks);
-    ASSERT(startCell < HeapConstants::cellsPerBlock);
+    ASSERT(startBlock <= sizeClass.usedBlocks);
+    ASSERT(startCell < sizeClass.cellsPerBlock);
 
-    if (startBlock >= m_heap.usedBlocks)
+    if (startBlock >= sizeClass.usedBlocks)
         return 0;
 
     size_t result = 0;
-    result += m_heap.blocks[startBlock]->marked.count(startCell);
-    for (size_t i = startBlock + 1; i < m_heap.usedBlocks; ++i)
-        result += m_heap.blocks[i]->marked.count();
+    result += sizeClass.blocks[startBlock]->marked.count(startCell * sizeClass.atomsPerCell);
+    for (size_t i = startBlock + 1; i < sizeClass.usedBlocks; ++i)
+        result += sizeClass.blocks[i]->marked.count();
 
     return result;
 }
@@ -1035,15 +1150,31 @@ void Heap::sweep()
     if (m_heap.operationInProgress != NoOperation)
         CRASH();
     m_heap.operationInProgress = Collection;
-    
+
+    for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        CollectorSizeClass& sizeClass = m_heap.sizeClasses[i];
+        // Blocks that allocation has already reached were swept on the way.
+        ASSERT(sizeClass.nextBlock < sizeClass.sweptBlocks || !sizeClass.nextCell);
+        for ( ; sizeClass.sweptBlocks < sizeClass.usedBlocks; ++sizeClass.sweptBlocks) {
+            sweepBlock(sizeClass, sizeClass.blocks[sizeClass.sweptBlocks]);
+            ++m_heap.eagerlySweptBlocks;
+        }
+    }
+
+    m_heap.operationInProgress = NoOperation;
+}
+
+void Heap::sweepBlock(CollectorSizeClass& sizeClass, CollectorBlock* block)
+{
 #if !ENABLE(JSC_ZOMBIES)
     Structure* dummyMarkableCellStructure = m_globalData->dummyMarkableCellStructure.get();
 #endif
 
-    DeadObjectIterator it(m_heap, m_heap.nextBlock, m_heap.nextCell);
-    DeadObjectIterator end(m_heap, m_heap.usedBlocks);
-    for ( ; it != end; ++it) {
-        JSCell* cell = *it;
+    // The last cell in the block is always marked.
+    for (size_t i = 0; i < sizeClass.cellsPerBlock - 1; ++i) {
+        if (block->isCellMarked(sizeClass, i))
+            continue;
+        JSCell* cell = block->cell(sizeClass, i);
 #if ENABLE(JSC_ZOMBIES)
         if (!cell->isZombie()) {
             const ClassInfo* info = cell->classInfo();
@@ -1052,16 +1183,16 @@ void Heap::sweep()
             Heap::markCell(cell);
         }
 #else
+        if (cell->structure() == dummyMarkableCellStructure)
+            continue;
         cell->~JSCell();
         // Callers of sweep assume it's safe to mark any cell in the heap.
         new (cell) JSCell(dummyMarkableCellStructure);
 #endif
     }
-
-    m_heap.operationInProgress = NoOperation;
 }
 
-void Heap::markRoots()
+void Heap::markRoots(CollectionType collectionType)
 {
 #ifndef NDEBUG
     if (m_globalData->isSharedInstance) {
@@ -1074,12 +1205,23 @@ void Heap::markRoots()
     if (m_heap.operationInProgress != NoOperation)
         CRASH();
 
+#if ENABLE(SAMPLING_PROFILER)
+    // Samples may refer to host functions that this collection frees.
+    if (m_globalData->samplingProfiler)
+        m_globalData->samplingProfiler->processSamples();
+#endif
+
     m_heap.operationInProgress = Collection;
 
     MarkStack& markStack = m_globalData->markStack;
 
-    // Reset mark bits.
-    clearMarkBits();
+    if (collectionType == FullCollection) {
+        // Reset mark bits.
+        clearMarkBits();
+    } else {
+        // Keep mark bits, and trace from old cells that have been written to.
+        markDirtyCards(markStack);
+    }
 
     // Mark stack roots.
     markStackObjectsConservatively(markStack);
@@ -1098,6 +1240,15 @@ void Heap::markRoots()
     if (m_globalData->firstStringifierToMark)
         JSONObject::markStringifiers(markStack, m_globalData->firstStringifierToMark);
 
+    // Roots are only queued above, so that tracing from them can be spread
+    // across the marking threads.
+#if ENABLE(PARALLEL_MARKING)
+    if (usedBlocks() >= MIN_BLOCKS_FOR_PARALLEL_MARKING)
+        markStack.drainInParallel();
+    else
+#endif
+        markStack.drain();
+
     // Mark the small strings cache last, since it will clear itself if nothing
     // else has marked it.
     m_globalData->smallStrings.markChildren(markStack);
@@ -1110,16 +1261,26 @@ void Heap::markRoots()
 
 size_t Heap::objectCount() const
 {
-    return m_heap.nextBlock * HeapConstants::cellsPerBlock // allocated full blocks
-           + m_heap.nextCell // allocated cells in current block
-           + markedCells(m_heap.nextBlock, m_heap.nextCell) // marked cells in remainder of m_heap
-           - m_heap.usedBlocks; // 1 cell per block is a dummy sentinel
+    size_t result = 0;
+    for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i)
+        result += objectCount(m_heap.sizeClasses[i]);
+    return result;
+}
+
+size_t Heap::objectCount(const CollectorSizeClass& sizeClass) const
+{
+    return sizeClass.nextBlock * sizeClass.cellsPerBlock // allocated full blocks
+           + sizeClass.nextCell // allocated cells in current block
+           + markedCells(sizeClass, sizeClass.nextBlock, sizeClass.nextCell) // marked cells in remainder of the size class
+           - sizeClass.usedBlocks; // 1 cell per block is a dummy sentinel
 }
 
 void Heap::addToStatistics(Heap::Statistics& statistics) const
 {
-    statistics.size += m_heap.usedBlocks * BLOCK_SIZE;
-    statistics.free += m_heap.usedBlocks * BLOCK_SIZE - (objectCount() * HeapConstants::cellSize);
+    statistics.size += usedBlocks() * BLOCK_SIZE;
+    statistics.free += usedBlocks() * BLOCK_SIZE;
+    for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i)
+        statistics.free -= objectCount(m_heap.sizeClasses[i]) * m_heap.sizeClasses[i].cellSize;
 }
 
 Heap::Statistics Heap::statistics() const
@@ -1129,6 +1290,12 @@ Heap::Statistics Heap::statistics() const
     return statistics;
 }
 
+Heap::CollectionStatistics Heap::collectionStatistics() const
+{
+    CollectionStatistics statistics = { m_heap.fullCollections, m_heap.nurseryCollections, m_heap.fullCollectionTime, m_heap.nurseryCollectionTime, m_heap.lazilySweptBlocks, m_heap.eagerlySweptBlocks };
+    return statistics;
+}
+
 size_t Heap::globalObjectCount()
 {
     size_t count = 0;
@@ -1214,23 +1381,53 @@ void Heap::reset()
 {
     JAVASCRIPTCORE_GC_BEGIN();
 
-    markRoots();
+    CollectionType collectionType = NurseryCollection;
+#if ENABLE(JSC_ZOMBIES)
+    collectionType = FullCollection;
+#endif
+    if (m_heap.collectorMode == FullCollectorMode || m_heap.needsFullCollection)
+        collectionType = FullCollection;
+
+    // Allocation can reach here with blocks of other size classes not yet swept.
+    // If the last iteration through the heap deallocated blocks, their dead cells
+    // must be destroyed before marking. Otherwise, the conservative marking
+    // mechanism might follow a pointer from one of them to unmapped memory.
+    if (m_heap.didShrink)
+        sweep();
+
+    double startTime = currentTime();
+
+    markRoots(collectionType);
 
     JAVASCRIPTCORE_GC_MARKED();
 
-    m_heap.nextCell = 0;
-    m_heap.nextBlock = 0;
-    m_heap.nextNumber = 0;
+    resetAllocator();
     m_heap.extraCost = 0;
 #if ENABLE(JSC_ZOMBIES)
     sweep();
 #endif
     resizeBlocks();
 
+    // Cells that survive a nursery collection stay marked until the next full
+    // collection, even if they die in the meantime.
+    size_t markedCellCount = markedCells();
+    if (collectionType == FullCollection) {
+        m_heap.markedCellsAfterFullCollection = markedCellCount;
+        m_heap.needsFullCollection = false;
+        ++m_heap.fullCollections;
+        m_heap.fullCollectionTime += currentTime() - startTime;
+        m_globalData->regExpCache.pruneUnusedEntries();
+    } else {
+        size_t limit = max(ALLOCATIONS_PER_COLLECTION, m_heap.markedCellsAfterFullCollection) * OLD_GENERATION_GROWTH_FACTOR;
+        m_heap.needsFullCollection = markedCellCount > limit;
+        ++m_heap.nurseryCollections;
+        m_heap.nurseryCollectionTime += currentTime() - startTime;
+    }
+
     JAVASCRIPTCORE_GC_END();
 }
 
-void Heap::collectAllGarbage()
+void Heap::collectAllGarbage(SweepToggle sweepToggle)
 {
     JAVASCRIPTCORE_GC_BEGIN();
 
@@ -1240,28 +1437,45 @@ void Heap::collectAllGarbage()
     if (m_heap.didShrink)
         sweep();
 
-    markRoots();
+    double startTime = currentTime();
+
+    markRoots(FullCollection);
 
     JAVASCRIPTCORE_GC_MARKED();
 
-    m_heap.nextCell = 0;
-    m_heap.nextBlock = 0;
-    m_heap.nextNumber = 0;
+    resetAllocator();
     m_heap.extraCost = 0;
-    sweep();
+    if (sweepToggle == DoSweep)
+        sweep();
     resizeBlocks();
 
+    m_heap.markedCellsAfterFullCollection = markedCells();
+    m_heap.needsFullCollection = false;
+    ++m_heap.fullCollections;
+    m_heap.fullCollectionTime += currentTime() - startTime;
+    m_globalData->regExpCache.pruneUnusedEntries();
+
     JAVASCRIPTCORE_GC_END();
 }
 
+void Heap::resetAllocator()
+{
+    for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        CollectorSizeClass& sizeClass = m_heap.sizeClasses[i];
+        sizeClass.nextCell = 0;
+        sizeClass.nextBlock = 0;
+        sizeClass.sweptBlocks = 0;
+    }
+}
+
 LiveObjectIterator Heap::primaryHeapBegin()
 {
-    return LiveObjectIterator(m_heap, 0);
+    return LiveObjectIterator(m_heap, 0, 0);
 }
 
 LiveObjectIterator Heap::primaryHeapEnd()
 {
-    return LiveObjectIterator(m_heap, m_heap.usedBlocks);
+    return LiveObjectIterator(m_heap, NUM_SIZE_CLASSES - 1, m_heap.sizeClasses[NUM_SIZE_CLASSES - 1].usedBlocks);
 }
 
 } // namespace JSC
@@ -39,7 +39,7 @@
 #include <wtf/symbian/BlockAllocatorSymbian.h>
 #endif
 
-#define ASSERT_CLASS_FITS_IN_CELL(class) COMPILE_ASSERT(sizeof(class) <= CELL_SIZE, class_fits_in_cell)
+#define ASSERT_CLASS_FITS_IN_CELL(class) COMPILE_ASSERT(sizeof(class) <= MAX_CELL_SIZE, class_fits_in_cell)
 
 namespace JSC {
 
@@ -52,21 +52,58 @@ namespace JSC {
 
     enum OperationInProgress { NoOperation, Allocation, Collection };
 
+    // In GenerationalCollectorMode, most collections are nursery collections:
+    // mark bits are left set from the previous collection, so only cells
+    // allocated since then, plus cells on cards dirtied by Heap::writeBarrier(),
+    // are traced. FullCollectorMode always traces the entire heap.
+    enum CollectorMode { FullCollectorMode, GenerationalCollectorMode };
+    enum CollectionType { FullCollection, NurseryCollection };
+
+    // Dead cells are normally destroyed a block at a time, as allocation first
+    // reaches each block after a collection. DoSweep destroys all of them
+    // before the collection returns, so that their finalizers have run.
+    enum SweepToggle { DoNotSweep, DoSweep };
+
     class LiveObjectIterator;
 
-    struct CollectorHeap {
+    // Cells of each size class are allocated from blocks of their own.
+    struct CollectorSizeClass {
+        size_t cellSize;
+        size_t atomsPerCell;
+        size_t cellsPerBlock;
+
         size_t nextBlock;
         size_t nextCell;
         CollectorBlock** blocks;
-        
-        void* nextNumber;
 
         size_t numBlocks;
         size_t usedBlocks;
 
+        size_t sweptBlocks; // Blocks below this index have had their dead cells destroyed.
+    };
+
+    const size_t NUM_SIZE_CLASSES = 2;
+
+    struct CollectorHeap {
+        CollectorSizeClass sizeClasses[NUM_SIZE_CLASSES];
+
+        size_t maxBlocks; // Allocating beyond this many blocks triggers a collection.
+
         size_t extraCost;
         bool didShrink;
 
+        size_t lazilySweptBlocks;
+        size_t eagerlySweptBlocks;
+
+        CollectorMode collectorMode;
+        bool needsFullCollection;
+        size_t markedCellsAfterFullCollection;
+
+        size_t fullCollections;
+        size_t nurseryCollections;
+        double fullCollectionTime;
+        double nurseryCollectionTime;
+
         OperationInProgress operationInProgress;
     };
 
@@ -79,8 +116,10 @@ namespace JSC {
         void* allocateNumber(size_t);
         void* allocate(size_t);
 
+        static size_t sizeClassFor(size_t);
+
         bool isBusy(); // true if an allocation or collection is in progress
-        void collectAllGarbage();
+        void collectAllGarbage(SweepToggle = DoSweep);
 
         static const size_t minExtraCost = 256;
         static const size_t maxExtraCost = 1024 * 1024;
@@ -94,6 +133,19 @@ namespace JSC {
         };
         Statistics statistics() const;
 
+        void setCollectorMode(CollectorMode);
+        CollectorMode collectorMode() const { return m_heap.collectorMode; }
+
+        struct CollectionStatistics {
+            size_t fullCollections;
+            size_t nurseryCollections;
+            double fullCollectionTime; // seconds
+            double nurseryCollectionTime; // seconds
+            size_t lazilySweptBlocks; // swept by the allocator
+            size_t eagerlySweptBlocks; // swept by the collector
+        };
+        CollectionStatistics collectionStatistics() const;
+
         void protect(JSValue);
         // Returns true if the value is no longer protected by any protect pointers
         // (though it may still be alive due to heap/stack references).
@@ -112,8 +164,20 @@ namespace JSC {
 
         static bool isCellMarked(const JSCell*);
         static void markCell(JSCell*);
+#if ENABLE(PARALLEL_MARKING)
+        static bool markCellAtomically(JSCell*); // Returns false if another thread marked the cell first.
+#endif
+
+        // Records a store into a cell that may already be marked, so that the
+        // next nursery collection rescans it. Unmarked cells are traced by the
+        // next collection anyway, so stores into them leave the card clean.
+        // No collection may happen between the store and the barrier.
+        static void writeBarrier(const JSCell*);
 
         void markConservatively(MarkStack&, void* start, void* end);
+        // True if p points to a cell of this heap that has not been swept since
+        // it was last allocated; such a cell is safe to read, even if garbage.
+        bool isAllocatedCell(const void* p);
 
         HashSet<MarkedArgumentBuffer*>& markListSet() { if (!m_markListSet) m_markListSet = new HashSet<MarkedArgumentBuffer*>; return *m_markListSet; }
 
@@ -126,29 +190,35 @@ namespace JSC {
     private:
         void reset();
         void sweep();
+        void sweepBlock(CollectorSizeClass&, CollectorBlock*);
         static CollectorBlock* cellBlock(const JSCell*);
         static size_t cellOffset(const JSCell*);
+        static size_t cardOffset(const JSCell*);
 
         friend class JSGlobalData;
         Heap(JSGlobalData*);
         ~Heap();
 
-        NEVER_INLINE CollectorBlock* allocateBlock();
-        NEVER_INLINE void freeBlock(size_t);
+        NEVER_INLINE CollectorBlock* allocateBlock(CollectorSizeClass&);
+        NEVER_INLINE void freeBlock(CollectorSizeClass&, size_t);
         NEVER_INLINE void freeBlockPtr(CollectorBlock*);
         void freeBlocks();
         void resizeBlocks();
-        void growBlocks(size_t neededBlocks);
         void shrinkBlocks(size_t neededBlocks);
         void clearMarkBits();
-        void clearMarkBits(CollectorBlock*);
-        size_t markedCells(size_t startBlock = 0, size_t startCell = 0) const;
+        void clearMarkBits(CollectorSizeClass&, CollectorBlock*);
+        size_t markedCells() const;
+        size_t markedCells(const CollectorSizeClass&, size_t startBlock = 0, size_t startCell = 0) const;
+        size_t usedBlocks() const;
+        size_t objectCount(const CollectorSizeClass&) const;
+        void resetAllocator();
 
         void recordExtraCost(size_t);
 
         void addToStatistics(Statistics&) const;
 
-        void markRoots();
+        void markRoots(CollectionType);
+        void markDirtyCards(MarkStack&);
         void markProtectedObjects(MarkStack&);
         void markCurrentThreadConservatively(MarkStack&);
         void markCurrentThreadConservativelyInternal(MarkStack&);
@@ -206,11 +276,25 @@ namespace JSC {
     const size_t CELL_ARRAY_LENGTH = (MINIMUM_CELL_SIZE / sizeof(double)) + (MINIMUM_CELL_SIZE % sizeof(double) != 0 ? sizeof(double) : 0);
     const size_t CELL_SIZE = CELL_ARRAY_LENGTH * sizeof(double);
     const size_t SMALL_CELL_SIZE = CELL_SIZE / 2;
-    const size_t CELL_MASK = CELL_SIZE - 1;
-    const size_t CELL_ALIGN_MASK = ~CELL_MASK;
-    const size_t CELLS_PER_BLOCK = (BLOCK_SIZE - sizeof(Heap*)) * 8 * CELL_SIZE / (8 * CELL_SIZE + 1) / CELL_SIZE; // one bitmap byte can represent 8 cells.
+    const size_t MAX_CELL_SIZE = CELL_SIZE;
+
+    // Blocks are laid out in atoms the size of the smallest cell, and have a
+    // mark bit per atom, so that a cell's mark bit can be found from its
+    // address without knowing its size class.
+    const size_t ATOM_SIZE = SMALL_CELL_SIZE;
+    const size_t ATOM_MASK = ATOM_SIZE - 1;
+
+    // Each block is divided into cards for the generational write barrier;
+    // a card's entry in the block's card table is non-zero when the cells on it
+    // must be rescanned by the next nursery collection.
+    const size_t CARD_SHIFT = 10; // 1k
+    const size_t CARD_SIZE = 1 << CARD_SHIFT;
+    const size_t CARD_OFFSET_MASK = CARD_SIZE - 1;
+    const size_t CARDS_PER_BLOCK = BLOCK_SIZE / CARD_SIZE;
+
+    const size_t ATOMS_PER_BLOCK = (BLOCK_SIZE - sizeof(Heap*) - CARDS_PER_BLOCK * sizeof(uint32_t)) * 8 * ATOM_SIZE / (8 * ATOM_SIZE + 1) / ATOM_SIZE; // one bitmap byte can represent 8 atoms.
     
-    const size_t BITMAP_SIZE = (CELLS_PER_BLOCK + 7) / 8;
+    const size_t BITMAP_SIZE = (ATOMS_PER_BLOCK + 7) / 8;
     const size_t BITMAP_WORDS = (BITMAP_SIZE + 3) / sizeof(uint32_t);
 
     struct CollectorBitmap {
@@ -218,15 +302,22 @@ namespace JSC {
         bool get(size_t n) const { return !!(bits[n >> 5] & (1 << (n & 0x1F))); } 
         void set(size_t n) { bits[n >> 5] |= (1 << (n & 0x1F)); } 
         void clear(size_t n) { bits[n >> 5] &= ~(1 << (n & 0x1F)); } 
+#if ENABLE(PARALLEL_MARKING)
+        bool testAndSetAtomically(size_t n)
+        {
+            uint32_t mask = 1 << (n & 0x1F);
+            return __sync_fetch_and_or(&bits[n >> 5], mask) & mask;
+        }
+#endif
         void clearAll() { memset(bits, 0, sizeof(bits)); }
-        size_t count(size_t startCell = 0)
+        size_t count(size_t startAtom = 0)
         {
             size_t result = 0;
-            for ( ; (startCell & 0x1F) != 0; ++startCell) {
-                if (get(startCell))
+            for ( ; (startAtom & 0x1F) != 0; ++startAtom) {
+                if (get(startAtom))
                     ++result;
             }
-            for (size_t i = startCell >> 5; i < BITMAP_WORDS; ++i)
+            for (size_t i = startAtom >> 5; i < BITMAP_WORDS; ++i)
                 result += WTF::bitCount(bits[i]);
             return result;
         }
@@ -239,23 +330,38 @@ namespace JSC {
         }
     };
   
+    struct CollectorAtom {
+        double memory[ATOM_SIZE / sizeof(double)];
+    };
+
+    // Storage for a cell of any size class.
     struct CollectorCell {
-        double memory[CELL_ARRAY_LENGTH];
+        double memory[MAX_CELL_SIZE / sizeof(double)];
     };
 
     class CollectorBlock {
     public:
-        CollectorCell cells[CELLS_PER_BLOCK];
+        JSCell* cell(const CollectorSizeClass& sizeClass, size_t index)
+        {
+            return reinterpret_cast<JSCell*>(reinterpret_cast<char*>(atoms) + index * sizeClass.cellSize);
+        }
+
+        bool isCellMarked(const CollectorSizeClass& sizeClass, size_t index) const
+        {
+            return marked.get(index * sizeClass.atomsPerCell);
+        }
+
+        CollectorAtom atoms[ATOMS_PER_BLOCK];
         CollectorBitmap marked;
+        uint32_t cards[CARDS_PER_BLOCK]; // Written directly by JIT code; see JIT::emitWriteBarrier().
         Heap* heap;
     };
 
-    struct HeapConstants {
-        static const size_t cellSize = CELL_SIZE;
-        static const size_t cellsPerBlock = CELLS_PER_BLOCK;
-        typedef CollectorCell Cell;
-        typedef CollectorBlock Block;
-    };
+    inline size_t Heap::sizeClassFor(size_t size)
+    {
+        ASSERT(size <= MAX_CELL_SIZE);
+        return size <= SMALL_CELL_SIZE ? 0 : 1;
+    }
 
     inline CollectorBlock* Heap::cellBlock(const JSCell* cell)
     {
@@ -264,7 +370,12 @@ namespace JSC {
 
     inline size_t Heap::cellOffset(const JSCell* cell)
     {
-        return (reinterpret_cast<uintptr_t>(cell) & BLOCK_OFFSET_MASK) / CELL_SIZE;
+        return (reinterpret_cast<uintptr_t>(cell) & BLOCK_OFFSET_MASK) / ATOM_SIZE;
+    }
+
+    inline size_t Heap::cardOffset(const JSCell* cell)
+    {
+        return (reinterpret_cast<uintptr_t>(cell) & BLOCK_OFFSET_MASK) >> CARD_SHIFT;
     }
 
     inline bool Heap::isCellMarked(const JSCell* cell)
@@ -277,6 +388,20 @@ namespace JSC {
         cellBlock(cell)->marked.set(cellOffset(cell));
     }
 
+#if ENABLE(PARALLEL_MARKING)
+    inline bool Heap::markCellAtomically(JSCell* cell)
+    {
+        return !cellBlock(cell)->marked.testAndSetAtomically(cellOffset(cell));
+    }
+#endif
+
+    inline void Heap::writeBarrier(const JSCell* cell)
+    {
+        CollectorBlock* block = cellBlock(cell);
+        if (block->marked.get(cellOffset(cell)))
+            block->cards[cardOffset(cell)] = 1;
+    }
+
     inline void Heap::reportExtraMemoryCost(size_t cost)
     {
         if (cost > minExtraCost) 
@@ -285,14 +410,9 @@ namespace JSC {
     
     inline void* Heap::allocateNumber(size_t s)
     {
-        if (void* result = m_heap.nextNumber) {
-            m_heap.nextNumber = 0;
-            return result;
-        }
-
-        void* result = allocate(s);
-        m_heap.nextNumber = static_cast<char*>(result) + (CELL_SIZE / 2);
-        return result;
+        // Numbers fit in the smallest size class.
+        ASSERT(s <= SMALL_CELL_SIZE);
+        return allocate(s);
     }
 
 } // namespace JSC
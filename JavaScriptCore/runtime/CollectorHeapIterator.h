@@ -31,40 +31,45 @@
 
 namespace JSC {
 
+    // Iterates the cells of each size class in turn.
     class CollectorHeapIterator {
     public:
         bool operator!=(const CollectorHeapIterator& other);
         JSCell* operator*() const;
     
     protected:
-        CollectorHeapIterator(CollectorHeap&, size_t startBlock, size_t startCell);
-        void advance(size_t max);
+        CollectorHeapIterator(CollectorHeap&, size_t sizeClass, size_t startBlock, size_t startCell);
+        void advance();
+        bool atEnd() const;
+        bool isMarked() const;
 
         CollectorHeap& m_heap;
+        size_t m_sizeClass;
         size_t m_block;
         size_t m_cell;
     };
 
     class LiveObjectIterator : public CollectorHeapIterator {
     public:
-        LiveObjectIterator(CollectorHeap&, size_t startBlock, size_t startCell = 0);
+        LiveObjectIterator(CollectorHeap&, size_t sizeClass, size_t startBlock, size_t startCell = 0);
         LiveObjectIterator& operator++();
     };
 
     class DeadObjectIterator : public CollectorHeapIterator {
     public:
-        DeadObjectIterator(CollectorHeap&, size_t startBlock, size_t startCell = 0);
+        DeadObjectIterator(CollectorHeap&, size_t sizeClass, size_t startBlock, size_t startCell = 0);
         DeadObjectIterator& operator++();
     };
 
     class ObjectIterator : public CollectorHeapIterator {
     public:
-        ObjectIterator(CollectorHeap&, size_t startBlock, size_t startCell = 0);
+        ObjectIterator(CollectorHeap&, size_t sizeClass, size_t startBlock, size_t startCell = 0);
         ObjectIterator& operator++();
     };
 
-    inline CollectorHeapIterator::CollectorHeapIterator(CollectorHeap& heap, size_t startBlock, size_t startCell)
+    inline CollectorHeapIterator::CollectorHeapIterator(CollectorHeap& heap, size_t sizeClass, size_t startBlock, size_t startCell)
         : m_heap(heap)
+        , m_sizeClass(sizeClass)
         , m_block(startBlock)
         , m_cell(startCell)
     {
@@ -72,44 +77,65 @@ namespace JSC {
 
     inline bool CollectorHeapIterator::operator!=(const CollectorHeapIterator& other)
     {
-        return m_block != other.m_block || m_cell != other.m_cell;
+        return m_sizeClass != other.m_sizeClass || m_block != other.m_block || m_cell != other.m_cell;
     }
 
     inline JSCell* CollectorHeapIterator::operator*() const
     {
-        return reinterpret_cast<JSCell*>(m_heap.blocks[m_block]->cells + m_cell);
+        const CollectorSizeClass& sizeClass = m_heap.sizeClasses[m_sizeClass];
+        return sizeClass.blocks[m_block]->cell(sizeClass, m_cell);
     }
     
     // Iterators advance up to the next-to-last -- and not the last -- cell in a
-    // block, since the last cell is a dummy sentinel.
-    inline void CollectorHeapIterator::advance(size_t max)
+    // block, since the last cell is a dummy sentinel. The end of one size class
+    // is the beginning of the next; the end of the last size class is the end
+    // of the heap.
+    inline void CollectorHeapIterator::advance()
     {
         ++m_cell;
-        if (m_cell == max) {
+        if (m_cell == m_heap.sizeClasses[m_sizeClass].cellsPerBlock - 1) {
             m_cell = 0;
             ++m_block;
         }
+        while (m_block == m_heap.sizeClasses[m_sizeClass].usedBlocks && m_sizeClass != NUM_SIZE_CLASSES - 1) {
+            m_cell = 0;
+            m_block = 0;
+            ++m_sizeClass;
+        }
+    }
+
+    inline bool CollectorHeapIterator::atEnd() const
+    {
+        return m_block >= m_heap.sizeClasses[m_sizeClass].usedBlocks;
     }
 
-    inline LiveObjectIterator::LiveObjectIterator(CollectorHeap& heap, size_t startBlock, size_t startCell)
-        : CollectorHeapIterator(heap, startBlock, startCell - 1)
+    inline bool CollectorHeapIterator::isMarked() const
+    {
+        const CollectorSizeClass& sizeClass = m_heap.sizeClasses[m_sizeClass];
+        return sizeClass.blocks[m_block]->isCellMarked(sizeClass, m_cell);
+    }
+
+    inline LiveObjectIterator::LiveObjectIterator(CollectorHeap& heap, size_t sizeClass, size_t startBlock, size_t startCell)
+        : CollectorHeapIterator(heap, sizeClass, startBlock, startCell - 1)
     {
         ++(*this);
     }
 
     inline LiveObjectIterator& LiveObjectIterator::operator++()
     {
-        advance(HeapConstants::cellsPerBlock - 1);
-        if (m_block < m_heap.nextBlock || (m_block == m_heap.nextBlock && m_cell < m_heap.nextCell))
-            return *this;
-
-        while (m_block < m_heap.usedBlocks && !m_heap.blocks[m_block]->marked.get(m_cell))
-            advance(HeapConstants::cellsPerBlock - 1);
+        do {
+            advance();
+            if (atEnd())
+                return *this;
+            const CollectorSizeClass& sizeClass = m_heap.sizeClasses[m_sizeClass];
+            if (m_block < sizeClass.nextBlock || (m_block == sizeClass.nextBlock && m_cell < sizeClass.nextCell))
+                return *this;
+        } while (!isMarked());
         return *this;
     }
 
-    inline DeadObjectIterator::DeadObjectIterator(CollectorHeap& heap, size_t startBlock, size_t startCell)
-        : CollectorHeapIterator(heap, startBlock, startCell - 1)
+    inline DeadObjectIterator::DeadObjectIterator(CollectorHeap& heap, size_t sizeClass, size_t startBlock, size_t startCell)
+        : CollectorHeapIterator(heap, sizeClass, startBlock, startCell - 1)
     {
         ++(*this);
     }
@@ -117,21 +143,21 @@ namespace JSC {
     inline DeadObjectIterator& DeadObjectIterator::operator++()
     {
         do {
-            advance(HeapConstants::cellsPerBlock - 1);
-            ASSERT(m_block > m_heap.nextBlock || (m_block == m_heap.nextBlock && m_cell >= m_heap.nextCell));
-        } while (m_block < m_heap.usedBlocks && m_heap.blocks[m_block]->marked.get(m_cell));
+            advance();
+            ASSERT(atEnd() || m_block > m_heap.sizeClasses[m_sizeClass].nextBlock || (m_block == m_heap.sizeClasses[m_sizeClass].nextBlock && m_cell >= m_heap.sizeClasses[m_sizeClass].nextCell));
+        } while (!atEnd() && isMarked());
         return *this;
     }
 
-    inline ObjectIterator::ObjectIterator(CollectorHeap& heap, size_t startBlock, size_t startCell)
-        : CollectorHeapIterator(heap, startBlock, startCell - 1)
+    inline ObjectIterator::ObjectIterator(CollectorHeap& heap, size_t sizeClass, size_t startBlock, size_t startCell)
+        : CollectorHeapIterator(heap, sizeClass, startBlock, startCell - 1)
     {
         ++(*this);
     }
 
     inline ObjectIterator& ObjectIterator::operator++()
     {
-        advance(HeapConstants::cellsPerBlock - 1);
+        advance();
         return *this;
     }
 
@@ -26,6 +26,7 @@
 #include "config.h"
 #include "Executable.h"
 
+#include "BytecodeCache.h"
 #include "BytecodeGenerator.h"
 #include "CodeBlock.h"
 #include "JIT.h"
@@ -115,23 +116,43 @@ JSObject* ProgramExecutable::compile(ExecState* exec, ScopeChainNode* scopeChain
 void FunctionExecutable::compile(ExecState*, ScopeChainNode* scopeChainNode)
 {
     JSGlobalData* globalData = scopeChainNode->globalData;
+    ScopeChain scopeChain(scopeChainNode);
+    JSGlobalObject* globalObject = scopeChain.globalObject();
+    ASSERT(!m_codeBlock);
+
+    // Cached code has no debug hooks, and isn't what -d asks to see.
+    BytecodeCache* bytecodeCache = globalData->bytecodeCache.get();
+    if (globalObject->debugger() || BytecodeGenerator::dumpsGeneratedCode())
+        bytecodeCache = 0;
+    if (bytecodeCache && bytecodeCache->decode(this, scopeChain)) {
+        m_numParameters = m_codeBlock->m_numParameters;
+        ASSERT(m_numParameters);
+        m_numVariables = m_codeBlock->m_numVars;
+        return;
+    }
+
     RefPtr<FunctionBodyNode> body = globalData->parser->parse<FunctionBodyNode>(globalData, 0, 0, m_source);
     if (m_forceUsesArguments)
         body->setUsesArguments();
     body->finishParsing(m_parameters, m_name);
     recordParse(body->features(), body->lineNo(), body->lastLine());
 
-    ScopeChain scopeChain(scopeChainNode);
-    JSGlobalObject* globalObject = scopeChain.globalObject();
-
-    ASSERT(!m_codeBlock);
     m_codeBlock = new FunctionCodeBlock(this, FunctionCode, source().provider(), source().startOffset());
     OwnPtr<BytecodeGenerator> generator(new BytecodeGenerator(body.get(), globalObject->debugger(), scopeChain, m_codeBlock->symbolTable(), m_codeBlock));
+    if (bytecodeCache)
+        generator->setRecordsScopedPropertyLookups();
     generator->generate();
     m_numParameters = m_codeBlock->m_numParameters;
     ASSERT(m_numParameters);
     m_numVariables = m_codeBlock->m_numVars;
 
+    if (bytecodeCache) {
+        bytecodeCache->encode(this, scopeChain, generator->scopedPropertyLookups());
+#if !ENABLE(OPCODE_SAMPLING)
+        m_codeBlock->clearExceptionInfo();
+#endif
+    }
+
     body->destroyData();
 }
 
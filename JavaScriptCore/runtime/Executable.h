@@ -82,10 +82,10 @@ namespace JSC {
 #if ENABLE(JIT)
     class NativeExecutable : public ExecutableBase {
     public:
-        NativeExecutable(ExecState* exec)
+        NativeExecutable(ExecState* exec, NativeFunction function)
             : ExecutableBase(NUM_PARAMETERS_IS_HOST)
         {
-            m_jitCode = JITCode(JITCode::HostFunction(exec->globalData().jitStubs.ctiNativeCallThunk()));
+            m_jitCode = JITCode(JITCode::HostFunction(exec->globalData().jitStubs.hostFunctionStub(function)));
         }
 
         ~NativeExecutable();
@@ -244,6 +244,7 @@ namespace JSC {
     };
 
     class FunctionExecutable : public ScriptExecutable {
+        friend class BytecodeCache;
         friend class JIT;
     public:
         static PassRefPtr<FunctionExecutable> create(ExecState* exec, const Identifier& name, const SourceCode& source, bool forceUsesArguments, FunctionParameters* parameters, int firstLine, int lastLine)
@@ -41,7 +41,7 @@ namespace JSC {
         }
 
     protected:
-        static const unsigned StructureFlags = ImplementsHasInstance | OverridesMarkChildren | OverridesGetPropertyNames | PrototypeFunction::StructureFlags;
+        static const unsigned StructureFlags = ImplementsHasInstance | OverridesMarkChildren | OverridesGetPropertyNames | HasWriteBarrieredChildren | PrototypeFunction::StructureFlags;
 
     private:
         virtual void markChildren(MarkStack&);
@@ -33,6 +33,7 @@
 #include "dtoa.h"
 #include "Identifier.h"
 #include "JSGlobalObject.h"
+#include "SamplingProfiler.h"
 #include "UString.h"
 #include <wtf/DateMath.h>
 #include <wtf/Threading.h>
@@ -41,7 +42,7 @@ using namespace WTF;
 
 namespace JSC {
 
-#if OS(DARWIN) && ENABLE(JSC_MULTIPLE_THREADS)
+#if USE(PTHREADS)
 static pthread_once_t initializeThreadingKeyOnce = PTHREAD_ONCE_INIT;
 #endif
 
@@ -54,11 +55,15 @@ static void initializeThreadingOnce()
     s_dtoaP5Mutex = new Mutex;
     initializeDates();
 #endif
+#if ENABLE(SAMPLING_PROFILER)
+    SamplingProfiler::initializeThreading();
+#endif
 }
 
 void initializeThreading()
 {
-#if OS(DARWIN) && ENABLE(JSC_MULTIPLE_THREADS)
+    // Embedders may create their first context groups on several threads at once.
+#if USE(PTHREADS)
     pthread_once(&initializeThreadingKeyOnce, initializeThreadingOnce);
 #else
     static bool initializedThreading = false;
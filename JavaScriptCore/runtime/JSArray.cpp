@@ -28,10 +28,11 @@
 #include "Error.h"
 #include "Executable.h"
 #include "PropertyNameArray.h"
-#include <wtf/AVLTree.h>
 #include <wtf/Assertions.h>
 #include <wtf/OwnPtr.h>
 #include <Operations.h>
+#include <algorithm>
+#include <functional>
 
 #define CHECK_ARRAY_CONSISTENCY 0
 
@@ -137,6 +138,7 @@ JSArray::JSArray(NonNullPassRefPtr<Structure> structure)
 
     m_storage = static_cast<ArrayStorage*>(fastZeroedMalloc(storageSize(initialCapacity)));
     m_vectorLength = initialCapacity;
+    m_indexBias = 0;
 
     checkConsistency();
 }
@@ -149,6 +151,7 @@ JSArray::JSArray(NonNullPassRefPtr<Structure> structure, unsigned initialLength)
     m_storage = static_cast<ArrayStorage*>(fastMalloc(storageSize(initialCapacity)));
     m_storage->m_length = initialLength;
     m_vectorLength = initialCapacity;
+    m_indexBias = 0;
     m_storage->m_numValuesInVector = 0;
     m_storage->m_sparseValueMap = 0;
     m_storage->subclassData = 0;
@@ -171,6 +174,7 @@ JSArray::JSArray(NonNullPassRefPtr<Structure> structure, const ArgList& list)
     m_storage = static_cast<ArrayStorage*>(fastMalloc(storageSize(initialCapacity)));
     m_storage->m_length = initialCapacity;
     m_vectorLength = initialCapacity;
+    m_indexBias = 0;
     m_storage->m_numValuesInVector = initialCapacity;
     m_storage->m_sparseValueMap = 0;
     m_storage->subclassData = 0;
@@ -192,7 +196,7 @@ JSArray::~JSArray()
     checkConsistency(DestructorConsistencyCheck);
 
     delete m_storage->m_sparseValueMap;
-    fastFree(m_storage);
+    fastFree(storageBase());
 }
 
 bool JSArray::getOwnPropertySlot(ExecState* exec, unsigned i, PropertySlot& slot)
@@ -296,6 +300,7 @@ void JSArray::put(ExecState* exec, const Identifier& propertyName, JSValue value
 void JSArray::put(ExecState* exec, unsigned i, JSValue value)
 {
     checkConsistency();
+    Heap::writeBarrier(this);
 
     unsigned length = m_storage->m_length;
     if (i >= length && i <= MAX_ARRAY_INDEX) {
@@ -388,6 +393,10 @@ NEVER_INLINE void JSArray::putSlowCase(ExecState* exec, unsigned i, JSValue valu
         }
     }
 
+    if (m_indexBias) {
+        removeIndexBias();
+        storage = m_storage;
+    }
     if (!tryFastRealloc(storage, storageSize(newVectorLength)).getValue(storage)) {
         throwOutOfMemoryError(exec);
         return;
@@ -495,11 +504,23 @@ void JSArray::getOwnPropertyNames(ExecState* exec, PropertyNameArray& propertyNa
     JSObject::getOwnPropertyNames(exec, propertyNames, mode);
 }
 
+void JSArray::removeIndexBias()
+{
+    // Move the storage back to the start of its allocation, so that it can be reallocated.
+    ASSERT(m_indexBias);
+    void* base = storageBase();
+    memmove(base, m_storage, storageSize(m_vectorLength));
+    m_storage = static_cast<ArrayStorage*>(base);
+    m_indexBias = 0;
+}
+
 bool JSArray::increaseVectorLength(unsigned newLength)
 {
     // This function leaves the array in an internally inconsistent state, because it does not move any values from sparse value map
     // to the vector. Callers have to account for that, because they can do it more efficiently.
 
+    if (m_indexBias)
+        removeIndexBias();
     ArrayStorage* storage = m_storage;
 
     unsigned vectorLength = m_vectorLength;
@@ -603,6 +624,7 @@ JSValue JSArray::pop()
 void JSArray::push(ExecState* exec, JSValue value)
 {
     checkConsistency();
+    Heap::writeBarrier(this);
 
     if (m_storage->m_length < m_vectorLength) {
         m_storage->m_vector[m_storage->m_length] = value;
@@ -631,28 +653,156 @@ void JSArray::push(ExecState* exec, JSValue value)
     putSlowCase(exec, m_storage->m_length++, value);
 }
 
+bool JSArray::shiftCount(unsigned startIndex, unsigned count)
+{
+    checkConsistency();
+
+    ArrayStorage* storage = m_storage;
+    unsigned length = storage->m_length;
+    ASSERT(startIndex <= length && count <= length - startIndex);
+
+    // With no holes, there are no values to look up in the prototype chain, and every value is in the vector.
+    if (storage->m_sparseValueMap || storage->m_numValuesInVector != length)
+        return false;
+
+    JSValue* vector = storage->m_vector;
+    unsigned valuesAfter = length - startIndex - count;
+    if (startIndex < valuesAfter) {
+        memmove(vector + count, vector, startIndex * sizeof(JSValue));
+        ArrayStorage* newStorage = reinterpret_cast<ArrayStorage*>(reinterpret_cast<JSValue*>(storage) + count);
+        memmove(newStorage, storage, storageSize(0));
+        m_storage = newStorage;
+        m_indexBias += count;
+        m_vectorLength -= count;
+    } else {
+        memmove(vector + startIndex, vector + startIndex + count, valuesAfter * sizeof(JSValue));
+        for (unsigned i = length - count; i < length; ++i)
+            vector[i] = JSValue();
+    }
+
+    m_storage->m_length = length - count;
+    m_storage->m_numValuesInVector = length - count;
+
+    checkConsistency();
+    return true;
+}
+
+bool JSArray::unshiftCount(unsigned startIndex, unsigned count)
+{
+    checkConsistency();
+
+    ArrayStorage* storage = m_storage;
+    unsigned length = storage->m_length;
+    ASSERT(startIndex <= length);
+
+    if (storage->m_sparseValueMap || storage->m_numValuesInVector != length || count > MAX_STORAGE_VECTOR_LENGTH - length)
+        return false;
+
+    unsigned newLength = length + count;
+    unsigned valuesAfter = length - startIndex;
+    bool roomInFront = m_indexBias >= count;
+    bool roomBehind = newLength <= m_vectorLength;
+    if (roomInFront && (startIndex < valuesAfter || !roomBehind)) {
+        ArrayStorage* newStorage = reinterpret_cast<ArrayStorage*>(reinterpret_cast<JSValue*>(storage) - count);
+        memmove(newStorage, storage, storageSize(0));
+        m_storage = newStorage;
+        m_indexBias -= count;
+        m_vectorLength += count;
+        JSValue* vector = m_storage->m_vector;
+        memmove(vector, vector + count, startIndex * sizeof(JSValue));
+    } else if (roomBehind) {
+        JSValue* vector = storage->m_vector;
+        memmove(vector + startIndex + count, vector + startIndex, valuesAfter * sizeof(JSValue));
+    } else {
+        // Leave the spare room on the side that moved, so that doing the same again is cheap.
+        unsigned oldAllocatedLength = m_indexBias + m_vectorLength;
+        unsigned allocatedLength = increasedVectorLength(newLength);
+        unsigned newIndexBias = startIndex < valuesAfter ? allocatedLength - newLength : 0;
+        unsigned newVectorLength = allocatedLength - newIndexBias;
+
+        JSValue* newBase;
+        if (!tryFastMalloc(storageSize(allocatedLength)).getValue(newBase))
+            return false;
+        ArrayStorage* newStorage = reinterpret_cast<ArrayStorage*>(newBase + newIndexBias);
+        memcpy(newStorage, storage, storageSize(0));
+        memcpy(newStorage->m_vector, storage->m_vector, startIndex * sizeof(JSValue));
+        memcpy(newStorage->m_vector + startIndex + count, storage->m_vector + startIndex, valuesAfter * sizeof(JSValue));
+
+        fastFree(storageBase());
+        m_storage = newStorage;
+        m_indexBias = newIndexBias;
+        m_vectorLength = newVectorLength;
+
+        for (unsigned i = newLength; i < newVectorLength; ++i)
+            newStorage->m_vector[i] = JSValue();
+
+        if (allocatedLength > oldAllocatedLength)
+            Heap::heap(this)->reportExtraMemoryCost(storageSize(allocatedLength) - storageSize(oldAllocatedLength));
+    }
+
+    for (unsigned i = startIndex; i < startIndex + count; ++i)
+        m_storage->m_vector[i] = JSValue();
+    m_storage->m_length = newLength;
+
+    checkConsistency();
+    return true;
+}
+
 void JSArray::markChildren(MarkStack& markStack)
 {
     markChildrenDirect(markStack);
 }
 
-static int compareNumbersForQSort(const void* a, const void* b)
+static bool isNotNaN(double d)
+{
+    return d == d;
+}
+
+// Sorts numbers as the compare function v1 - v2, or v2 - v1 if reverse, would. That
+// compares NaN equal to everything, which leaves its place up to us: it goes last.
+// The sort is stable, so 0 and -0 keep their order.
+static void sortDoubles(double* begin, double* end, bool reverse)
 {
-    double da = static_cast<const JSValue*>(a)->uncheckedGetNumber();
-    double db = static_cast<const JSValue*>(b)->uncheckedGetNumber();
-    return (da > db) - (da < db);
+    double* nanBegin = std::stable_partition(begin, end, isNotNaN);
+    if (reverse)
+        std::stable_sort(begin, nanBegin, std::greater<double>());
+    else
+        std::stable_sort(begin, nanBegin);
 }
 
 typedef std::pair<JSValue, UString> ValueStringPair;
 
-static int compareByStringPairForQSort(const void* a, const void* b)
+static bool valueStringPairLessThan(const ValueStringPair& a, const ValueStringPair& b)
 {
-    const ValueStringPair* va = static_cast<const ValueStringPair*>(a);
-    const ValueStringPair* vb = static_cast<const ValueStringPair*>(b);
-    return compare(va->second, vb->second);
+    return a.second < b.second;
 }
 
-void JSArray::sortNumeric(ExecState* exec, JSValue compareFunction, CallType callType, const CallData& callData)
+// Stable, so values with equal strings keep their order, as they do in other browsers.
+static void sortByStrings(Vector<ValueStringPair>& values)
+{
+    std::stable_sort(values.begin(), values.end(), valueStringPairLessThan);
+}
+
+void JSArray::sortNumeric(ExecState* exec, JSValue compareFunction, CallType callType, const CallData& callData, bool reverse)
+{
+    unsigned lengthNotIncludingUndefined = compactForSorting();
+    if (m_storage->m_sparseValueMap) {
+        throwOutOfMemoryError(exec);
+        return;
+    }
+
+    if (!lengthNotIncludingUndefined)
+        return;
+
+    for (unsigned i = 0; i < lengthNotIncludingUndefined; ++i) {
+        if (!m_storage->m_vector[i].isNumber())
+            return sort(exec, compareFunction, callType, callData);
+    }
+
+    sortNumberVector(exec, lengthNotIncludingUndefined, reverse);
+}
+
+void JSArray::sortRelational(ExecState* exec, JSValue compareFunction, CallType callType, const CallData& callData)
 {
     unsigned lengthNotIncludingUndefined = compactForSorting();
     if (m_storage->m_sparseValueMap) {
@@ -662,23 +812,63 @@ void JSArray::sortNumeric(ExecState* exec, JSValue compareFunction, CallType cal
 
     if (!lengthNotIncludingUndefined)
         return;
-        
+
+    // Between two numbers, or two strings, < runs no script, and orders them
+    // as a numeric sort, or a sort without a compare function, would.
     bool allValuesAreNumbers = true;
-    size_t size = m_storage->m_numValuesInVector;
-    for (size_t i = 0; i < size; ++i) {
-        if (!m_storage->m_vector[i].isNumber()) {
-            allValuesAreNumbers = false;
-            break;
-        }
+    bool allValuesAreStrings = true;
+    for (unsigned i = 0; i < lengthNotIncludingUndefined; ++i) {
+        JSValue value = m_storage->m_vector[i];
+        allValuesAreNumbers &= value.isNumber();
+        allValuesAreStrings &= value.isString();
+    }
+
+    if (allValuesAreNumbers)
+        sortNumberVector(exec, lengthNotIncludingUndefined, false);
+    else if (allValuesAreStrings)
+        sortStringVector(exec, lengthNotIncludingUndefined);
+    else
+        sort(exec, compareFunction, callType, callData);
+}
+
+void JSArray::sortNumberVector(ExecState* exec, unsigned length, bool reverse)
+{
+    Vector<double> numbers(length);
+    if (!numbers.begin()) {
+        throwOutOfMemoryError(exec);
+        return;
+    }
+
+    JSValue* vector = m_storage->m_vector;
+    for (unsigned i = 0; i < length; ++i)
+        numbers[i] = vector[i].uncheckedGetNumber();
+
+    sortDoubles(numbers.begin(), numbers.end(), reverse);
+
+    for (unsigned i = 0; i < length; ++i)
+        vector[i] = jsNumber(exec, numbers[i]);
+
+    checkConsistency(SortConsistencyCheck);
+}
+
+void JSArray::sortStringVector(ExecState* exec, unsigned length)
+{
+    Vector<ValueStringPair> values(length);
+    if (!values.begin()) {
+        throwOutOfMemoryError(exec);
+        return;
+    }
+
+    JSValue* vector = m_storage->m_vector;
+    for (unsigned i = 0; i < length; ++i) {
+        values[i].first = vector[i];
+        values[i].second = asString(vector[i])->value(exec);
     }
 
-    if (!allValuesAreNumbers)
-        return sort(exec, compareFunction, callType, callData);
+    sortByStrings(values);
 
-    // For numeric comparison, which is fast, qsort is faster than mergesort. We
-    // also don't require mergesort's stability, since there's no user visible
-    // side-effect from swapping the order of equal primitive values.
-    qsort(m_storage->m_vector, size, sizeof(JSValue), compareNumbersForQSort);
+    for (unsigned i = 0; i < length; ++i)
+        vector[i] = values[i].first;
 
     checkConsistency(SortConsistencyCheck);
 }
@@ -726,13 +916,7 @@ void JSArray::sort(ExecState* exec)
     // FIXME: Since we sort by string value, a fast algorithm might be to use a radix sort. That would be O(N) rather
     // than O(N log N).
 
-#if HAVE(MERGESORT)
-    mergesort(values.begin(), values.size(), sizeof(ValueStringPair), compareByStringPairForQSort);
-#else
-    // FIXME: The qsort library function is likely to not be a stable sort.
-    // ECMAScript-262 does not specify a stable sort, but in practice, browsers perform a stable sort.
-    qsort(values.begin(), values.size(), sizeof(ValueStringPair), compareByStringPairForQSort);
-#endif
+    sortByStrings(values);
 
     // FIXME: If the toString function changed the length of the array, this might be
     // modifying the vector incorrectly.
@@ -743,62 +927,28 @@ void JSArray::sort(ExecState* exec)
     checkConsistency(SortConsistencyCheck);
 }
 
-struct AVLTreeNodeForArrayCompare {
-    JSValue value;
-
-    // Child pointers.  The high bit of gt is robbed and used as the
-    // balance factor sign.  The high bit of lt is robbed and used as
-    // the magnitude of the balance factor.
-    int32_t gt;
-    int32_t lt;
-};
-
-struct AVLTreeAbstractorForArrayCompare {
-    typedef int32_t handle; // Handle is an index into m_nodes vector.
-    typedef JSValue key;
-    typedef int32_t size;
-
-    Vector<AVLTreeNodeForArrayCompare> m_nodes;
-    ExecState* m_exec;
-    JSValue m_compareFunction;
-    CallType m_compareCallType;
-    const CallData* m_compareCallData;
-    JSValue m_globalThisValue;
-    OwnPtr<CachedCall> m_cachedCall;
-
-    handle get_less(handle h) { return m_nodes[h].lt & 0x7FFFFFFF; }
-    void set_less(handle h, handle lh) { m_nodes[h].lt &= 0x80000000; m_nodes[h].lt |= lh; }
-    handle get_greater(handle h) { return m_nodes[h].gt & 0x7FFFFFFF; }
-    void set_greater(handle h, handle gh) { m_nodes[h].gt &= 0x80000000; m_nodes[h].gt |= gh; }
-
-    int get_balance_factor(handle h)
+// Calls the compare function of a sort. Once it has thrown, it is not called
+// again, and the values not yet in order are left as they come.
+class CompareFunctionLessThan : public Noncopyable {
+public:
+    CompareFunctionLessThan(ExecState* exec, JSValue compareFunction, CallType callType, const CallData& callData)
+        : m_exec(exec)
+        , m_compareFunction(compareFunction)
+        , m_compareCallType(callType)
+        , m_compareCallData(callData)
+        , m_globalThisValue(exec->globalThisValue())
     {
-        if (m_nodes[h].gt & 0x80000000)
-            return -1;
-        return static_cast<unsigned>(m_nodes[h].lt) >> 31;
+        if (callType == CallTypeJS)
+            m_cachedCall.set(new CachedCall(exec, asFunction(compareFunction), 2, exec->exceptionSlot()));
     }
 
-    void set_balance_factor(handle h, int bf)
-    {
-        if (bf == 0) {
-            m_nodes[h].lt &= 0x7FFFFFFF;
-            m_nodes[h].gt &= 0x7FFFFFFF;
-        } else {
-            m_nodes[h].lt |= 0x80000000;
-            if (bf < 0)
-                m_nodes[h].gt |= 0x80000000;
-            else
-                m_nodes[h].gt &= 0x7FFFFFFF;
-        }
-    }
-
-    int compare_key_key(key va, key vb)
+    bool operator()(JSValue va, JSValue vb)
     {
         ASSERT(!va.isUndefined());
         ASSERT(!vb.isUndefined());
 
         if (m_exec->hadException())
-            return 1;
+            return false;
 
         double compareResult;
         if (m_cachedCall) {
@@ -810,130 +960,97 @@ struct AVLTreeAbstractorForArrayCompare {
             MarkedArgumentBuffer arguments;
             arguments.append(va);
             arguments.append(vb);
-            compareResult = call(m_exec, m_compareFunction, m_compareCallType, *m_compareCallData, m_globalThisValue, arguments).toNumber(m_exec);
+            compareResult = call(m_exec, m_compareFunction, m_compareCallType, m_compareCallData, m_globalThisValue, arguments).toNumber(m_exec);
         }
-        return (compareResult < 0) ? -1 : 1; // Not passing equality through, because we need to store all values, even if equivalent.
+        return compareResult < 0;
     }
 
-    int compare_key_node(key k, handle h) { return compare_key_key(k, m_nodes[h].value); }
-    int compare_node_node(handle h1, handle h2) { return compare_key_key(m_nodes[h1].value, m_nodes[h2].value); }
-
-    static handle null() { return 0x7FFFFFFF; }
+private:
+    ExecState* m_exec;
+    JSValue m_compareFunction;
+    CallType m_compareCallType;
+    const CallData& m_compareCallData;
+    JSValue m_globalThisValue;
+    OwnPtr<CachedCall> m_cachedCall;
 };
 
-void JSArray::sort(ExecState* exec, JSValue compareFunction, CallType callType, const CallData& callData)
+// A bottom-up merge sort, back and forth between values and a buffer of the same size.
+// A later value only goes before an earlier one if it is less, so the sort is stable, and
+// two runs already in order are merged with a single comparison.
+template<typename LessThan> static void mergeSort(JSValue* values, JSValue* buffer, size_t size, LessThan& lessThan)
 {
-    checkConsistency();
+    JSValue* from = values;
+    JSValue* to = buffer;
+    for (size_t width = 1; width < size; width *= 2) {
+        for (size_t begin = 0; begin < size; begin += 2 * width) {
+            size_t middle = min(begin + width, size);
+            size_t end = min(begin + 2 * width, size);
+            size_t left = begin;
+            size_t right = middle;
+            size_t out = begin;
+            if (right < end && (width == 1 || lessThan(from[right], from[middle - 1]))) {
+                while (left < middle && right < end)
+                    to[out++] = lessThan(from[right], from[left]) ? from[right++] : from[left++];
+            }
+            while (left < middle)
+                to[out++] = from[left++];
+            while (right < end)
+                to[out++] = from[right++];
+        }
+        std::swap(from, to);
+    }
 
-    // FIXME: This ignores exceptions raised in the compare function or in toNumber.
+    if (from != values)
+        std::copy(from, from + size, values);
+}
 
-    // The maximum tree depth is compiled in - but the caller is clearly up to no good
-    // if a larger array is passed.
-    ASSERT(m_storage->m_length <= static_cast<unsigned>(std::numeric_limits<int>::max()));
-    if (m_storage->m_length > static_cast<unsigned>(std::numeric_limits<int>::max()))
+void JSArray::sort(ExecState* exec, JSValue compareFunction, CallType callType, const CallData& callData)
+{
+    unsigned lengthNotIncludingUndefined = compactForSorting();
+    if (m_storage->m_sparseValueMap) {
+        throwOutOfMemoryError(exec);
         return;
+    }
 
-    if (!m_storage->m_length)
+    if (lengthNotIncludingUndefined < 2)
         return;
 
-    unsigned usedVectorLength = min(m_storage->m_length, m_vectorLength);
-
-    AVLTree<AVLTreeAbstractorForArrayCompare, 44> tree; // Depth 44 is enough for 2^31 items
-    tree.abstractor().m_exec = exec;
-    tree.abstractor().m_compareFunction = compareFunction;
-    tree.abstractor().m_compareCallType = callType;
-    tree.abstractor().m_compareCallData = &callData;
-    tree.abstractor().m_globalThisValue = exec->globalThisValue();
-    tree.abstractor().m_nodes.resize(usedVectorLength + (m_storage->m_sparseValueMap ? m_storage->m_sparseValueMap->size() : 0));
-
-    if (callType == CallTypeJS)
-        tree.abstractor().m_cachedCall.set(new CachedCall(exec, asFunction(compareFunction), 2, exec->exceptionSlot()));
-
-    if (!tree.abstractor().m_nodes.begin()) {
+    // The compare function may run any script, so the values are sorted out of line. It
+    // can remove them from the array, so they are also kept in a MarkedArgumentBuffer,
+    // where the collector can see them.
+    Vector<JSValue> values(lengthNotIncludingUndefined);
+    Vector<JSValue> buffer(lengthNotIncludingUndefined);
+    if (!values.begin() || !buffer.begin()) {
         throwOutOfMemoryError(exec);
         return;
     }
 
-    // FIXME: If the compare function modifies the array, the vector, map, etc. could be modified
-    // right out from under us while we're building the tree here.
-
-    unsigned numDefined = 0;
-    unsigned numUndefined = 0;
-
-    // Iterate over the array, ignoring missing values, counting undefined ones, and inserting all other ones into the tree.
-    for (; numDefined < usedVectorLength; ++numDefined) {
-        JSValue v = m_storage->m_vector[numDefined];
-        if (!v || v.isUndefined())
-            break;
-        tree.abstractor().m_nodes[numDefined].value = v;
-        tree.insert(numDefined);
-    }
-    for (unsigned i = numDefined; i < usedVectorLength; ++i) {
-        JSValue v = m_storage->m_vector[i];
-        if (v) {
-            if (v.isUndefined())
-                ++numUndefined;
-            else {
-                tree.abstractor().m_nodes[numDefined].value = v;
-                tree.insert(numDefined);
-                ++numDefined;
-            }
-        }
-    }
-
-    unsigned newUsedVectorLength = numDefined + numUndefined;
-
-    if (SparseArrayValueMap* map = m_storage->m_sparseValueMap) {
-        newUsedVectorLength += map->size();
-        if (newUsedVectorLength > m_vectorLength) {
-            // Check that it is possible to allocate an array large enough to hold all the entries.
-            if ((newUsedVectorLength > MAX_STORAGE_VECTOR_LENGTH) || !increaseVectorLength(newUsedVectorLength)) {
-                throwOutOfMemoryError(exec);
-                return;
-            }
-        }
-
-        SparseArrayValueMap::iterator end = map->end();
-        for (SparseArrayValueMap::iterator it = map->begin(); it != end; ++it) {
-            tree.abstractor().m_nodes[numDefined].value = it->second;
-            tree.insert(numDefined);
-            ++numDefined;
-        }
-
-        delete map;
-        m_storage->m_sparseValueMap = 0;
+    MarkedArgumentBuffer markedValues;
+    for (unsigned i = 0; i < lengthNotIncludingUndefined; ++i) {
+        values[i] = m_storage->m_vector[i];
+        markedValues.append(values[i]);
     }
 
-    ASSERT(tree.abstractor().m_nodes.size() >= numDefined);
+    CompareFunctionLessThan lessThan(exec, compareFunction, callType, callData);
+    mergeSort(values.begin(), buffer.begin(), lengthNotIncludingUndefined, lessThan);
 
-    // FIXME: If the compare function changed the length of the array, the following might be
-    // modifying the vector incorrectly.
-
-    // Copy the values back into m_storage.
-    AVLTree<AVLTreeAbstractorForArrayCompare, 44>::Iterator iter;
-    iter.start_iter_least(tree);
-    for (unsigned i = 0; i < numDefined; ++i) {
-        m_storage->m_vector[i] = tree.abstractor().m_nodes[*iter].value;
-        ++iter;
+    // The compare function may also have shortened the array, or moved or shrunk its
+    // vector, so only the values that still fit in both are written back.
+    ArrayStorage* storage = m_storage;
+    unsigned writeBackLength = min(lengthNotIncludingUndefined, min(m_vectorLength, storage->m_length));
+    for (unsigned i = 0; i < writeBackLength; ++i) {
+        if (!storage->m_vector[i])
+            ++storage->m_numValuesInVector;
+        storage->m_vector[i] = values[i];
     }
 
-    // Put undefined values back in.
-    for (unsigned i = numDefined; i < newUsedVectorLength; ++i)
-        m_storage->m_vector[i] = jsUndefined();
-
-    // Ensure that unused values in the vector are zeroed out.
-    for (unsigned i = newUsedVectorLength; i < usedVectorLength; ++i)
-        m_storage->m_vector[i] = JSValue();
-
-    m_storage->m_numValuesInVector = newUsedVectorLength;
-
-    checkConsistency(SortConsistencyCheck);
+    checkConsistency();
 }
 
 void JSArray::fillArgList(ExecState* exec, MarkedArgumentBuffer& args)
 {
-    JSValue* vector = m_storage->m_vector;
     unsigned vectorEnd = min(m_storage->m_length, m_vectorLength);
+    JSValue* vector = m_storage->m_vector;
     unsigned i = 0;
     for (; i < vectorEnd; ++i) {
         JSValue& v = vector[i];
@@ -950,8 +1067,8 @@ void JSArray::copyToRegisters(ExecState* exec, Register* buffer, uint32_t maxSiz
 {
     ASSERT(m_storage->m_length == maxSize);
     UNUSED_PARAM(maxSize);
-    JSValue* vector = m_storage->m_vector;
     unsigned vectorEnd = min(m_storage->m_length, m_vectorLength);
+    JSValue* vector = m_storage->m_vector;
     unsigned i = 0;
     for (; i < vectorEnd; ++i) {
         JSValue& v = vector[i];
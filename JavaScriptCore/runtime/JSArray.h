@@ -58,11 +58,19 @@ namespace JSC {
 
         void sort(ExecState*);
         void sort(ExecState*, JSValue compareFunction, CallType, const CallData&);
-        void sortNumeric(ExecState*, JSValue compareFunction, CallType, const CallData&);
+        void sortNumeric(ExecState*, JSValue compareFunction, CallType, const CallData&, bool reverse = false);
+        void sortRelational(ExecState*, JSValue compareFunction, CallType, const CallData&);
 
         void push(ExecState*, JSValue);
         JSValue pop();
 
+        // Remove count values from, or open count holes in, a dense array at startIndex, moving
+        // whichever side of it is shorter. Moving the front only moves where the vector starts,
+        // so shift() and unshift() are O(1), amortized. Both return false, having done nothing,
+        // for an array with holes or a sparse map, which has to be handled generically.
+        bool shiftCount(unsigned startIndex, unsigned count);
+        bool unshiftCount(unsigned startIndex, unsigned count);
+
         bool canGetIndex(unsigned i) { return i < m_vectorLength && m_storage->m_vector[i]; }
         JSValue getIndex(unsigned i)
         {
@@ -81,6 +89,7 @@ namespace JSC {
                     m_storage->m_length = i + 1;
             }
             x = v;
+            Heap::writeBarrier(this);
         }
 
         void fillArgList(ExecState*, MarkedArgumentBuffer&);
@@ -110,14 +119,19 @@ namespace JSC {
         bool getOwnPropertySlotSlowCase(ExecState*, unsigned propertyName, PropertySlot&);
         void putSlowCase(ExecState*, unsigned propertyName, JSValue);
 
+        void* storageBase() const { return reinterpret_cast<JSValue*>(m_storage) - m_indexBias; }
+        void removeIndexBias();
         bool increaseVectorLength(unsigned newLength);
         
         unsigned compactForSorting();
+        void sortNumberVector(ExecState*, unsigned length, bool reverse);
+        void sortStringVector(ExecState*, unsigned length);
 
         enum ConsistencyCheckType { NormalConsistencyCheck, DestructorConsistencyCheck, SortConsistencyCheck };
         void checkConsistency(ConsistencyCheckType = NormalConsistencyCheck);
 
         unsigned m_vectorLength;
+        unsigned m_indexBias; // Number of vector slots allocated in front of m_storage.
         ArrayStorage* m_storage;
     };
 
@@ -175,6 +189,18 @@ namespace JSC {
             asArray(cell)->markChildrenDirect(*this);
             return;
         }
+#if ENABLE(PARALLEL_MARKING)
+        if (!m_isCollectorThread) {
+            deferToCollectorThread(cell);
+            return;
+        }
+#endif
+        // Unless the cell's type says otherwise, a custom markChildren
+        // implementation may reach cells through fields that are not covered by
+        // write barriers, so keep this cell's card dirty for the next nursery
+        // collection.
+        if (!cell->structure()->typeInfo().hasWriteBarrieredChildren())
+            Heap::writeBarrier(cell);
         cell->markChildren(*this);
     }
 
@@ -202,8 +228,7 @@ namespace JSC {
                     goto findNextUnmarkedNullValue;
                 }
 
-                Heap::markCell(cell);
-                if (cell->structure()->typeInfo().type() < CompoundType) {
+                if (!testAndSetMarked(cell) || cell->structure()->typeInfo().type() < CompoundType) {
                     if (current.m_values == end) {
                         m_markSets.removeLast();
                         continue;
@@ -215,9 +240,18 @@ namespace JSC {
                     m_markSets.removeLast();
 
                 markChildren(cell);
+#if ENABLE(PARALLEL_MARKING)
+                if (m_shared && !--m_donationCountdown)
+                    donateWork();
+#endif
             }
-            while (!m_values.isEmpty())
+            while (!m_values.isEmpty()) {
                 markChildren(m_values.removeLast());
+#if ENABLE(PARALLEL_MARKING)
+                if (m_shared && !--m_donationCountdown)
+                    donateWork();
+#endif
+            }
         }
     }
     
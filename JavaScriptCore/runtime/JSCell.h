@@ -318,13 +318,24 @@ namespace JSC {
         return isCell() ? asCell()->toThisObject(exec) : toThisObjectSlowCase(exec);
     }
 
+    ALWAYS_INLINE bool MarkStack::testAndSetMarked(JSCell* cell)
+    {
+#if ENABLE(PARALLEL_MARKING)
+        if (m_shared)
+            return Heap::markCellAtomically(cell);
+#endif
+        Heap::markCell(cell);
+        return true;
+    }
+
     ALWAYS_INLINE void MarkStack::append(JSCell* cell)
     {
         ASSERT(!m_isCheckingForDefaultMarkViolation);
         ASSERT(cell);
         if (Heap::isCellMarked(cell))
             return;
-        Heap::markCell(cell);
+        if (!testAndSetMarked(cell))
+            return;
         if (cell->structure()->typeInfo().type() >= CompoundType)
             m_values.append(cell);
     }
@@ -30,6 +30,7 @@
 #include "JSGlobalData.h"
 
 #include "ArgList.h"
+#include "BytecodeCache.h"
 #include "Collector.h"
 #include "CommonIdentifiers.h"
 #include "FunctionConstructor.h"
@@ -49,6 +50,7 @@
 #include "Lookup.h"
 #include "Nodes.h"
 #include "Parser.h"
+#include "SamplingProfiler.h"
 
 #if ENABLE(JSC_MULTIPLE_THREADS)
 #include <wtf/Threading.h>
@@ -104,6 +106,10 @@ void JSGlobalData::storeVPtrs()
 
 JSGlobalData::JSGlobalData(bool isShared)
     : isSharedInstance(isShared)
+#ifndef NDEBUG
+    , apiEntryThread(0)
+    , apiEntryDepth(0)
+#endif
     , clientData(0)
     , arrayTable(fastNew<HashTable>(JSC::arrayTable))
     , dateTable(fastNew<HashTable>(JSC::dateTable))
@@ -130,6 +136,10 @@ JSGlobalData::JSGlobalData(bool isShared)
     , identifierTable(createIdentifierTable())
     , propertyNames(new CommonIdentifiers(this))
     , emptyList(new MarkedArgumentBuffer)
+#if ENABLE(SAMPLING_PROFILER)
+    , topCallFrame(0)
+    , isSamplingProfilerRunning(false)
+#endif
     , lexer(new Lexer(this))
     , parser(new Parser)
     , interpreter(new Interpreter)
@@ -137,7 +147,7 @@ JSGlobalData::JSGlobalData(bool isShared)
     , jitStubs(this)
 #endif
     , heap(this)
-    , initializingLazyNumericCompareFunction(false)
+    , initializingLazyCompareFunctions(false)
     , head(0)
     , dynamicGlobalObject(0)
     , functionCodeBlockBeingReparsed(0)
@@ -240,17 +250,50 @@ JSGlobalData*& JSGlobalData::sharedInstanceInternal()
     return sharedInstance;
 }
 
-// FIXME: We can also detect forms like v1 < v2 ? -1 : 0, reverse comparison, etc.
-const Vector<Instruction>& JSGlobalData::numericCompareFunction(ExecState* exec)
+static const struct {
+    CompareFunctionType type;
+    const char* source;
+} compareFunctionSources[] = {
+    { NumericCompareFunction, "(function (v1, v2) { return v1 - v2; })" },
+    { ReverseNumericCompareFunction, "(function (v1, v2) { return v2 - v1; })" },
+    { RelationalCompareFunction, "(function (v1, v2) { return v1 < v2 ? -1 : v1 > v2 ? 1 : 0; })" },
+    { RelationalCompareFunction, "(function (v1, v2) { return v1 > v2 ? 1 : v1 < v2 ? -1 : 0; })" },
+    { RelationalCompareFunction, "(function (v1, v2) { if (v1 < v2) return -1; if (v1 > v2) return 1; return 0; })" },
+};
+
+static bool hasConstants(CodeBlock* codeBlock, const Vector<JSValue>& constants)
+{
+    if (codeBlock->numberOfConstantRegisters() != constants.size())
+        return false;
+    for (size_t i = 0; i < constants.size(); ++i) {
+        if (codeBlock->getConstant(FirstConstantRegisterIndex + i) != constants[i])
+            return false;
+    }
+    return true;
+}
+
+CompareFunctionType JSGlobalData::compareFunctionType(ExecState* exec, CodeBlock* codeBlock)
 {
-    if (!lazyNumericCompareFunction.size() && !initializingLazyNumericCompareFunction) {
-        initializingLazyNumericCompareFunction = true;
-        RefPtr<FunctionExecutable> function = FunctionExecutable::fromGlobalCode(Identifier(exec, "numericCompare"), exec, 0, makeSource(UString("(function (v1, v2) { return v1 - v2; })")), 0, 0);
-        lazyNumericCompareFunction = function->bytecode(exec, exec->scopeChain()).instructions();
-        initializingLazyNumericCompareFunction = false;
+    if (lazyCompareFunctions.isEmpty() && !initializingLazyCompareFunctions) {
+        initializingLazyCompareFunctions = true;
+        for (size_t i = 0; i < sizeof(compareFunctionSources) / sizeof(compareFunctionSources[0]); ++i) {
+            RefPtr<FunctionExecutable> function = FunctionExecutable::fromGlobalCode(Identifier(exec, "compare"), exec, 0, makeSource(UString(compareFunctionSources[i].source)), 0, 0);
+            CodeBlock& reference = function->bytecode(exec, exec->scopeChain());
+            CompareFunctionBytecode bytecode;
+            bytecode.instructions = reference.instructions();
+            // The constants are small integers, which need no marking.
+            for (size_t j = 0; j < reference.numberOfConstantRegisters(); ++j)
+                bytecode.constants.append(reference.getConstant(FirstConstantRegisterIndex + j));
+            lazyCompareFunctions.append(bytecode);
+        }
+        initializingLazyCompareFunctions = false;
     }
 
-    return lazyNumericCompareFunction;
+    for (size_t i = 0; i < lazyCompareFunctions.size(); ++i) {
+        if (codeBlock->instructions() == lazyCompareFunctions[i].instructions && hasConstants(codeBlock, lazyCompareFunctions[i].constants))
+            return compareFunctionSources[i].type;
+    }
+    return UnknownCompareFunction;
 }
 
 JSGlobalData::ClientData::~ClientData()
@@ -35,20 +35,25 @@
 #include "JITStubs.h"
 #include "JSValue.h"
 #include "MarkStack.h"
+#include "MegamorphicCache.h"
 #include "NumericStrings.h"
+#include "RegExpCache.h"
 #include "SmallStrings.h"
 #include "Terminator.h"
 #include "TimeoutChecker.h"
 #include "WeakRandom.h"
 #include <wtf/Forward.h>
 #include <wtf/HashMap.h>
+#include <wtf/OwnPtr.h>
 #include <wtf/RefCounted.h>
+#include <wtf/Threading.h>
 
 struct OpaqueJSClass;
 struct OpaqueJSClassContextData;
 
 namespace JSC {
 
+    class BytecodeCache;
     class CodeBlock;
     class CommonIdentifiers;
     class IdentifierTable;
@@ -57,6 +62,7 @@ namespace JSC {
     class JSObject;
     class Lexer;
     class Parser;
+    class SamplingProfiler;
     class Stringifier;
     class Structure;
     class UString;
@@ -84,6 +90,15 @@ namespace JSC {
         double increment;
     };
 
+    // Compare functions that Array.prototype.sort recognises by their bytecode,
+    // and replaces with a native comparison.
+    enum CompareFunctionType {
+        UnknownCompareFunction,
+        NumericCompareFunction, // v1 - v2
+        ReverseNumericCompareFunction, // v2 - v1
+        RelationalCompareFunction // v1 < v2 ? -1 : v1 > v2 ? 1 : 0, and the like
+    };
+
     class JSGlobalData : public RefCounted<JSGlobalData> {
     public:
         struct ClientData {
@@ -104,6 +119,12 @@ namespace JSC {
 #endif
 
         bool isSharedInstance;
+#ifndef NDEBUG
+        // Any global data but the shared one goes unlocked, so the API checks
+        // that it is used by one thread at a time instead.
+        ThreadIdentifier apiEntryThread;
+        unsigned apiEntryDepth;
+#endif
         ClientData* clientData;
 
         const HashTable* arrayTable;
@@ -142,6 +163,18 @@ namespace JSC {
         const MarkedArgumentBuffer* emptyList; // Lists are supposed to be allocated on the stack to have their elements properly marked, which is not the case here - but this list has nothing to mark.
         SmallStrings smallStrings;
         NumericStrings numericStrings;
+        MegamorphicCache megamorphicCache;
+        RegExpCache regExpCache;
+        // Off unless the embedder creates one.
+        OwnPtr<BytecodeCache> bytecodeCache;
+#if ENABLE(SAMPLING_PROFILER)
+        // Off unless the embedder starts it.
+        OwnPtr<SamplingProfiler> samplingProfiler;
+        // The innermost call frame as of the last call out of JIT code. Stub
+        // functions only keep it up to date while a sampling profiler runs.
+        CallFrame* topCallFrame;
+        bool isSamplingProfilerRunning;
+#endif
         DateInstanceCache dateInstanceCache;
         
 #if ENABLE(ASSEMBLER)
@@ -163,9 +196,15 @@ namespace JSC {
         ReturnAddressPtr exceptionLocation;
 #endif
 
-        const Vector<Instruction>& numericCompareFunction(ExecState*);
-        Vector<Instruction> lazyNumericCompareFunction;
-        bool initializingLazyNumericCompareFunction;
+        // Reference compare functions differ only in their constants, so those are matched too.
+        struct CompareFunctionBytecode {
+            Vector<Instruction> instructions;
+            Vector<JSValue> constants;
+        };
+
+        CompareFunctionType compareFunctionType(ExecState*, CodeBlock*);
+        Vector<CompareFunctionBytecode> lazyCompareFunctions;
+        bool initializingLazyCompareFunctions;
 
         HashMap<OpaqueJSClass*, OpaqueJSClassContextData*> opaqueJSClassData;
 
@@ -214,6 +214,7 @@ void JSGlobalObject::reset(JSValue prototype)
     d()->applyFunction = applyFunction;
     d()->objectPrototype = new (exec) ObjectPrototype(exec, ObjectPrototype::createStructure(jsNull()), d()->prototypeFunctionStructure.get());
     d()->functionPrototype->structure()->setPrototypeWithoutTransition(d()->objectPrototype);
+    Heap::writeBarrier(d()->functionPrototype);
 
     d()->emptyObjectStructure = d()->objectPrototype->inheritorID();
 
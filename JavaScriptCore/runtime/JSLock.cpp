@@ -159,14 +159,27 @@ bool JSLock::currentThreadIsHoldingLock()
 // order in which they were made - though implementing the less restrictive policy
 // would likely increase complexity and overhead.
 //
+// Only the shared context is locked for real, so only its drops are counted.
+// Other context groups are used by one thread at a time, and need no policy -
+// nor would it be safe for every thread running one to update this variable,
+// which only the JSMutex guards.
+//
 static unsigned lockDropDepth = 0;
 
 JSLock::DropAllLocks::DropAllLocks(ExecState* exec)
     : m_lockBehavior(exec->globalData().isSharedInstance ? LockForReal : SilenceAssertionsOnly)
 {
+#ifdef NDEBUG
+    // Locking "not for real" is a debug-only feature.
+    if (m_lockBehavior == SilenceAssertionsOnly) {
+        m_lockCount = 0;
+        return;
+    }
+#endif
+
     pthread_once(&createJSLockCountOnce, createJSLockCount);
 
-    if (lockDropDepth++) {
+    if (m_lockBehavior == LockForReal && lockDropDepth++) {
         m_lockCount = 0;
         return;
     }
@@ -179,9 +192,16 @@ JSLock::DropAllLocks::DropAllLocks(ExecState* exec)
 JSLock::DropAllLocks::DropAllLocks(JSLockBehavior JSLockBehavior)
     : m_lockBehavior(JSLockBehavior)
 {
+#ifdef NDEBUG
+    if (m_lockBehavior == SilenceAssertionsOnly) {
+        m_lockCount = 0;
+        return;
+    }
+#endif
+
     pthread_once(&createJSLockCountOnce, createJSLockCount);
 
-    if (lockDropDepth++) {
+    if (m_lockBehavior == LockForReal && lockDropDepth++) {
         m_lockCount = 0;
         return;
     }
@@ -199,7 +219,8 @@ JSLock::DropAllLocks::~DropAllLocks()
     for (intptr_t i = 0; i < m_lockCount; i++)
         JSLock::lock(m_lockBehavior);
 
-    --lockDropDepth;
+    if (m_lockBehavior == LockForReal)
+        --lockDropDepth;
 }
 
 #else
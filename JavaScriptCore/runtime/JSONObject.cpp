@@ -33,7 +33,14 @@
 #include "LiteralParser.h"
 #include "PropertyNameArray.h"
 #include "StringBuilder.h"
+#include <wtf/HashMap.h>
 #include <wtf/MathExtras.h>
+#include <wtf/RefCounted.h>
+#include <wtf/dtoa.h>
+
+#if CPU(X86_SSE2)
+#include <emmintrin.h>
+#endif
 
 namespace JSC {
 
@@ -71,6 +78,27 @@ public:
     void markAggregate(MarkStack&);
 
 private:
+    // The enumerable properties of the objects with one Structure, with their
+    // storage offsets and their names already quoted. Built the first time an
+    // object with that Structure is serialized, and shared by the rest.
+    class ObjectLayout : public RefCounted<ObjectLayout> {
+    public:
+        static PassRefPtr<ObjectLayout> create(ExecState* exec, JSObject* object) { return adoptRef(new ObjectLayout(exec, object)); }
+
+        Structure* structure() const { return m_structure.get(); }
+        PropertyNameArrayData* propertyNames() const { return m_propertyNames.get(); }
+        size_t offset(unsigned index) const { return m_offsets[index]; }
+        const UString& quotedName(unsigned index) const { return m_quotedNames[index]; }
+
+    private:
+        ObjectLayout(ExecState*, JSObject*);
+
+        RefPtr<Structure> m_structure;
+        RefPtr<PropertyNameArrayData> m_propertyNames;
+        Vector<size_t> m_offsets;
+        Vector<UString> m_quotedNames;
+    };
+
     class Holder {
     public:
         Holder(JSObject*);
@@ -86,11 +114,15 @@ private:
         unsigned m_index;
         unsigned m_size;
         RefPtr<PropertyNameArrayData> m_propertyNames;
+        RefPtr<ObjectLayout> m_layout;
     };
 
     friend class Holder;
 
     static void appendQuotedString(StringBuilder&, const UString&);
+    static void appendNumber(StringBuilder&, JSValue, double);
+
+    ObjectLayout* objectLayout(JSObject*);
 
     JSValue toJSON(JSValue, const PropertyNameForFunctionCall&);
 
@@ -113,6 +145,7 @@ private:
 
     HashSet<JSObject*> m_holderCycleDetector;
     Vector<Holder, 16> m_holderStack;
+    HashMap<Structure*, RefPtr<ObjectLayout> > m_objectLayouts;
     UString m_repeatedGap;
     UString m_indent;
 };
@@ -271,20 +304,45 @@ JSValue Stringifier::stringify(JSValue value)
     return jsString(m_exec, result.build());
 }
 
+static inline bool needsEscape(UChar c)
+{
+    return c <= 0x1F || c == '"' || c == '\\';
+}
+
+// Returns the index of the first character at or after start that has to be
+// escaped, or length if there is none.
+static inline int findCharacterToEscape(const UChar* data, int start, int length)
+{
+    int i = start;
+#if CPU(X86_SSE2)
+    const int charactersPerChunk = sizeof(__m128i) / sizeof(UChar);
+    const __m128i controlLimit = _mm_set1_epi16(0x1F);
+    const __m128i quote = _mm_set1_epi16('"');
+    const __m128i backslash = _mm_set1_epi16('\\');
+    for (; length - i >= charactersPerChunk; i += charactersPerChunk) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        // A character is at most 0x1F exactly when subtracting 0x1F saturates to zero.
+        __m128i isControl = _mm_cmpeq_epi16(_mm_subs_epu16(chunk, controlLimit), _mm_setzero_si128());
+        __m128i isSpecial = _mm_or_si128(_mm_cmpeq_epi16(chunk, quote), _mm_cmpeq_epi16(chunk, backslash));
+        if (_mm_movemask_epi8(_mm_or_si128(isControl, isSpecial)))
+            break;
+    }
+#endif
+    while (i < length && !needsEscape(data[i]))
+        ++i;
+    return i;
+}
+
 void Stringifier::appendQuotedString(StringBuilder& builder, const UString& value)
 {
     int length = value.size();
 
-    // String length plus 2 for quote marks plus 8 so we can accomodate a few escaped characters.
-    builder.reserveCapacity(builder.size() + length + 2 + 8);
-
     builder.append('"');
 
     const UChar* data = value.data();
     for (int i = 0; i < length; ++i) {
         int start = i;
-        while (i < length && (data[i] > 0x1F && data[i] != '"' && data[i] != '\\'))
-            ++i;
+        i = findCharacterToEscape(data, i, length);
         builder.append(data + start, i - start);
         if (i >= length)
             break;
@@ -329,6 +387,66 @@ void Stringifier::appendQuotedString(StringBuilder& builder, const UString& valu
     builder.append('"');
 }
 
+void Stringifier::appendNumber(StringBuilder& builder, JSValue value, double number)
+{
+    if (value.isInt32()) {
+        // Formats the digits backwards, working on the magnitude as unsigned so INT_MIN is not special.
+        int32_t integer = value.asInt32();
+        unsigned magnitude = integer < 0 ? -static_cast<unsigned>(integer) : integer;
+        UChar digits[11];
+        UChar* end = digits + sizeof(digits) / sizeof(UChar);
+        UChar* p = end;
+        do {
+            *--p = '0' + magnitude % 10;
+            magnitude /= 10;
+        } while (magnitude);
+        if (integer < 0)
+            *--p = '-';
+        builder.append(p, end - p);
+        return;
+    }
+
+    DtoaBuffer buffer;
+    unsigned length;
+    doubleToStringInJavaScriptFormat(number, buffer, &length);
+    builder.append(buffer, length);
+}
+
+Stringifier::ObjectLayout::ObjectLayout(ExecState* exec, JSObject* object)
+    : m_structure(object->structure())
+{
+    PropertyNameArray propertyNames(exec);
+    object->getOwnPropertyNames(exec, propertyNames);
+    m_propertyNames = propertyNames.releaseData();
+
+    const PropertyNameArrayData::PropertyNameVector& names = m_propertyNames->propertyNameVector();
+    size_t size = names.size();
+    m_offsets.reserveInitialCapacity(size);
+    m_quotedNames.reserveInitialCapacity(size);
+    for (size_t i = 0; i < size; ++i) {
+        // A name the Structure does not have is read with getOwnPropertySlot().
+        m_offsets.uncheckedAppend(m_structure->get(names[i]));
+        StringBuilder quotedName;
+        appendQuotedString(quotedName, names[i].ustring());
+        m_quotedNames.uncheckedAppend(quotedName.build());
+    }
+}
+
+// Objects whose properties are all plain values in their Structure get an
+// ObjectLayout; for the rest, this returns 0.
+Stringifier::ObjectLayout* Stringifier::objectLayout(JSObject* object)
+{
+    Structure* structure = object->structure();
+    if (structure->isDictionary() || structure->hasGetterSetterProperties()
+        || structure->typeInfo().overridesGetOwnPropertySlot() || structure->typeInfo().overridesGetPropertyNames())
+        return 0;
+
+    pair<HashMap<Structure*, RefPtr<ObjectLayout> >::iterator, bool> result = m_objectLayouts.add(structure, 0);
+    if (result.second)
+        result.first->second = ObjectLayout::create(m_exec, object);
+    return result.first->second.get();
+}
+
 inline JSValue Stringifier::toJSON(JSValue value, const PropertyNameForFunctionCall& propertyName)
 {
     ASSERT(!m_exec->hadException());
@@ -398,7 +516,7 @@ Stringifier::StringifyResult Stringifier::appendStringifiedValue(StringBuilder&
         if (!isfinite(numericValue))
             builder.append("null");
         else
-            builder.append(UString::from(numericValue));
+            appendNumber(builder, value, numericValue);
         return StringifySucceeded;
     }
 
@@ -499,6 +617,8 @@ bool Stringifier::Holder::appendNextProperty(Stringifier& stringifier, StringBui
         } else {
             if (stringifier.m_usingArrayReplacer)
                 m_propertyNames = stringifier.m_arrayReplacerPropertyNames.data();
+            else if ((m_layout = stringifier.objectLayout(m_object)))
+                m_propertyNames = m_layout->propertyNames();
             else {
                 PropertyNameArray objectPropertyNames(exec);
                 m_object->getOwnPropertyNames(exec, objectPropertyNames);
@@ -545,14 +665,20 @@ bool Stringifier::Holder::appendNextProperty(Stringifier& stringifier, StringBui
         // Append the stringified value.
         stringifyResult = stringifier.appendStringifiedValue(builder, value, m_object, index);
     } else {
-        // Get the value.
-        PropertySlot slot(m_object);
+        // Get the value. While the object keeps the Structure its layout was
+        // made from, the value can be read straight from its storage.
         Identifier& propertyName = m_propertyNames->propertyNameVector()[index];
-        if (!m_object->getOwnPropertySlot(exec, propertyName, slot))
-            return true;
-        JSValue value = slot.getValue(exec, propertyName);
-        if (exec->hadException())
-            return false;
+        JSValue value;
+        if (m_layout && m_object->structure() == m_layout->structure() && m_layout->offset(index) != WTF::notFound)
+            value = m_object->getDirectOffset(m_layout->offset(index));
+        else {
+            PropertySlot slot(m_object);
+            if (!m_object->getOwnPropertySlot(exec, propertyName, slot))
+                return true;
+            value = slot.getValue(exec, propertyName);
+            if (exec->hadException())
+                return false;
+        }
 
         rollBackPoint = builder.size();
 
@@ -562,7 +688,10 @@ bool Stringifier::Holder::appendNextProperty(Stringifier& stringifier, StringBui
         stringifier.startNewLine(builder);
 
         // Append the property name.
-        appendQuotedString(builder, propertyName.ustring());
+        if (m_layout)
+            builder.append(m_layout->quotedName(index));
+        else
+            appendQuotedString(builder, propertyName.ustring());
         builder.append(':');
         if (stringifier.willIndent())
             builder.append(' ');
@@ -183,7 +183,14 @@ namespace JSC {
 
         // Fast access to known property offsets.
         JSValue getDirectOffset(size_t offset) const { return JSValue::decode(propertyStorage()[offset]); }
-        void putDirectOffset(size_t offset, JSValue value) { propertyStorage()[offset] = JSValue::encode(value); }
+        void putDirectOffset(size_t offset, JSValue value)
+        {
+            propertyStorage()[offset] = JSValue::encode(value);
+            Heap::writeBarrier(this);
+        }
+        // Moves the object to a Structure that extends its current one with new
+        // properties. The caller fills in the new slots with putDirectOffset().
+        void transitionTo(NonNullPassRefPtr<Structure>);
 
         void fillGetterPropertySlot(PropertySlot&, JSValue* location);
 
@@ -224,6 +231,7 @@ namespace JSC {
         {
             ASSERT(index < m_structure->anonymousSlotCount());
             *locationForOffset(index) = value;
+            Heap::writeBarrier(this);
         }
         JSValue getAnonymousValue(unsigned index) const
         {
@@ -320,6 +328,8 @@ inline void JSObject::setStructure(NonNullPassRefPtr<Structure> structure)
 {
     m_structure->deref();
     m_structure = structure.releaseRef(); // ~JSObject balances this ref()
+    // The new Structure may have a different prototype.
+    Heap::writeBarrier(this);
 }
 
 inline Structure* JSObject::inheritorID()
@@ -411,6 +421,15 @@ ALWAYS_INLINE bool JSObject::getPropertySlot(ExecState* exec, unsigned propertyN
     }
 }
 
+inline void JSObject::transitionTo(NonNullPassRefPtr<Structure> structure)
+{
+    ASSERT(!m_structure->isDictionary());
+    size_t currentCapacity = m_structure->propertyStorageCapacity();
+    if (currentCapacity != structure->propertyStorageCapacity())
+        allocatePropertyStorage(currentCapacity, structure->propertyStorageCapacity());
+    setStructure(structure);
+}
+
 inline JSValue JSObject::get(ExecState* exec, const Identifier& propertyName) const
 {
     PropertySlot slot(this);
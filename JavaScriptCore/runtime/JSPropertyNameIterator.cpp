@@ -45,6 +45,8 @@ inline JSPropertyNameIterator::JSPropertyNameIterator(ExecState* exec, PropertyN
     PropertyNameArrayData::PropertyNameVector& propertyNameVector = propertyNameArrayData->propertyNameVector();
     for (size_t i = 0; i < m_jsStringsSize; ++i)
         m_jsStrings[i] = jsOwnedString(exec, propertyNameVector[i].ustring());
+    // Allocating the strings may have run a collection that traced this iterator.
+    Heap::writeBarrier(this);
 }
 
 JSPropertyNameIterator::~JSPropertyNameIterator()
@@ -47,7 +47,7 @@ namespace JSC {
         
         static PassRefPtr<Structure> createStructure(JSValue prototype)
         {
-            return Structure::create(prototype, TypeInfo(CompoundType, OverridesMarkChildren), AnonymousSlotCount);
+            return Structure::create(prototype, TypeInfo(CompoundType, OverridesMarkChildren | HasWriteBarrieredChildren), AnonymousSlotCount);
         }
         
         virtual ~JSPropertyNameIterator();
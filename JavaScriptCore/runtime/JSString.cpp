@@ -46,8 +46,13 @@ void JSString::resolveRope(ExecState* exec) const
     ASSERT(isRope());
 
     // Allocate the buffer to hold the final string, position initially points to the end.
+    // If the rope is a string being appended to, the characters of its leftmost fiber
+    // may already be at the start of the buffer.
+    Rope::Fiber prefix = m_other.m_fibers[0];
+    while (prefix->isRope())
+        prefix = static_cast<URopeImpl*>(prefix)->fibers(0);
     UChar* buffer;
-    if (PassRefPtr<UStringImpl> newImpl = UStringImpl::tryCreateUninitialized(m_length, buffer))
+    if (PassRefPtr<UStringImpl> newImpl = UStringImpl::tryCreateForRope(m_length, static_cast<UStringImpl*>(prefix), buffer))
         m_value = newImpl;
     else {
         for (unsigned i = 0; i < m_fiberCount; ++i) {
@@ -81,7 +86,8 @@ void JSString::resolveRope(ExecState* exec) const
             UStringImpl* string = static_cast<UStringImpl*>(currentFiber);
             unsigned length = string->length();
             position -= length;
-            UStringImpl::copyChars(position, string->characters(), length);
+            if (string->characters() != position)
+                UStringImpl::copyChars(position, string->characters(), length);
 
             // Was this the last item in the work queue?
             if (workQueue.isEmpty()) {
@@ -104,9 +110,55 @@ void JSString::resolveRope(ExecState* exec) const
     }
 }
 
+// Finding a range of characters in a rope is only cheaper than flattening it if the
+// range is found quickly, so give up after descending this many ropes.
+static const unsigned maxRopeSearchDepth = 8;
+
+UStringImpl* JSString::fiberContaining(unsigned offset, unsigned length, unsigned& offsetInFiber) const
+{
+    ASSERT(isRope());
+    ASSERT(length);
+    Rope::Fiber* fibers = m_other.m_fibers;
+    unsigned fiberCount = m_fiberCount;
+    for (unsigned depth = 0; depth < maxRopeSearchDepth; ++depth) {
+        unsigned i = 0;
+        while (i < fiberCount && offset >= fibers[i]->length())
+            offset -= fibers[i++]->length();
+        if (i == fiberCount || offset + length > fibers[i]->length())
+            return 0;
+        if (!fibers[i]->isRope()) {
+            offsetInFiber = offset;
+            return static_cast<UStringImpl*>(fibers[i]);
+        }
+        URopeImpl* rope = static_cast<URopeImpl*>(fibers[i]);
+        fibers = &rope->fibers(0);
+        fiberCount = rope->fiberCount();
+    }
+    return 0;
+}
+
+JSString* JSString::substring(ExecState* exec, unsigned offset, unsigned length)
+{
+    ASSERT(offset + length <= m_length);
+    if (!length)
+        return jsEmptyString(exec);
+    if (isRope()) {
+        unsigned offsetInFiber;
+        if (UStringImpl* fiber = fiberContaining(offset, length, offsetInFiber))
+            return jsSubstring(exec, UString(fiber), offsetInFiber, length);
+        resolveRope(exec);
+        if (exec->exception())
+            return jsEmptyString(exec);
+    }
+    return jsSubstring(exec, m_value, offset, length);
+}
+
 JSString* JSString::getIndexSlowCase(ExecState* exec, unsigned i)
 {
     ASSERT(isRope());
+    unsigned offsetInFiber;
+    if (UStringImpl* fiber = fiberContaining(i, 1, offsetInFiber))
+        return jsSingleCharacterSubstring(exec, UString(fiber), offsetInFiber);
     resolveRope(exec);
     // Return a safe no-value result, this should never be used, since the excetion will be thrown.
     if (exec->exception())
@@ -245,6 +245,10 @@ namespace JSC {
         JSString* getIndex(ExecState*, unsigned);
         JSString* getIndexSlowCase(ExecState*, unsigned);
 
+        // Like jsSubstring on the value, but a rope is left unflattened if the
+        // characters all lie within one of its fibers.
+        JSString* substring(ExecState*, unsigned offset, unsigned length);
+
         static PassRefPtr<Structure> createStructure(JSValue proto) { return Structure::create(proto, TypeInfo(StringType, OverridesGetOwnPropertySlot | NeedsThisConversion), AnonymousSlotCount); }
 
     private:
@@ -256,6 +260,7 @@ namespace JSC {
         }
 
         void resolveRope(ExecState*) const;
+        UStringImpl* fiberContaining(unsigned offset, unsigned length, unsigned& offsetInFiber) const;
 
         void appendStringInConstruct(unsigned& index, const UString& string)
         {
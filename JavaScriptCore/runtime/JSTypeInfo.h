@@ -43,6 +43,10 @@ namespace JSC {
     static const unsigned OverridesGetOwnPropertySlot = 1 << 5;
     static const unsigned OverridesMarkChildren = 1 << 6;
     static const unsigned OverridesGetPropertyNames = 1 << 7;
+    // Set by cells whose markChildren() only reaches cells through fields that
+    // are written with Heap::writeBarrier(), so that tracing them does not need
+    // to keep their card dirty for the next nursery collection.
+    static const unsigned HasWriteBarrieredChildren = 1 << 8;
 
     class TypeInfo {
         friend class JIT;
@@ -50,13 +54,15 @@ namespace JSC {
         TypeInfo(JSType type, unsigned flags = 0)
             : m_type(type)
         {
-            ASSERT(flags <= 0xFF);
+            ASSERT(flags <= 0x1FF);
             ASSERT(type <= 0xFF);
             // ImplementsDefaultHasInstance means (ImplementsHasInstance & !OverridesHasInstance)
             if ((flags & (ImplementsHasInstance | OverridesHasInstance)) == ImplementsHasInstance)
-                m_flags = flags | ImplementsDefaultHasInstance;
+                m_flags = (flags | ImplementsDefaultHasInstance) & 0xFF;
             else
-                m_flags = flags;
+                m_flags = flags & 0xFF;
+            // Flags the JIT does not test live outside m_flags, which it reads as a byte.
+            m_flags2 = flags >> 8;
         }
 
         JSType type() const { return (JSType)m_type; }
@@ -68,11 +74,13 @@ namespace JSC {
         bool overridesGetOwnPropertySlot() const { return m_flags & OverridesGetOwnPropertySlot; }
         bool overridesMarkChildren() const { return m_flags & OverridesMarkChildren; }
         bool overridesGetPropertyNames() const { return m_flags & OverridesGetPropertyNames; }
+        bool hasWriteBarrieredChildren() const { return (m_flags2 << 8) & HasWriteBarrieredChildren; }
         unsigned flags() const { return m_flags; }
 
     private:
         unsigned char m_type;
         unsigned char m_flags;
+        unsigned char m_flags2;
     };
 
 }
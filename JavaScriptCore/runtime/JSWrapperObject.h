@@ -42,6 +42,7 @@ namespace JSC {
         }
 
     protected:
+        static const unsigned StructureFlags = HasWriteBarrieredChildren | JSObject::StructureFlags;
         static const unsigned AnonymousSlotCount = 1 + JSObject::AnonymousSlotCount;
 
     private:
@@ -26,6 +26,7 @@
 #include "config.h"
 #include "LiteralParser.h"
 
+#include "ArgList.h"
 #include "JSArray.h"
 #include "JSString.h"
 #include "Lexer.h"
@@ -134,8 +135,20 @@ template <LiteralParser::ParserMode mode> static inline bool isSafeStringCharact
 template <LiteralParser::ParserMode mode> inline LiteralParser::TokenType LiteralParser::Lexer::lexString(LiteralParserToken& token)
 {
     ++m_ptr;
-    const UChar* runStart;
+    const UChar* runStart = m_ptr;
+    while (m_ptr < m_end && isSafeStringCharacter<mode>(*m_ptr))
+        ++m_ptr;
+    if (LIKELY(m_ptr < m_end && *m_ptr == '"')) {
+        token.stringStart = runStart;
+        token.stringLength = m_ptr - runStart;
+        token.stringToken = UString();
+        token.type = TokString;
+        token.end = ++m_ptr;
+        return TokString;
+    }
+
     StringBuilder builder;
+    builder.append(runStart, m_ptr - runStart);
     do {
         runStart = m_ptr;
         while (m_ptr < m_end && isSafeStringCharacter<mode>(*m_ptr))
@@ -201,6 +214,8 @@ template <LiteralParser::ParserMode mode> inline LiteralParser::TokenType Litera
         return TokError;
 
     token.stringToken = builder.build();
+    token.stringStart = token.stringToken.data();
+    token.stringLength = token.stringToken.size();
     token.type = TokString;
     token.end = ++m_ptr;
     return TokString;
@@ -222,10 +237,14 @@ LiteralParser::TokenType LiteralParser::Lexer::lexNumber(LiteralParserToken& tok
     //
     // -?(0 | [1-9][0-9]*) ('.' [0-9]+)? ([eE][+-]? [0-9]+)?
 
-    if (m_ptr < m_end && *m_ptr == '-') // -?
+    bool negative = false;
+    if (m_ptr < m_end && *m_ptr == '-') { // -?
+        negative = true;
         ++m_ptr;
+    }
     
     // (0 | [1-9][0-9]*)
+    const UChar* integerStart = m_ptr;
     if (m_ptr < m_end && *m_ptr == '0') // 0
         ++m_ptr;
     else if (m_ptr < m_end && *m_ptr >= '1' && *m_ptr <= '9') { // [1-9]
@@ -236,6 +255,17 @@ LiteralParser::TokenType LiteralParser::Lexer::lexNumber(LiteralParserToken& tok
     } else
         return TokError;
 
+    // Integers short enough to be exact in an int need no strtod.
+    if (m_ptr - integerStart <= 9 && (m_ptr >= m_end || (*m_ptr != '.' && *m_ptr != 'e' && *m_ptr != 'E'))) {
+        int result = 0;
+        for (const UChar* digit = integerStart; digit < m_ptr; ++digit)
+            result = result * 10 + *digit - '0';
+        token.type = TokNumber;
+        token.end = m_ptr;
+        token.numberToken = negative ? -static_cast<double>(result) : result;
+        return TokNumber;
+    }
+
     // ('.' [0-9]+)?
     if (m_ptr < m_end && *m_ptr == '.') {
         ++m_ptr;
@@ -280,19 +310,92 @@ LiteralParser::TokenType LiteralParser::Lexer::lexNumber(LiteralParserToken& tok
     return TokNumber;
 }
 
+Identifier LiteralParser::makeIdentifier(const UChar* characters, unsigned length)
+{
+    if (!length)
+        return m_exec->propertyNames().emptyIdentifier;
+    unsigned index = (length + characters[0] + characters[length - 1] * 31) % identifierCacheSize;
+    Identifier& cached = m_identifierCache[index];
+    if (cached.isNull() || !Identifier::equal(cached.ustring().rep(), characters, length))
+        cached = Identifier(m_exec, characters, length);
+    return cached;
+}
+
+JSValue LiteralParser::makeString(const Lexer::LiteralParserToken& token)
+{
+    if (token.stringToken.isNull())
+        return jsString(m_exec, UString(token.stringStart, token.stringLength));
+    return jsString(m_exec, token.stringToken);
+}
+
+JSValue LiteralParser::finishArray(MarkedArgumentBuffer& valueStack, size_t start)
+{
+    size_t length = valueStack.size() - start;
+    JSArray* array = constructArray(m_exec, ArgList(valueStack.begin() + start, length));
+    while (valueStack.size() > start)
+        valueStack.removeLast();
+    return array;
+}
+
+JSValue LiteralParser::finishObject(MarkedArgumentBuffer& valueStack, IdentifierStack& identifierStack, size_t start)
+{
+    size_t count = valueStack.size() - start;
+    ASSERT(identifierStack.size() >= count);
+    const Identifier* keys = identifierStack.end() - count;
+    Register* values = valueStack.begin() + start;
+
+    JSObject* object = constructEmptyObject(m_exec);
+    if (count) {
+        ObjectShape& shape = m_objectShapeCache[(keys[0].ustring().rep()->hash() + count) % objectShapeCacheSize];
+        bool shapeMatches = shape.keys.size() == count;
+        for (size_t i = 0; shapeMatches && i < count; ++i)
+            shapeMatches = shape.keys[i] == keys[i];
+
+        if (shapeMatches) {
+            object->transitionTo(shape.structure.get());
+            for (size_t i = 0; i < count; ++i)
+                object->putDirectOffset(shape.offsets[i], values[i].jsValue());
+        } else {
+            for (size_t i = 0; i < count; ++i)
+                object->putDirect(keys[i], values[i].jsValue());
+
+            // Duplicate keys, or enough keys to turn the Structure into a
+            // dictionary, make a shape that cannot be shared.
+            Structure* structure = object->structure();
+            if (!structure->isDictionary() && structure->propertyStorageSize() == count) {
+                shape.keys.clear();
+                shape.offsets.clear();
+                shape.keys.append(keys, count);
+                for (size_t i = 0; i < count; ++i)
+                    shape.offsets.append(structure->get(keys[i]));
+                shape.structure = structure;
+            }
+        }
+    }
+
+    identifierStack.shrink(identifierStack.size() - count);
+    while (valueStack.size() > start)
+        valueStack.removeLast();
+    return object;
+}
+
 JSValue LiteralParser::parse(ParserState initialState)
 {
     ParserState state = initialState;
-    MarkedArgumentBuffer objectStack;
+    // The elements of arrays and the property values of objects wait on
+    // valueStack until their container closes, so that it can be created at
+    // its final size. containerStack has the valueStack size at the start of
+    // each open container.
+    MarkedArgumentBuffer valueStack;
+    Vector<size_t, 16> containerStack;
     JSValue lastValue;
     Vector<ParserState, 16> stateStack;
-    Vector<Identifier, 16> identifierStack;
+    IdentifierStack identifierStack;
     while (1) {
         switch(state) {
             startParseArray:
             case StartParseArray: {
-                JSArray* array = constructEmptyArray(m_exec);
-                objectStack.append(array);
+                containerStack.append(valueStack.size());
                 // fallthrough
             }
             doParseArrayStartExpression:
@@ -302,8 +405,8 @@ JSValue LiteralParser::parse(ParserState initialState)
                     if (lastToken == TokComma)
                         return JSValue();
                     m_lexer.next();
-                    lastValue = objectStack.last();
-                    objectStack.removeLast();
+                    lastValue = finishArray(valueStack, containerStack.last());
+                    containerStack.removeLast();
                     break;
                 }
 
@@ -311,7 +414,7 @@ JSValue LiteralParser::parse(ParserState initialState)
                 goto startParseExpression;
             }
             case DoParseArrayEndExpression: {
-                 asArray(objectStack.last())->push(m_exec, lastValue);
+                valueStack.append(lastValue);
                 
                 if (m_lexer.currentToken().type == TokComma)
                     goto doParseArrayStartExpression;
@@ -320,32 +423,31 @@ JSValue LiteralParser::parse(ParserState initialState)
                     return JSValue();
                 
                 m_lexer.next();
-                lastValue = objectStack.last();
-                objectStack.removeLast();
+                lastValue = finishArray(valueStack, containerStack.last());
+                containerStack.removeLast();
                 break;
             }
             startParseObject:
             case StartParseObject: {
-                JSObject* object = constructEmptyObject(m_exec);
-                objectStack.append(object);
+                containerStack.append(valueStack.size());
 
                 TokenType type = m_lexer.next();
                 if (type == TokString) {
-                    Lexer::LiteralParserToken identifierToken = m_lexer.currentToken();
+                    const Lexer::LiteralParserToken& identifierToken = m_lexer.currentToken();
+                    identifierStack.append(makeIdentifier(identifierToken.stringStart, identifierToken.stringLength));
 
                     // Check for colon
                     if (m_lexer.next() != TokColon)
                         return JSValue();
                     
                     m_lexer.next();
-                    identifierStack.append(Identifier(m_exec, identifierToken.stringToken));
                     stateStack.append(DoParseObjectEndExpression);
                     goto startParseExpression;
                 } else if (type != TokRBrace) 
                     return JSValue();
                 m_lexer.next();
-                lastValue = objectStack.last();
-                objectStack.removeLast();
+                lastValue = finishObject(valueStack, identifierStack, containerStack.last());
+                containerStack.removeLast();
                 break;
             }
             doParseObjectStartExpression:
@@ -353,28 +455,27 @@ JSValue LiteralParser::parse(ParserState initialState)
                 TokenType type = m_lexer.next();
                 if (type != TokString)
                     return JSValue();
-                Lexer::LiteralParserToken identifierToken = m_lexer.currentToken();
+                const Lexer::LiteralParserToken& identifierToken = m_lexer.currentToken();
+                identifierStack.append(makeIdentifier(identifierToken.stringStart, identifierToken.stringLength));
 
                 // Check for colon
                 if (m_lexer.next() != TokColon)
                     return JSValue();
 
                 m_lexer.next();
-                identifierStack.append(Identifier(m_exec, identifierToken.stringToken));
                 stateStack.append(DoParseObjectEndExpression);
                 goto startParseExpression;
             }
             case DoParseObjectEndExpression:
             {
-                asObject(objectStack.last())->putDirect(identifierStack.last(), lastValue);
-                identifierStack.removeLast();
+                valueStack.append(lastValue);
                 if (m_lexer.currentToken().type == TokComma)
                     goto doParseObjectStartExpression;
                 if (m_lexer.currentToken().type != TokRBrace)
                     return JSValue();
                 m_lexer.next();
-                lastValue = objectStack.last();
-                objectStack.removeLast();
+                lastValue = finishObject(valueStack, identifierStack, containerStack.last());
+                containerStack.removeLast();
                 break;
             }
             startParseExpression:
@@ -385,15 +486,13 @@ JSValue LiteralParser::parse(ParserState initialState)
                     case TokLBrace:
                         goto startParseObject;
                     case TokString: {
-                        Lexer::LiteralParserToken stringToken = m_lexer.currentToken();
+                        lastValue = makeString(m_lexer.currentToken());
                         m_lexer.next();
-                        lastValue = jsString(m_exec, stringToken.stringToken);
                         break;
                     }
                     case TokNumber: {
-                        Lexer::LiteralParserToken numberToken = m_lexer.currentToken();
+                        lastValue = jsNumber(m_exec, m_lexer.currentToken().numberToken);
                         m_lexer.next();
-                        lastValue = jsNumber(m_exec, numberToken.numberToken);
                         break;
                     }
                     case TokNull:
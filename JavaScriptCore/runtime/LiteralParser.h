@@ -26,12 +26,18 @@
 #ifndef LiteralParser_h
 #define LiteralParser_h
 
+#include "Identifier.h"
 #include "JSGlobalObjectFunctions.h"
 #include "JSValue.h"
+#include "Structure.h"
 #include "UString.h"
+#include <wtf/RefPtr.h>
+#include <wtf/Vector.h>
 
 namespace JSC {
 
+    class MarkedArgumentBuffer;
+
     class LiteralParser {
     public:
         typedef enum { StrictJSON, NonStrictJSON } ParserMode;
@@ -66,6 +72,10 @@ namespace JSC {
                 TokenType type;
                 const UChar* start;
                 const UChar* end;
+                // The characters of a TokString. A string without escapes is
+                // left in the source, and stringToken is null.
+                const UChar* stringStart;
+                unsigned stringLength;
                 UString stringToken;
                 double numberToken;
             };
@@ -98,12 +108,31 @@ namespace JSC {
             const UChar* m_end;
         };
         
-        class StackGuard;
+        typedef Vector<Identifier, 16> IdentifierStack;
+
+        // Records in an array usually share their keys, in the same order.
+        // The Structure built for one such set of keys is remembered with the
+        // offset of each key, so later objects with the same keys can take
+        // the Structure and have their values stored directly.
+        struct ObjectShape {
+            Vector<Identifier> keys;
+            Vector<size_t> offsets;
+            RefPtr<Structure> structure;
+        };
+        static const unsigned objectShapeCacheSize = 8;
+        static const unsigned identifierCacheSize = 64;
+
         JSValue parse(ParserState);
+        Identifier makeIdentifier(const UChar* characters, unsigned length);
+        JSValue makeString(const Lexer::LiteralParserToken&);
+        JSValue finishArray(MarkedArgumentBuffer& valueStack, size_t start);
+        JSValue finishObject(MarkedArgumentBuffer& valueStack, IdentifierStack&, size_t start);
 
         ExecState* m_exec;
         LiteralParser::Lexer m_lexer;
         ParserMode m_mode;
+        Identifier m_identifierCache[identifierCacheSize];
+        ObjectShape m_objectShapeCache[objectShapeCacheSize];
     };
 }
 
@@ -126,6 +126,25 @@ namespace JSC {
 
         void deleteTable() const;
 
+        // Find an entry in the table by the characters of its key, without making an Identifier.
+        ALWAYS_INLINE const HashEntry* entry(JSGlobalData* globalData, const UChar* characters, unsigned length) const
+        {
+            initializeIfNeeded(globalData);
+
+            const HashEntry* entry = &table[UString::Rep::computeHash(characters, length) & compactHashSizeMask];
+
+            if (!entry->key())
+                return 0;
+
+            do {
+                if (Identifier::equal(entry->key(), characters, length))
+                    return entry;
+                entry = entry->next();
+            } while (entry);
+
+            return 0;
+        }
+
         // Find an entry in the table, and return the entry.
         ALWAYS_INLINE const HashEntry* entry(JSGlobalData* globalData, const Identifier& identifier) const
         {
@@ -26,6 +26,11 @@
 #include "config.h"
 #include "MarkStack.h"
 
+#if ENABLE(PARALLEL_MARKING)
+#include "JSArray.h"
+#include <wtf/Threading.h>
+#endif
+
 namespace JSC {
 
 size_t MarkStack::s_pageSize = 0;
@@ -37,4 +42,217 @@ void MarkStack::compact()
     m_markSets.shrinkAllocation(s_pageSize);
 }
 
+#if ENABLE(PARALLEL_MARKING)
+
+// Marking is bound by memory bandwidth, so more threads than this rarely help.
+static const unsigned maximumMarkingThreads = 8;
+
+// How many cells a marker traces between checks for idle markers to share work with.
+static const unsigned donationInterval = 64;
+
+// Cells that only the collector thread may trace are handed over in batches of this size.
+static const size_t deferredCellsBatchSize = 32;
+
+// Shared between the collector thread's stack and the stacks of its marking threads.
+// Everything but idleMarkers is guarded by lock.
+struct MarkStack::ParallelMarkingData : Noncopyable {
+    ParallelMarkingData(void* jsArrayVPtr)
+        : jsArrayVPtr(jsArrayVPtr)
+        , activeMarkers(0)
+        , idleMarkers(0)
+        , shouldExit(false)
+    {
+    }
+
+    bool hasSharedWork() const { return !sharedCells.isEmpty() || !sharedMarkSets.isEmpty(); }
+
+    void* jsArrayVPtr;
+    Mutex lock;
+    ThreadCondition condition;
+    Vector<JSCell*> sharedCells;
+    Vector<MarkSet> sharedMarkSets;
+    Vector<JSCell*> collectorThreadCells;
+    unsigned activeMarkers;
+    volatile unsigned idleMarkers;
+    bool shouldExit;
+    Vector<ThreadIdentifier> threads;
+};
+
+MarkStack::MarkStack(ParallelMarkingData* data)
+    : m_jsArrayVPtr(data->jsArrayVPtr)
+    , m_shared(data)
+    , m_isCollectorThread(false)
+    , m_donationCountdown(donationInterval)
+#ifndef NDEBUG
+    , m_isCheckingForDefaultMarkViolation(false)
+#endif
+{
+}
+
+void MarkStack::startMarkingThreads(ParallelMarkingData& data)
+{
+    ASSERT(m_isCollectorThread);
+    ASSERT(data.threads.isEmpty());
+
+    unsigned markingThreads = std::min(processorCount(), maximumMarkingThreads);
+    for (unsigned i = 1; i < markingThreads; ++i) {
+        ThreadIdentifier thread = createThread(markingThreadMain, &data, "JavaScriptCore::Marking");
+        if (!thread)
+            break;
+        data.threads.append(thread);
+    }
+}
+
+void MarkStack::stopMarkingThreads(ParallelMarkingData& data)
+{
+    {
+        MutexLocker locker(data.lock);
+        data.shouldExit = true;
+        data.condition.broadcast();
+    }
+    for (size_t i = 0; i < data.threads.size(); ++i)
+        waitForThreadCompletion(data.threads[i], 0);
+    data.threads.clear();
+}
+
+void* MarkStack::markingThreadMain(void* data)
+{
+    MarkStack markStack(static_cast<ParallelMarkingData*>(data));
+    markStack.runMarkingThread();
+    return 0;
+}
+
+void MarkStack::runMarkingThread()
+{
+    ParallelMarkingData& data = *m_shared;
+
+    MutexLocker locker(data.lock);
+    while (true) {
+        while (!data.hasSharedWork() && !data.shouldExit) {
+            ++data.idleMarkers;
+            data.condition.wait(data.lock);
+            --data.idleMarkers;
+        }
+        if (data.shouldExit)
+            return;
+
+        takeSharedWork();
+        ++data.activeMarkers;
+        data.lock.unlock();
+
+        drain();
+        flushDeferredCells();
+
+        data.lock.lock();
+        // The collector thread is waiting for the last active marker to finish.
+        if (!--data.activeMarkers)
+            data.condition.broadcast();
+    }
+}
+
+void MarkStack::drainInParallel()
+{
+    ASSERT(m_isCollectorThread);
+
+    // The marking threads live only as long as this call, so a heap that is
+    // not collecting holds no threads. Starting a handful of threads is cheap
+    // next to marking the heaps that are large enough to get here.
+    ParallelMarkingData data(m_jsArrayVPtr);
+    startMarkingThreads(data);
+    if (data.threads.isEmpty()) {
+        drain();
+        return;
+    }
+
+    m_shared = &data;
+    m_donationCountdown = donationInterval;
+
+    data.lock.lock();
+    ++data.activeMarkers;
+    while (true) {
+        data.lock.unlock();
+        drain();
+        data.lock.lock();
+        --data.activeMarkers;
+
+        while (data.collectorThreadCells.isEmpty() && !data.hasSharedWork() && data.activeMarkers) {
+            ++data.idleMarkers;
+            data.condition.wait(data.lock);
+            --data.idleMarkers;
+        }
+
+        if (!data.collectorThreadCells.isEmpty()) {
+            for (size_t i = 0; i < data.collectorThreadCells.size(); ++i)
+                m_values.append(data.collectorThreadCells[i]);
+            data.collectorThreadCells.clear();
+        } else if (data.hasSharedWork())
+            takeSharedWork();
+        else
+            break;
+        ++data.activeMarkers;
+    }
+    data.lock.unlock();
+
+    ASSERT(!data.activeMarkers);
+    m_shared = 0;
+
+    stopMarkingThreads(data);
+}
+
+void MarkStack::donateWork()
+{
+    m_donationCountdown = donationInterval;
+
+    ParallelMarkingData& data = *m_shared;
+    if (!data.idleMarkers || m_values.size() + m_markSets.size() < 2)
+        return;
+
+    MutexLocker locker(data.lock);
+    for (size_t count = m_values.size() / 2; count; --count)
+        data.sharedCells.append(m_values.removeLast());
+    for (size_t count = (m_markSets.size() + 1) / 2; count; --count)
+        data.sharedMarkSets.append(m_markSets.removeLast());
+    data.condition.broadcast();
+}
+
+// Must be called with the shared lock held.
+void MarkStack::takeSharedWork()
+{
+    ParallelMarkingData& data = *m_shared;
+    size_t markers = data.threads.size() + 1;
+
+    size_t available = data.sharedCells.size();
+    size_t count = std::min(available, std::max<size_t>(1, available / markers));
+    for (size_t i = available - count; i < available; ++i)
+        m_values.append(data.sharedCells[i]);
+    data.sharedCells.shrink(available - count);
+
+    available = data.sharedMarkSets.size();
+    count = std::min(available, std::max<size_t>(1, available / markers));
+    for (size_t i = available - count; i < available; ++i)
+        m_markSets.append(data.sharedMarkSets[i]);
+    data.sharedMarkSets.shrink(available - count);
+}
+
+void MarkStack::deferToCollectorThread(JSCell* cell)
+{
+    m_deferredCells.append(cell);
+    if (m_deferredCells.size() >= deferredCellsBatchSize)
+        flushDeferredCells();
+}
+
+void MarkStack::flushDeferredCells()
+{
+    if (m_deferredCells.isEmpty())
+        return;
+
+    ParallelMarkingData& data = *m_shared;
+    MutexLocker locker(data.lock);
+    data.collectorThreadCells.append(m_deferredCells.data(), m_deferredCells.size());
+    data.condition.broadcast();
+    m_deferredCells.clear();
+}
+
+#endif // ENABLE(PARALLEL_MARKING)
+
 }
@@ -28,6 +28,7 @@
 
 #include "JSValue.h"
 #include <wtf/Noncopyable.h>
+#include <wtf/Vector.h>
 
 namespace JSC {
 
@@ -40,6 +41,11 @@ namespace JSC {
     public:
         MarkStack(void* jsArrayVPtr)
             : m_jsArrayVPtr(jsArrayVPtr)
+#if ENABLE(PARALLEL_MARKING)
+            , m_shared(0)
+            , m_isCollectorThread(true)
+            , m_donationCountdown(0)
+#endif
 #ifndef NDEBUG
             , m_isCheckingForDefaultMarkViolation(false)
 #endif
@@ -48,6 +54,10 @@ namespace JSC {
 
         ALWAYS_INLINE void append(JSValue);
         void append(JSCell*);
+
+        // Queues a cell that is already marked so that its children are visited
+        // again. Used by nursery collections to rescan cells on dirty cards.
+        void appendMarkedCell(JSCell* cell) { m_values.append(cell); }
         
         ALWAYS_INLINE void appendValues(Register* values, size_t count, MarkSetProperties properties = NoNullValues)
         {
@@ -63,6 +73,14 @@ namespace JSC {
         inline void drain();
         void compact();
 
+#if ENABLE(PARALLEL_MARKING)
+        // Like drain(), but shares the work with marking threads that are
+        // started for the call and joined before it returns.
+        // Cells that override markChildren() are still traced on this thread,
+        // since those implementations may not be safe to run concurrently.
+        void drainInParallel();
+#endif
+
         ~MarkStack()
         {
             ASSERT(m_markSets.isEmpty());
@@ -71,6 +89,25 @@ namespace JSC {
 
     private:
         void markChildren(JSCell*);
+        ALWAYS_INLINE bool testAndSetMarked(JSCell*);
+
+#if ENABLE(PARALLEL_MARKING)
+        struct ParallelMarkingData;
+
+        MarkStack(ParallelMarkingData*);
+
+        void startMarkingThreads(ParallelMarkingData&);
+        void stopMarkingThreads(ParallelMarkingData&);
+        static void* markingThreadMain(void*);
+        void runMarkingThread();
+
+        void donateWork();
+        void takeSharedWork();
+        void deferToCollectorThread(JSCell*);
+        void flushDeferredCells();
+
+        static unsigned processorCount();
+#endif
 
         struct MarkSet {
             MarkSet(JSValue* values, JSValue* end, MarkSetProperties properties)
@@ -177,6 +214,13 @@ namespace JSC {
         MarkStackArray<JSCell*> m_values;
         static size_t s_pageSize;
 
+#if ENABLE(PARALLEL_MARKING)
+        ParallelMarkingData* m_shared; // Non-null while marking in parallel.
+        bool m_isCollectorThread;
+        unsigned m_donationCountdown;
+        Vector<JSCell*, 32> m_deferredCells;
+#endif
+
 #ifndef NDEBUG
     public:
         bool m_isCheckingForDefaultMarkViolation;
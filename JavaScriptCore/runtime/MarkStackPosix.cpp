@@ -47,6 +47,14 @@ void MarkStack::releaseStack(void* addr, size_t size)
     munmap(addr, size);
 }
 
+#if ENABLE(PARALLEL_MARKING)
+unsigned MarkStack::processorCount()
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? static_cast<unsigned>(count) : 1;
+}
+#endif
+
 }
 
 #endif
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2010 Apple Inc. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "MegamorphicCache.h"
+
+#include "JSObject.h"
+#include "PropertySlot.h"
+#include "Structure.h"
+#include <wtf/HashFunctions.h>
+
+namespace JSC {
+
+MegamorphicCache::Entry::Entry()
+    : offset(0)
+{
+}
+
+MegamorphicCache::Entry::~Entry()
+{
+}
+
+MegamorphicCache::MegamorphicCache()
+    : m_hits(0)
+    , m_misses(0)
+{
+}
+
+MegamorphicCache::~MegamorphicCache()
+{
+}
+
+inline MegamorphicCache::Entry& MegamorphicCache::lookup(Structure* structure, UString::Rep* propertyName)
+{
+    return m_entries[(WTF::PtrHash<Structure*>::hash(structure) ^ propertyName->existingHash()) & (cacheSize - 1)];
+}
+
+bool MegamorphicCache::get(JSValue baseValue, const Identifier& propertyName, JSValue& result)
+{
+    if (!baseValue.isObject())
+        return false;
+
+    JSObject* baseObject = asObject(baseValue);
+    Structure* structure = baseObject->structure();
+    UString::Rep* rep = propertyName.ustring().rep();
+    Entry& entry = lookup(structure, rep);
+    if (entry.structure != structure || entry.propertyName != rep) {
+        ++m_misses;
+        return false;
+    }
+
+    // A Structure that is not a dictionary never changes, so the property is
+    // still missing from the base object and the prototype is still the same
+    // object; only the prototype's own Structure needs checking.
+    JSObject* slotBase = baseObject;
+    if (entry.prototypeStructure) {
+        slotBase = asObject(structure->storedPrototype());
+        if (slotBase->structure() != entry.prototypeStructure) {
+            ++m_misses;
+            return false;
+        }
+    }
+
+    ++m_hits;
+    result = slotBase->getDirectOffset(entry.offset);
+    return true;
+}
+
+void MegamorphicCache::add(JSValue baseValue, const Identifier& propertyName, const PropertySlot& slot)
+{
+    if (!baseValue.isObject() || !slot.isCacheableValue())
+        return;
+
+    // Dictionaries change in place, so their Structure says nothing about
+    // where a property is. Neither does a variable object's, since it finds
+    // variables in its symbol table first.
+    JSObject* baseObject = asObject(baseValue);
+    Structure* structure = baseObject->structure();
+    if (structure->isDictionary() || baseObject->isVariableObject())
+        return;
+
+    Structure* prototypeStructure = 0;
+    if (slot.slotBase() != baseValue) {
+        if (slot.slotBase() != structure->storedPrototype())
+            return;
+        JSObject* prototype = asObject(slot.slotBase());
+        prototypeStructure = prototype->structure();
+        if (prototypeStructure->isDictionary() || prototype->isVariableObject())
+            return;
+    }
+
+    UString::Rep* rep = propertyName.ustring().rep();
+    Entry& entry = lookup(structure, rep);
+    entry.structure = structure;
+    entry.prototypeStructure = prototypeStructure;
+    entry.propertyName = rep;
+    entry.offset = slot.cachedOffset();
+}
+
+void MegamorphicCache::clear()
+{
+    for (size_t i = 0; i < cacheSize; ++i)
+        m_entries[i] = Entry();
+}
+
+} // namespace JSC
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2010 Apple Inc. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MegamorphicCache_h
+#define MegamorphicCache_h
+
+#include "UString.h"
+#include <wtf/Noncopyable.h>
+#include <wtf/RefPtr.h>
+
+namespace JSC {
+
+    class Identifier;
+    class JSValue;
+    class PropertySlot;
+    class Structure;
+
+    // Remembers where get_by_id found a property, keyed by the base object's
+    // Structure and the property name, for sites that have seen too many
+    // Structures to be cached inline. Only plain value properties of the base
+    // object or of its prototype are cached.
+    class MegamorphicCache : public Noncopyable {
+    public:
+        MegamorphicCache();
+        ~MegamorphicCache();
+
+        // Returns false, leaving result untouched, if the lookup must be done
+        // the slow way.
+        bool get(JSValue baseValue, const Identifier& propertyName, JSValue& result);
+        void add(JSValue baseValue, const Identifier& propertyName, const PropertySlot&);
+        void clear();
+
+        // Lookups on immediates and non-object cells are not counted.
+        size_t hits() const { return m_hits; }
+        size_t misses() const { return m_misses; }
+
+    private:
+        static const size_t cacheSize = 512;
+
+        struct Entry {
+            Entry();
+            ~Entry();
+
+            RefPtr<Structure> structure;
+            RefPtr<Structure> prototypeStructure; // 0 if the property is the base object's own.
+            RefPtr<UString::Rep> propertyName;
+            size_t offset;
+        };
+
+        Entry& lookup(Structure*, UString::Rep* propertyName);
+
+        Entry m_entries[cacheSize];
+        size_t m_hits;
+        size_t m_misses;
+    };
+
+} // namespace JSC
+
+#endif // MegamorphicCache_h
@@ -57,19 +57,10 @@ inline RegExp::RegExp(JSGlobalData* globalData, const UString& pattern)
 
 inline RegExp::RegExp(JSGlobalData* globalData, const UString& pattern, const UString& flags)
     : m_pattern(pattern)
-    , m_flagBits(0)
+    , m_flagBits(flagBits(flags))
     , m_constructionError(0)
     , m_numSubpatterns(0)
 {
-    // NOTE: The global flag is handled on a case-by-case basis by functions like
-    // String::match and RegExpObject::match.
-    if (flags.find('g') != UString::NotFound)
-        m_flagBits |= Global;
-    if (flags.find('i') != UString::NotFound)
-        m_flagBits |= IgnoreCase;
-    if (flags.find('m') != UString::NotFound)
-        m_flagBits |= Multiline;
-
     compile(globalData);
 }
 
@@ -90,6 +81,20 @@ PassRefPtr<RegExp> RegExp::create(JSGlobalData* globalData, const UString& patte
     return adoptRef(new RegExp(globalData, pattern, flags));
 }
 
+int RegExp::flagBits(const UString& flags)
+{
+    // NOTE: The global flag is handled on a case-by-case basis by functions like
+    // String::match and RegExpObject::match.
+    int flagBits = 0;
+    if (flags.find('g') != UString::NotFound)
+        flagBits |= Global;
+    if (flags.find('i') != UString::NotFound)
+        flagBits |= IgnoreCase;
+    if (flags.find('m') != UString::NotFound)
+        flagBits |= Multiline;
+    return flagBits;
+}
+
 #if ENABLE(YARR)
 
 void RegExp::compile(JSGlobalData* globalData)
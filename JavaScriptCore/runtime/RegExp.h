@@ -39,6 +39,7 @@ namespace JSC {
     public:
         static PassRefPtr<RegExp> create(JSGlobalData* globalData, const UString& pattern);
         static PassRefPtr<RegExp> create(JSGlobalData* globalData, const UString& pattern, const UString& flags);
+        static int flagBits(const UString& flags);
 #if !ENABLE(YARR)
         ~RegExp();
 #endif
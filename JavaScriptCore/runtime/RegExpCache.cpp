@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2010 Apple Inc. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "RegExpCache.h"
+
+#include "RegExp.h"
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+RegExpCache::Entry::Entry()
+    : used(false)
+{
+}
+
+RegExpCache::Entry::~Entry()
+{
+}
+
+RegExpCache::RegExpCache()
+    : m_maxEntries(defaultMaxEntries)
+    , m_hits(0)
+    , m_misses(0)
+{
+}
+
+RegExpCache::~RegExpCache()
+{
+}
+
+PassRefPtr<RegExp> RegExpCache::lookupOrCreate(JSGlobalData* globalData, const UString& pattern)
+{
+    return lookupOrCreate(globalData, pattern, 0, UString());
+}
+
+PassRefPtr<RegExp> RegExpCache::lookupOrCreate(JSGlobalData* globalData, const UString& pattern, const UString& flags)
+{
+    return lookupOrCreate(globalData, pattern, RegExp::flagBits(flags), flags);
+}
+
+PassRefPtr<RegExp> RegExpCache::lookupOrCreate(JSGlobalData* globalData, const UString& pattern, int flagBits, const UString& flags)
+{
+    if (!m_maxEntries || pattern.isNull())
+        return RegExp::create(globalData, pattern, flags);
+
+    RegExpCacheKey key(pattern.rep(), flagBits);
+    EntryMap::iterator iter = m_entries.find(key);
+    if (iter != m_entries.end()) {
+        ++m_hits;
+        iter->second.used = true;
+        return iter->second.regExp;
+    }
+
+    ++m_misses;
+    RefPtr<RegExp> regExp = RegExp::create(globalData, pattern, flags);
+    if (size() >= m_maxEntries) {
+        evictUnreferencedEntries();
+        if (size() >= m_maxEntries)
+            return regExp.release();
+    }
+
+    Entry& entry = m_entries.add(key, Entry()).first->second;
+    entry.regExp = regExp;
+    entry.used = true;
+    return regExp.release();
+}
+
+void RegExpCache::evictUnreferencedEntries()
+{
+    Vector<RegExpCacheKey> unreferenced;
+    EntryMap::iterator end = m_entries.end();
+    for (EntryMap::iterator iter = m_entries.begin(); iter != end; ++iter) {
+        if (iter->second.regExp->hasOneRef())
+            unreferenced.append(iter->first);
+    }
+
+    size_t size = unreferenced.size();
+    for (size_t i = 0; i < size; ++i)
+        m_entries.remove(unreferenced[i]);
+}
+
+void RegExpCache::pruneUnusedEntries()
+{
+    Vector<RegExpCacheKey> unused;
+    EntryMap::iterator end = m_entries.end();
+    for (EntryMap::iterator iter = m_entries.begin(); iter != end; ++iter) {
+        if (!iter->second.used)
+            unused.append(iter->first);
+        iter->second.used = false;
+    }
+
+    size_t size = unused.size();
+    for (size_t i = 0; i < size; ++i)
+        m_entries.remove(unused[i]);
+}
+
+void RegExpCache::clear()
+{
+    m_entries.clear();
+}
+
+void RegExpCache::setMaxEntries(size_t maxEntries)
+{
+    m_maxEntries = maxEntries;
+    if (size() > m_maxEntries)
+        clear();
+}
+
+} // namespace JSC
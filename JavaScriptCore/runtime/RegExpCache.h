@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2010 Apple Inc. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RegExpCache_h
+#define RegExpCache_h
+
+#include "UString.h"
+#include <wtf/HashMap.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/RefPtr.h>
+
+namespace JSC {
+
+    class JSGlobalData;
+    class RegExp;
+
+    // A pattern and its flags. Unlike a std::pair, a Vector moves this by
+    // copy construction, so the RefPtr is never moved with memcpy.
+    struct RegExpCacheKey {
+        RegExpCacheKey()
+            : flagBits(0)
+        {
+        }
+
+        RegExpCacheKey(UString::Rep* pattern, int flagBits)
+            : flagBits(flagBits)
+            , pattern(pattern)
+        {
+        }
+
+        RegExpCacheKey(WTF::HashTableDeletedValueType)
+            : flagBits(0)
+            , pattern(WTF::HashTableDeletedValue)
+        {
+        }
+
+        bool isHashTableDeletedValue() const { return pattern.isHashTableDeletedValue(); }
+
+        int flagBits;
+        RefPtr<UString::Rep> pattern;
+    };
+
+    inline bool operator==(const RegExpCacheKey& a, const RegExpCacheKey& b)
+    {
+        return a.flagBits == b.flagBits && a.pattern == b.pattern;
+    }
+
+    struct RegExpCacheHash {
+        static unsigned hash(const RegExpCacheKey& key)
+        {
+            return key.pattern->hash() + static_cast<unsigned>(key.flagBits);
+        }
+
+        static bool equal(const RegExpCacheKey& a, const RegExpCacheKey& b)
+        {
+            return a.flagBits == b.flagBits && JSC::equal(a.pattern.get(), b.pattern.get());
+        }
+
+        static const bool safeToCompareToEmptyOrDeleted = false;
+    };
+
+    struct RegExpCacheHashTraits : WTF::GenericHashTraits<RegExpCacheKey> {
+        static void constructDeletedValue(RegExpCacheKey& slot) { new (&slot) RegExpCacheKey(WTF::HashTableDeletedValue); }
+        static bool isDeletedValue(const RegExpCacheKey& value) { return value.isHashTableDeletedValue(); }
+    };
+
+    // Shares compiled RegExps between regular expression literals, the RegExp
+    // constructor and String.prototype.match/search, keyed by pattern and flags.
+    // A RegExp holds no per-use state (lastIndex lives in RegExpObject), so one
+    // compiled pattern can back any number of RegExpObjects.
+    //
+    // The cache holds at most maxEntries() RegExps. When it is full, entries
+    // that nothing else references are evicted; a full garbage collection also
+    // drops entries that have not been used since the previous one.
+    class RegExpCache : public Noncopyable {
+    public:
+        RegExpCache();
+        ~RegExpCache();
+
+        PassRefPtr<RegExp> lookupOrCreate(JSGlobalData*, const UString& pattern);
+        PassRefPtr<RegExp> lookupOrCreate(JSGlobalData*, const UString& pattern, const UString& flags);
+
+        // Called by the collector after each full collection.
+        void pruneUnusedEntries();
+        void clear();
+
+        size_t size() const { return static_cast<size_t>(m_entries.size()); }
+        size_t maxEntries() const { return m_maxEntries; }
+        // A limit of 0 disables the cache.
+        void setMaxEntries(size_t);
+
+        size_t hits() const { return m_hits; }
+        size_t misses() const { return m_misses; }
+
+        static const size_t defaultMaxEntries = 256;
+
+    private:
+        struct Entry {
+            Entry();
+            ~Entry();
+
+            RefPtr<RegExp> regExp;
+            bool used;
+        };
+
+        typedef HashMap<RegExpCacheKey, Entry, RegExpCacheHash, RegExpCacheHashTraits> EntryMap;
+
+        PassRefPtr<RegExp> lookupOrCreate(JSGlobalData*, const UString& pattern, int flagBits, const UString& flags);
+        void evictUnreferencedEntries();
+
+        EntryMap m_entries;
+        size_t m_maxEntries;
+        size_t m_hits;
+        size_t m_misses;
+    };
+
+} // namespace JSC
+
+#endif // RegExpCache_h
@@ -56,6 +56,9 @@ namespace JSC {
 
         UString::Rep* singleCharacterStringRep(unsigned char character);
 
+        // Entries are null until first used; the JIT reads them directly.
+        JSString** singleCharacterStrings() { return m_singleCharacterStrings; }
+
         void markChildren(MarkStack&);
         void clear();
 
@@ -44,9 +44,13 @@ public:
 
     void append(const char* str, size_t len)
     {
-        buffer.reserveCapacity(buffer.size() + len);
+        // grow() keeps the geometric growth of append(); reserveCapacity()
+        // would reallocate to the exact size every time the buffer fills up.
+        size_t oldSize = buffer.size();
+        buffer.grow(oldSize + len);
+        UChar* destination = buffer.data() + oldSize;
         for (size_t i = 0; i < len; i++)
-            buffer.append(static_cast<unsigned char>(str[i]));
+            destination[i] = static_cast<unsigned char>(str[i]);
     }
 
     void append(const UChar* str, size_t len)
@@ -45,8 +45,6 @@ namespace JSC {
 ASSERT_CLASS_FITS_IN_CELL(StringPrototype);
 
 static JSValue JSC_HOST_CALL stringProtoFuncToString(ExecState*, JSObject*, JSValue, const ArgList&);
-static JSValue JSC_HOST_CALL stringProtoFuncCharAt(ExecState*, JSObject*, JSValue, const ArgList&);
-static JSValue JSC_HOST_CALL stringProtoFuncCharCodeAt(ExecState*, JSObject*, JSValue, const ArgList&);
 static JSValue JSC_HOST_CALL stringProtoFuncConcat(ExecState*, JSObject*, JSValue, const ArgList&);
 static JSValue JSC_HOST_CALL stringProtoFuncIndexOf(ExecState*, JSObject*, JSValue, const ArgList&);
 static JSValue JSC_HOST_CALL stringProtoFuncLastIndexOf(ExecState*, JSObject*, JSValue, const ArgList&);
@@ -475,19 +473,25 @@ JSValue JSC_HOST_CALL stringProtoFuncToString(ExecState* exec, JSObject*, JSValu
 
 JSValue JSC_HOST_CALL stringProtoFuncCharAt(ExecState* exec, JSObject*, JSValue thisValue, const ArgList& args)
 {
-    UString s = thisValue.toThisString(exec);
-    unsigned len = s.size();
+    // Strings are read through the JSString, so that a rope need not be flattened.
+    JSString* thisString = thisValue.isString() ? asString(thisValue) : 0;
+    UString s = thisString ? UString() : thisValue.toThisString(exec);
+    unsigned len = thisString ? thisString->length() : s.size();
     JSValue a0 = args.at(0);
-    if (a0.isUInt32()) {
-        uint32_t i = a0.asUInt32();
-        if (i < len)
-            return jsSingleCharacterSubstring(exec, s, i);
-        return jsEmptyString(exec);
+    unsigned i;
+    if (a0.isUInt32())
+        i = a0.asUInt32();
+    else {
+        double dpos = a0.toInteger(exec);
+        if (dpos < 0 || dpos >= len)
+            return jsEmptyString(exec);
+        i = static_cast<unsigned>(dpos);
     }
-    double dpos = a0.toInteger(exec);
-    if (dpos >= 0 && dpos < len)
-        return jsSingleCharacterSubstring(exec, s, static_cast<unsigned>(dpos));
-    return jsEmptyString(exec);
+    if (i >= len)
+        return jsEmptyString(exec);
+    if (thisString)
+        return thisString->getIndex(exec, i);
+    return jsSingleCharacterSubstring(exec, s, i);
 }
 
 JSValue JSC_HOST_CALL stringProtoFuncCharCodeAt(ExecState* exec, JSObject*, JSValue thisValue, const ArgList& args)
@@ -590,7 +594,7 @@ JSValue JSC_HOST_CALL stringProtoFuncMatch(ExecState* exec, JSObject*, JSValue t
          *  If regexp is not an object whose [[Class]] property is "RegExp", it is
          *  replaced with the result of the expression new RegExp(regexp).
          */
-        reg = RegExp::create(&exec->globalData(), a0.toString(exec));
+        reg = exec->globalData().regExpCache.lookupOrCreate(&exec->globalData(), a0.toString(exec));
     }
     RegExpConstructor* regExpConstructor = exec->lexicalGlobalObject()->regExpConstructor();
     int pos;
@@ -640,7 +644,7 @@ JSValue JSC_HOST_CALL stringProtoFuncSearch(ExecState* exec, JSObject*, JSValue
          *  If regexp is not an object whose [[Class]] property is "RegExp", it is
          *  replaced with the result of the expression new RegExp(regexp).
          */
-        reg = RegExp::create(&exec->globalData(), a0.toString(exec));
+        reg = exec->globalData().regExpCache.lookupOrCreate(&exec->globalData(), a0.toString(exec));
     }
     RegExpConstructor* regExpConstructor = exec->lexicalGlobalObject()->regExpConstructor();
     int pos;
@@ -651,8 +655,9 @@ JSValue JSC_HOST_CALL stringProtoFuncSearch(ExecState* exec, JSObject*, JSValue
 
 JSValue JSC_HOST_CALL stringProtoFuncSlice(ExecState* exec, JSObject*, JSValue thisValue, const ArgList& args)
 {
-    UString s = thisValue.toThisString(exec);
-    int len = s.size();
+    JSString* thisString = thisValue.isString() ? asString(thisValue) : 0;
+    UString s = thisString ? UString() : thisValue.toThisString(exec);
+    int len = thisString ? thisString->length() : s.size();
 
     JSValue a0 = args.at(0);
     JSValue a1 = args.at(1);
@@ -667,6 +672,8 @@ JSValue JSC_HOST_CALL stringProtoFuncSlice(ExecState* exec, JSObject*, JSValue t
             from = 0;
         if (to > len)
             to = len;
+        if (thisString)
+            return thisString->substring(exec, static_cast<unsigned>(from), static_cast<unsigned>(to) - static_cast<unsigned>(from));
         return jsSubstring(exec, s, static_cast<unsigned>(from), static_cast<unsigned>(to) - static_cast<unsigned>(from));
     }
 
@@ -738,8 +745,9 @@ JSValue JSC_HOST_CALL stringProtoFuncSplit(ExecState* exec, JSObject*, JSValue t
 
 JSValue JSC_HOST_CALL stringProtoFuncSubstr(ExecState* exec, JSObject*, JSValue thisValue, const ArgList& args)
 {
-    UString s = thisValue.toThisString(exec);
-    int len = s.size();
+    JSString* thisString = thisValue.isString() ? asString(thisValue) : 0;
+    UString s = thisString ? UString() : thisValue.toThisString(exec);
+    int len = thisString ? thisString->length() : s.size();
 
     JSValue a0 = args.at(0);
     JSValue a1 = args.at(1);
@@ -755,13 +763,16 @@ JSValue JSC_HOST_CALL stringProtoFuncSubstr(ExecState* exec, JSObject*, JSValue
     }
     if (start + length > len)
         length = len - start;
+    if (thisString)
+        return thisString->substring(exec, static_cast<unsigned>(start), static_cast<unsigned>(length));
     return jsSubstring(exec, s, static_cast<unsigned>(start), static_cast<unsigned>(length));
 }
 
 JSValue JSC_HOST_CALL stringProtoFuncSubstring(ExecState* exec, JSObject*, JSValue thisValue, const ArgList& args)
 {
-    UString s = thisValue.toThisString(exec);
-    int len = s.size();
+    JSString* thisString = thisValue.isString() ? asString(thisValue) : 0;
+    UString s = thisString ? UString() : thisValue.toThisString(exec);
+    int len = thisString ? thisString->length() : s.size();
 
     JSValue a0 = args.at(0);
     JSValue a1 = args.at(1);
@@ -787,6 +798,8 @@ JSValue JSC_HOST_CALL stringProtoFuncSubstring(ExecState* exec, JSObject*, JSVal
         end = start;
         start = temp;
     }
+    if (thisString)
+        return thisString->substring(exec, static_cast<unsigned>(start), static_cast<unsigned>(end) - static_cast<unsigned>(start));
     return jsSubstring(exec, s, static_cast<unsigned>(start), static_cast<unsigned>(end) - static_cast<unsigned>(start));
 }
 
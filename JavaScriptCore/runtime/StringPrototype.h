@@ -38,6 +38,10 @@ namespace JSC {
         static const ClassInfo info;
     };
 
+    // The JIT has inline versions of these for flat strings; see JITIntrinsics.cpp.
+    JSValue JSC_HOST_CALL stringProtoFuncCharAt(ExecState*, JSObject*, JSValue, const ArgList&);
+    JSValue JSC_HOST_CALL stringProtoFuncCharCodeAt(ExecState*, JSObject*, JSValue, const ArgList&);
+
 } // namespace JSC
 
 #endif // StringPrototype_h
@@ -37,6 +37,7 @@ using namespace std;
 namespace JSC {
 
 static const unsigned minLengthToShare = 20;
+static const unsigned minLengthToGrowInPlace = 64;
 
 UStringImpl::~UStringImpl()
 {
@@ -134,6 +135,56 @@ PassRefPtr<UStringImpl> UStringImpl::create(PassRefPtr<SharedUChar> sharedBuffer
     return adoptRef(new UStringImpl(buffer, length, sharedBuffer));
 }
 
+bool UStringImpl::isFlattenedRope() const
+{
+    BufferOwnership ownership = bufferOwnership();
+    if (ownership == BufferSubstring)
+        return m_substringBuffer->isFlattenedRope();
+    return ownership == BufferInternal && m_capacity;
+}
+
+// A rope whose leftmost fiber was itself made by flattening a rope is most likely
+// a string being built up by repeated concatenation, which will be flattened again
+// once more has been appended to it. Rather than copying the whole string each time,
+// such a rope is flattened into a buffer with room to spare, owned by a UStringImpl
+// that is never handed out, and the result is a substring of it. When a later rope
+// starts with the last characters written to that buffer, and the rest fits, the
+// rest is written after them in place.
+PassRefPtr<UStringImpl> UStringImpl::tryCreateForRope(unsigned length, UStringImpl* prefix, UChar*& output)
+{
+    if (!length) {
+        output = 0;
+        return empty();
+    }
+
+    if (length >= minLengthToGrowInPlace && prefix->isFlattenedRope()) {
+        if (prefix->bufferOwnership() == BufferSubstring) {
+            UStringImpl* buffer = prefix->m_substringBuffer;
+            unsigned end = (prefix->m_data - buffer->m_data) + prefix->m_length;
+            unsigned additionalLength = length - prefix->m_length;
+            if (end == buffer->m_length && additionalLength && additionalLength <= buffer->m_capacity - end) {
+                buffer->m_length += additionalLength;
+                output = const_cast<UChar*>(prefix->m_data);
+                return adoptRef(new UStringImpl(output, length, buffer));
+            }
+        }
+
+        unsigned capacity = length + length / 2;
+        if (capacity > length) {
+            if (RefPtr<UStringImpl> buffer = tryCreateUninitialized(capacity, output)) {
+                buffer->m_length = length;
+                buffer->m_capacity = capacity;
+                return adoptRef(new UStringImpl(output, length, buffer.release()));
+            }
+        }
+    }
+
+    RefPtr<UStringImpl> string = tryCreateUninitialized(length, output);
+    if (string)
+        string->m_capacity = length;
+    return string.release();
+}
+
 SharedUChar* UStringImpl::sharedBuffer()
 {
     if (m_length < minLengthToShare)
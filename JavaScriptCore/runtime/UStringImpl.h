@@ -227,6 +227,11 @@ public:
         return empty();
     }
 
+    // Creates the string for a rope of the given length being flattened, whose
+    // leftmost fiber is prefix. The characters of prefix may already be in place
+    // at the start of the returned buffer, in which case they need not be copied.
+    static PassRefPtr<UStringImpl> tryCreateForRope(unsigned length, UStringImpl* prefix, UChar*& output);
+
     SharedUChar* sharedBuffer();
     const UChar* characters() const { return m_data; }
 
@@ -238,6 +243,8 @@ public:
 
         if (m_refCountAndFlags & s_refCountFlagShouldReportedCost) {
             m_refCountAndFlags &= ~s_refCountFlagShouldReportedCost;
+            if (bufferOwnership() == BufferInternal && m_capacity > m_length)
+                return m_capacity;
             return m_length;
         }
         return 0;
@@ -278,10 +285,14 @@ private:
 
     BufferOwnership bufferOwnership() const { return static_cast<BufferOwnership>(m_refCountAndFlags & s_refCountMaskBufferOwnership); }
     bool isStatic() const { return m_refCountAndFlags & s_refCountFlagStatic; }
+    bool isFlattenedRope() const;
 
     const UChar* m_data;
     union {
         void* m_buffer;
+        // For BufferInternal strings made by flattening a rope, the number of
+        // characters the buffer has room for; zero for other strings.
+        unsigned m_capacity;
         UStringImpl* m_substringBuffer;
         SharedUChar* m_sharedBuffer;
     };
@@ -72,8 +72,10 @@ public:
 private:
     void assign(T* ptr)
     {
-        if (ptr)
+        if (ptr) {
             Heap::markCell(ptr);
+            Heap::writeBarrier(ptr);
+        }
         m_ptr = ptr;
     }
 
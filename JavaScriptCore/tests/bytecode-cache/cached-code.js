@@ -0,0 +1,132 @@
+description("Functions compiled from the bytecode cache behave like freshly compiled ones, and a damaged cache is ignored.");
+
+// run-javascriptcore-tests runs this file against an empty cache ("cold"), the
+// cache that run saved ("warm"), a copy failing its checksums ("damaged") and
+// a copy with altered entries and valid checksums ("forged").
+var phase = bytecodeCachePhase;
+
+function sum(n)
+{
+    var total = 0;
+    for (var i = 0; i < n; ++i)
+        total += i;
+    return total;
+}
+
+function keys(object)
+{
+    var names = [];
+    for (var name in object)
+        names.push(name);
+    return names.join(",");
+}
+
+function finallyOrder()
+{
+    var steps = [];
+    for (var i = 0; i < 3; ++i) {
+        try {
+            if (i == 1)
+                continue;
+            steps.push("t" + i);
+        } finally {
+            steps.push("f" + i);
+        }
+    }
+    return steps.join(",");
+}
+
+function catchesTypeError()
+{
+    try {
+        null.property;
+    } catch (e) {
+        return e instanceof TypeError;
+    }
+    return false;
+}
+
+function withScope(object)
+{
+    with (object)
+        return x + y;
+}
+
+function Point(x, y)
+{
+    this.x = x;
+    this.y = y;
+}
+Point.prototype.length = function() { return Math.sqrt(this.x * this.x + this.y * this.y); };
+
+function ReturnsObject()
+{
+    this.ignored = true;
+    return { replaced: true };
+}
+
+function countArguments()
+{
+    return arguments.length + ":" + Array.prototype.join.call(arguments, "");
+}
+
+function maximum()
+{
+    return Math.max.apply(Math, arguments);
+}
+
+function counter(start)
+{
+    return function() { return ++start; };
+}
+
+function classify(value)
+{
+    switch (value) {
+    case 1:
+        return "one";
+    case "two":
+        return "two";
+    default:
+        return "other";
+    }
+}
+
+function getterValue()
+{
+    var object = { get x() { return 7; }, set x(value) { this.y = value; } };
+    object.x = 3;
+    return object.x + object.y;
+}
+
+function evalLocal(a)
+{
+    return eval("a + 1");
+}
+
+var before = bytecodeCacheStatistics();
+
+shouldBe("sum(10)", "45");
+shouldBe("keys({ a: 1, b: 2 })", "'a,b'");
+shouldBe("finallyOrder()", "'t0,f0,f1,t2,f2'");
+shouldBeTrue("catchesTypeError()");
+shouldBe("withScope({ x: 1, y: 2 })", "3");
+shouldBe("new Point(3, 4).length()", "5");
+shouldBeTrue("new ReturnsObject().replaced");
+shouldBe("countArguments(1, 2, 3)", "'3:123'");
+shouldBe("maximum(4, 9, 2)", "9");
+var next = counter(5);
+next();
+shouldBe("next()", "7");
+shouldBe("classify(1) + classify('two') + classify(null)", "'onetwoother'");
+shouldBe("getterValue()", "10");
+shouldBe("evalLocal(1)", "2");
+
+var after = bytecodeCacheStatistics();
+var hits = after.hits - before.hits;
+var misses = after.misses - before.misses;
+if (phase == "warm") {
+    shouldBe("misses", "0");
+    shouldBeTrue("hits > 0");
+} else if (phase != "forged")
+    shouldBe("hits", "0");
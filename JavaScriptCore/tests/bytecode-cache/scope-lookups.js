@@ -0,0 +1,33 @@
+description("Cached code is only used where the names it looked up resolve the way they did when it was compiled.");
+
+var value = "global";
+
+// The two functions below have the same text, and so share a cache entry,
+// but "value" is a global in one and a closure variable in the other.
+var readGlobal = function() { return value; };
+
+function makeReader()
+{
+    var value = "local";
+    return function() { return value; };
+}
+var readLocal = makeReader();
+
+function makeReaderWithoutLocal()
+{
+    return function() { return value; };
+}
+var readGlobalFromClosure = makeReaderWithoutLocal();
+
+shouldBe("readGlobal()", "'global'");
+var before = bytecodeCacheStatistics();
+shouldBe("readLocal()", "'local'");
+var afterLocal = bytecodeCacheStatistics();
+shouldBe("readGlobalFromClosure()", "'global'");
+
+// readGlobal's code, just stored for the shared text, reads a global that
+// readLocal's closure variable hides.
+shouldBe("afterLocal.hits - before.hits", "0");
+
+value = "changed";
+shouldBe("readGlobal() + readGlobalFromClosure() + readLocal()", "'changedchangedlocal'");
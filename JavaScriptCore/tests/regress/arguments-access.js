@@ -0,0 +1,83 @@
+description("arguments.length and arguments[i] read the call frame until the arguments object is needed, and must give the same results as the object would, with or without the JIT.");
+
+function length() { return arguments.length; }
+function lengthWithParameters(a, b) { return arguments.length; }
+shouldBe("length()", "0");
+shouldBe("length(1, 2, 3)", "3");
+shouldBe("lengthWithParameters()", "0");
+shouldBe("lengthWithParameters(1)", "1");
+shouldBe("lengthWithParameters(1, 2, 3, 4)", "4");
+
+// Functions without parameters take a different path when they create the
+// arguments object.
+function argument(i) { return arguments[i]; }
+function argumentWithoutParameters() { return arguments[arguments[0]]; }
+function argumentWithParameters(i, b, c) { return arguments[i]; }
+
+shouldBe("argument(0)", "0");
+shouldBe("argument(1, 'one')", "'one'");
+shouldBe("argument(3, 'one', 'two', 'three')", "'three'");
+shouldBe("argument(2, 'one')", "undefined");
+shouldBe("argument('length', 'one')", "2");
+shouldBe("argument('0')", "'0'");
+shouldBe("argument(-1)", "undefined");
+shouldBe("argument(1.5, 'one')", "undefined");
+
+shouldBe("argumentWithoutParameters(0)", "0");
+shouldBe("argumentWithoutParameters(2, 'one', 'two')", "'two'");
+shouldBe("argumentWithoutParameters(5, 'one')", "undefined");
+shouldBe("argumentWithoutParameters('length', 'one')", "2");
+
+shouldBe("argumentWithParameters(0)", "0");
+shouldBe("argumentWithParameters(2)", "undefined");
+shouldBe("argumentWithParameters(2, 'one', 'two')", "'two'");
+shouldBe("argumentWithParameters(4, 'one', 'two', 'three', 'four')", "'four'");
+shouldBe("argumentWithParameters(5, 'one', 'two', 'three', 'four')", "undefined");
+
+// Indices that were not passed come from Object.prototype.
+Object.prototype[5] = "from the prototype";
+Object.prototype[1] = "shadowed";
+shouldBe("argument(5)", "'from the prototype'");
+shouldBe("argument(1, 'own')", "'own'");
+shouldBe("argument(1)", "'shadowed'");
+shouldBe("argumentWithoutParameters(5, 'one')", "'from the prototype'");
+shouldBe("argumentWithoutParameters(1)", "'shadowed'");
+shouldBe("argumentWithParameters(5, 'one')", "'from the prototype'");
+shouldBe("argumentWithParameters(1)", "'shadowed'");
+delete Object.prototype[5];
+delete Object.prototype[1];
+shouldBe("argument(5)", "undefined");
+shouldBe("argumentWithoutParameters(1)", "undefined");
+
+// The same reads in a loop, after the arguments object has been created by
+// an earlier read, and after the arguments have been changed.
+function sumArguments() {
+    var sum = 0;
+    for (var i = 0; i < arguments.length + 2; ++i)
+        sum += arguments[i] === undefined ? 1000 : arguments[i];
+    return sum;
+}
+shouldBe("sumArguments(1, 2, 3)", "2006");
+shouldBe("sumArguments()", "2000");
+
+function readAfterWrite(a) {
+    var before = arguments[0];
+    arguments[0] = "written";
+    arguments[3] = "added";
+    return [before, a, arguments[0], arguments[3], arguments.length].join();
+}
+shouldBe("readAfterWrite('passed')", "'passed,written,written,added,1'");
+
+function readAfterWriteWithoutParameters() {
+    var before = arguments[0];
+    arguments[0] = "written";
+    arguments[3] = "added";
+    return [before, arguments[0], arguments[3], arguments.length].join();
+}
+shouldBe("readAfterWriteWithoutParameters('passed')", "'passed,written,added,1'");
+
+function lengthAfterOverride() {
+    arguments.length = 7;
+    return [arguments.length, arguments[6]].join();
+}
+shouldBe("lengthAfterOverride(1, 2)", "'7,'");
@@ -0,0 +1,123 @@
+description("shift, unshift and splice at the front of arrays, checked against the generic algorithms run on an array-like object.");
+
+function describe(array)
+{
+    var parts = [];
+    for (var i = 0; i < array.length; ++i)
+        parts.push(i in array ? String(array[i]) : "_");
+    return array.length + ":" + parts.join(",");
+}
+
+function arrayLike(array)
+{
+    var object = { length: array.length };
+    for (var i = 0; i < array.length; ++i) {
+        if (i in array)
+            object[i] = array[i];
+    }
+    return object;
+}
+
+var seed = 1;
+function random(n)
+{
+    seed = (seed * 1103515245 + 12345) % 2147483648;
+    return seed % n;
+}
+
+function applyRandomOperation(array, model)
+{
+    var value = "v" + random(1000);
+    switch (random(6)) {
+    case 0:
+        return [array.shift(), Array.prototype.shift.call(model)];
+    case 1:
+        return [array.unshift(value, value + "b"), Array.prototype.unshift.call(model, value, value + "b")];
+    case 2:
+        var start = random(4);
+        var deleteCount = random(3);
+        return [array.splice(start, deleteCount).join(), Array.prototype.splice.call(model, start, deleteCount).join()];
+    case 3:
+        var start = random(4);
+        var deleteCount = random(3);
+        return [array.splice(start, deleteCount, value).join(), Array.prototype.splice.call(model, start, deleteCount, value).join()];
+    case 4:
+        var start = array.length - random(3);
+        return [array.splice(start, 1, value, value).join(), Array.prototype.splice.call(model, start, 1, value, value).join()];
+    default:
+        return [array.push(value), Array.prototype.push.call(model, value)];
+    }
+}
+
+function runRandomOperations(array, operations)
+{
+    var model = arrayLike(array);
+    for (var i = 0; i < operations; ++i) {
+        var results = applyRandomOperation(array, model);
+        if (results[0] !== results[1] || describe(array) != describe(model))
+            return "operation " + i + ": " + describe(array) + " returned " + results[0] + ", expected " + describe(model) + " returned " + results[1];
+        if (!(i % 500))
+            gc();
+    }
+    return "ok";
+}
+
+// Dense arrays take the fast paths.
+var dense = [];
+for (var i = 0; i < 20; ++i)
+    dense.push(i);
+shouldBe("runRandomOperations(dense, 3000)", "'ok'");
+
+var numbers = [0.5, 1, 2.5, 3, 4.5, 5];
+shouldBe("runRandomOperations(numbers, 1000)", "'ok'");
+
+var a = [1, 2, 3, 4, 5];
+shouldBe("a.shift()", "1");
+shouldBe("a.unshift(0)", "5");
+shouldBe("a.join()", "'0,2,3,4,5'");
+shouldBe("a.splice(0, 2, 'x', 'y', 'z').join()", "'0,2'");
+shouldBe("a.join()", "'x,y,z,3,4,5'");
+shouldBe("a.splice(1, 3).join()", "'y,z,3'");
+shouldBe("a.join()", "'x,4,5'");
+shouldBe("a.splice(0, 0, 'p', 'q').length", "0");
+shouldBe("a.join()", "'p,q,x,4,5'");
+
+// Shifting everything out and unshifting back reuses the space in front.
+var b = [];
+for (var i = 0; i < 100; ++i)
+    b.push(i);
+for (var i = 0; i < 100; ++i)
+    b.shift();
+shouldBe("b.length", "0");
+for (var i = 0; i < 100; ++i)
+    b.unshift(i);
+shouldBe("b[0] + b[99] + b.length", "199");
+
+// Holes make the fast paths bail out, so values come from the prototype.
+var holes = [1, , 3, , 5];
+shouldBe("runRandomOperations(holes, 1000)", "'ok'");
+
+Array.prototype[1] = "fromPrototype";
+var c = [0, , 2];
+shouldBe("c.shift()", "0");
+shouldBe("c.hasOwnProperty(0)", "true");
+shouldBe("c[0]", "'fromPrototype'");
+shouldBe("c.length", "2");
+var d = [, 1];
+shouldBe("d.unshift('u')", "3");
+shouldBe("d.hasOwnProperty(1)", "false");
+shouldBe("d[1]", "'fromPrototype'");
+delete Array.prototype[1];
+
+// Sparse arrays keep values in the sparse map, and also take the slow path.
+var sparse = [0, 1, 2];
+sparse[50000] = "far";
+shouldBe("sparse.shift()", "0");
+shouldBe("sparse.length", "50000");
+shouldBe("sparse[49999]", "'far'");
+shouldBe("sparse.unshift('a', 'b')", "50002");
+shouldBe("sparse[50001]", "'far'");
+shouldBe("sparse.slice(0, 4).join()", "'a,b,1,2'");
+shouldBe("sparse.splice(1, 2).join()", "'b,1'");
+shouldBe("sparse[49999]", "'far'");
+shouldBe("sparse.length", "50000");
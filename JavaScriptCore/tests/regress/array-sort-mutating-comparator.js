@@ -0,0 +1,89 @@
+description("Array.prototype.sort with a compare function that changes the array leaves it consistent, and keeps the values being sorted alive.");
+
+var size = 100;
+
+function objects()
+{
+    var array = [];
+    for (var i = 0; i < size; ++i)
+        array.push({ key: (i * 37) % size });
+    return array;
+}
+
+function isSortedByKey(array, length)
+{
+    for (var i = 1; i < length; ++i) {
+        if (!(i in array) || array[i - 1].key > array[i].key)
+            return false;
+    }
+    return true;
+}
+
+// Sorts array by key, calling mutate(array) before the first comparison.
+// Counts the comparisons that see a value that is no longer an intact object.
+var damagedValues;
+function sortMutating(array, mutate)
+{
+    damagedValues = 0;
+    var mutated = false;
+    array.sort(function(a, b) {
+        if (!mutated) {
+            mutated = true;
+            mutate(array);
+        }
+        if (typeof a.key != "number" || typeof b.key != "number")
+            ++damagedValues;
+        return a.key - b.key;
+    });
+    return array;
+}
+
+// shift() moves the vector forward and shortens it.
+var shifted = sortMutating(objects(), function(array) { array.shift(); });
+shouldBe("shifted.length", "size - 1");
+shouldBeTrue("isSortedByKey(shifted, shifted.length)");
+shouldBe("damagedValues", "0");
+
+// The values being sorted are only referenced by the sort once the array is empty.
+var emptied = sortMutating(objects(), function(array) {
+    array.length = 0;
+    for (var i = 0; i < 1000; ++i)
+        [{ garbage: i }];
+    gc();
+});
+shouldBe("emptied.length", "0");
+shouldBe("damagedValues", "0");
+
+var truncated = sortMutating(objects(), function(array) { array.length = 10; });
+shouldBe("truncated.length", "10");
+shouldBeTrue("isSortedByKey(truncated, 10)");
+
+// Growing the array reallocates its vector.
+var grown = sortMutating(objects(), function(array) {
+    for (var i = 0; i < 1000; ++i)
+        array.push({ key: -1 });
+});
+shouldBe("grown.length", "size + 1000");
+shouldBeTrue("isSortedByKey(grown, size)");
+shouldBe("grown[0].key", "0");
+shouldBe("grown[size].key", "-1");
+shouldBe("grown[size + 999].key", "-1");
+
+var sparse = sortMutating(objects(), function(array) { array[1000000] = { key: -1 }; });
+shouldBe("sparse.length", "1000001");
+shouldBeTrue("isSortedByKey(sparse, size)");
+shouldBeFalse("size in sparse");
+shouldBe("sparse[1000000].key", "-1");
+
+// Holes made by the compare function are filled by the sorted values.
+var holes = sortMutating(objects(), function(array) {
+    delete array[0];
+    delete array[size - 1];
+});
+shouldBe("holes.length", "size");
+shouldBeTrue("isSortedByKey(holes, size)");
+shouldBe("holes[0].key + holes[size - 1].key", "size - 1");
+
+var unshifted = sortMutating(objects(), function(array) { array.unshift({ key: -1 }, { key: -1 }); });
+shouldBe("unshifted.length", "size + 2");
+shouldBeTrue("isSortedByKey(unshifted, size)");
@@ -0,0 +1,22 @@
+description("Cells marked as code block constants before the first collection must still have their children traced by nursery collections.");
+
+// Calling a global function loads the global object as a constant, so it is marked
+// before any collection, and the array in the global variable is only reachable through it.
+function callsGlobalFunction(value)
+{
+    return String(value);
+}
+callsGlobalFunction(1);
+
+var kept = [];
+for (var i = 0; i < 200000; ++i) {
+    var o = { i: i, s: "s" + i };
+    if (i % 100 == 0)
+        kept.push(o);
+}
+
+var keptSum = 0;
+for (var i = 0; i < kept.length; ++i)
+    keptSum += kept[i].i + kept[i].s.length;
+shouldBe("kept.length", "2000");
+shouldBe("keptSum", "199912888");
@@ -0,0 +1,79 @@
+description("Stores into cells that survived a collection must keep the stored values alive through later nursery collections.");
+
+function churn()
+{
+    var last;
+    for (var i = 0; i < 20000; ++i)
+        last = { i: i, s: "c" + i };
+    return last.i;
+}
+
+function makeCounter()
+{
+    var box = { n: 0 };
+    return {
+        set: function(n) { box = { n: n, tag: "box" + n }; },
+        get: function() { return box.n + ":" + box.tag; }
+    };
+}
+
+function makeArguments(a, b)
+{
+    return arguments;
+}
+
+function makeArgumentsWithActivation(a, b)
+{
+    var read = function() { return a.v + "/" + b.v; };
+    arguments.read = read;
+    return arguments;
+}
+
+function lateCompiled()
+{
+    return ["late", "compiled", "constant"].join("-");
+}
+
+var counters = [];
+for (var i = 0; i < 50; ++i)
+    counters.push(makeCounter());
+var args = makeArguments({ v: 1 }, { v: 2 });
+var argsWithActivation = makeArgumentsWithActivation({ v: 3 }, { v: 4 });
+var accessors = {};
+accessors.__defineGetter__("value", function() { return "first"; });
+var wrapper = new String("old");
+var enumerated = {};
+for (var i = 0; i < 20; ++i)
+    enumerated["p" + i] = i;
+
+churn();
+churn();
+
+for (var i = 0; i < counters.length; ++i)
+    counters[i].set(i);
+args[0] = { v: 10 };
+args[1] = { v: 20 };
+argsWithActivation[0] = { v: 30 };
+accessors.__defineGetter__("value", function() { return "second"; });
+var late = lateCompiled();
+
+churn();
+churn();
+
+var counterText = "";
+for (var i = 0; i < counters.length; i += 10)
+    counterText += counters[i].get() + " ";
+shouldBe("counterText", "'0:box0 10:box10 20:box20 30:box30 40:box40 '");
+shouldBe("args[0].v + args[1].v", "30");
+shouldBe("argsWithActivation.read()", "'30/4'");
+shouldBe("accessors.value", "'second'");
+shouldBe("String(wrapper)", "'old'");
+shouldBe("late", "'late-compiled-constant'");
+shouldBe("lateCompiled()", "'late-compiled-constant'");
+
+var names = [];
+for (var name in enumerated) {
+    churn();
+    names.push(name);
+}
+shouldBe("names.join()", "'p0,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19'");
@@ -0,0 +1,172 @@
+description("Math.abs, floor, max, min and sqrt, String.prototype.charAt and charCodeAt and Array.prototype.push give the same results through the JIT's intrinsic thunks as through the functions themselves, for the values the thunks handle and the ones they pass on.");
+
+// Like shouldBe, distinguishes -0 from 0 and matches NaN.
+function isSameValue(a, b)
+{
+    if (a !== a)
+        return b !== b;
+    return a === b && (a !== 0 || 1 / a === 1 / b);
+}
+
+// Calls f through the same call site a few times, so that the later calls go
+// through the linked thunk.
+function repeated(f, a, b)
+{
+    var first = f(a, b);
+    for (var i = 0; i < 3; ++i) {
+        var result = f(a, b);
+        if (!isSameValue(result, first))
+            return "first call returned " + first + ", a later one " + result;
+    }
+    return first;
+}
+
+function abs(x) { return Math.abs(x); }
+function absOfNothing() { return Math.abs(); }
+function floor(x) { return Math.floor(x); }
+function max(x, y) { return Math.max(x, y); }
+function min(x, y) { return Math.min(x, y); }
+function maxOfThree(x, y) { return Math.max(x, y, 0); }
+function sqrt(x) { return Math.sqrt(x); }
+function charCodeAt(s, i) { return s.charCodeAt(i); }
+function charAt(s, i) { return s.charAt(i); }
+function charCodeAtOfNothing(s) { return s.charCodeAt(); }
+
+var valueOfThree = { valueOf: function() { return -3; } };
+
+shouldBe("repeated(abs, 5)", "5");
+shouldBe("repeated(abs, -5)", "5");
+shouldBe("repeated(abs, 0)", "0");
+shouldBe("repeated(abs, -2147483648)", "2147483648");
+shouldBe("repeated(abs, -1.5)", "1.5");
+shouldBe("repeated(abs, -4.0)", "4");
+shouldBe("repeated(abs, -0)", "0");
+shouldBe("repeated(abs, NaN)", "NaN");
+shouldBe("repeated(abs, -Infinity)", "Infinity");
+shouldBe("repeated(abs, '-7')", "7");
+shouldBe("repeated(abs, null)", "0");
+shouldBe("repeated(abs, undefined)", "NaN");
+shouldBe("repeated(abs, valueOfThree)", "3");
+shouldBe("repeated(absOfNothing)", "NaN");
+
+shouldBe("repeated(floor, 7)", "7");
+shouldBe("repeated(floor, -7)", "-7");
+shouldBe("repeated(floor, 2.5)", "2");
+shouldBe("repeated(floor, -2.5)", "-3");
+shouldBe("repeated(floor, -3.0)", "-3");
+shouldBe("repeated(floor, -0.5)", "-1");
+shouldBe("repeated(floor, -0)", "-0");
+shouldBe("repeated(floor, 0.5)", "0");
+shouldBe("repeated(floor, 1e20)", "1e20");
+shouldBe("repeated(floor, -1e20)", "-1e20");
+shouldBe("repeated(floor, 2147483647.5)", "2147483647");
+shouldBe("repeated(floor, -2147483648.5)", "-2147483649");
+shouldBe("repeated(floor, NaN)", "NaN");
+shouldBe("repeated(floor, Infinity)", "Infinity");
+shouldBe("repeated(floor, '2.9')", "2");
+shouldBe("repeated(floor, valueOfThree)", "-3");
+
+shouldBe("repeated(max, 3, 4)", "4");
+shouldBe("repeated(max, -3, -4)", "-3");
+shouldBe("repeated(min, 3, 4)", "3");
+shouldBe("repeated(min, -3, -4)", "-4");
+shouldBe("repeated(max, 2147483647, -2147483648)", "2147483647");
+shouldBe("repeated(min, 2147483647, -2147483648)", "-2147483648");
+shouldBe("repeated(max, 1.5, 1)", "1.5");
+shouldBe("repeated(min, 1, 0.5)", "0.5");
+shouldBe("repeated(max, 1, NaN)", "NaN");
+shouldBe("repeated(min, NaN, 1)", "NaN");
+shouldBe("repeated(max, -0, 0)", "0");
+shouldBe("repeated(min, 0, -0)", "-0");
+shouldBe("repeated(max, '5', 2)", "5");
+shouldBe("repeated(min, valueOfThree, 2)", "-3");
+shouldBe("repeated(max, 1)", "NaN");
+shouldBe("repeated(maxOfThree, -1, -2)", "0");
+
+shouldBe("repeated(sqrt, 4)", "2");
+shouldBe("repeated(sqrt, 2)", "Math.SQRT2");
+shouldBe("repeated(sqrt, 0.25)", "0.5");
+shouldBe("repeated(sqrt, -0)", "-0");
+shouldBe("repeated(sqrt, -1)", "NaN");
+shouldBe("repeated(sqrt, Infinity)", "Infinity");
+shouldBe("repeated(sqrt, '9')", "3");
+shouldBe("repeated(sqrt, undefined)", "NaN");
+
+var notString = { toString: function() { return "12345"; }, charAt: String.prototype.charAt, charCodeAt: String.prototype.charCodeAt };
+var flat = "abc\u1234";
+var rope = "ab";
+rope += "c\u1234";
+shouldBe("repeated(charCodeAt, flat, 0)", "97");
+shouldBe("repeated(charCodeAt, flat, 3)", "0x1234");
+shouldBe("repeated(charCodeAt, rope, 1)", "98");
+shouldBe("repeated(charCodeAt, flat, 4)", "NaN");
+shouldBe("repeated(charCodeAt, flat, -1)", "NaN");
+shouldBe("repeated(charCodeAt, flat, 4294967296)", "NaN");
+shouldBe("repeated(charCodeAt, flat, 1.9)", "98");
+shouldBe("repeated(charCodeAt, flat, '2')", "99");
+shouldBe("repeated(charCodeAt, flat, NaN)", "97");
+shouldBe("repeated(charCodeAt, flat, undefined)", "97");
+shouldBe("repeated(charCodeAtOfNothing, flat)", "97");
+shouldBe("repeated(charCodeAt, notString, 1)", "50");
+shouldBe("repeated(charCodeAt, new String('xyz'), 2)", "122");
+
+shouldBe("repeated(charAt, flat, 0)", "'a'");
+shouldBe("repeated(charAt, flat, 3)", "'\u1234'");
+shouldBe("repeated(charAt, rope, 2)", "'c'");
+shouldBe("repeated(charAt, flat, 4)", "''");
+shouldBe("repeated(charAt, flat, -1)", "''");
+shouldBe("repeated(charAt, flat, 2.5)", "'c'");
+shouldBe("repeated(charAt, flat, '1')", "'b'");
+shouldBe("repeated(charAt, '\u00ff\u0100', 0)", "'\u00ff'");
+shouldBe("repeated(charAt, '\u00ff\u0100', 1)", "'\u0100'");
+shouldBe("repeated(charAt, notString, 4)", "'5'");
+
+function pushOne(array, value) { return array.push(value); }
+function pushTwo(array, value) { return array.push(value, value); }
+
+var pushed = [];
+for (var i = 0; i < 100; ++i)
+    pushOne(pushed, i);
+shouldBe("pushed.length", "100");
+shouldBe("pushed[0] + pushed[50] + pushed[99]", "149");
+
+var values = [];
+shouldBe("pushOne(values, 1.5)", "1");
+shouldBe("pushOne(values, 'string')", "2");
+shouldBe("pushOne(values, undefined)", "3");
+shouldBe("pushOne(values, { key: 4 })", "4");
+shouldBe("pushTwo(values, null)", "6");
+shouldBe("values[0] + ',' + values[1] + ',' + values[2] + ',' + values[3].key + ',' + values[5]", "'1.5,string,undefined,4,null'");
+shouldBeTrue("2 in values");
+
+var holes = [1, , 3];
+shouldBe("pushOne(holes, 4)", "4");
+shouldBeFalse("1 in holes");
+shouldBe("holes[3]", "4");
+
+var lengthened = [1];
+lengthened.length = 10;
+shouldBe("pushOne(lengthened, 2)", "11");
+shouldBe("lengthened[10]", "2");
+shouldBeFalse("5 in lengthened");
+
+var large = [];
+large[100000] = 0;
+shouldBe("pushOne(large, 1)", "100002");
+shouldBe("large[100001]", "1");
+
+var arrayLike = { length: 2, push: Array.prototype.push };
+shouldBe("pushOne(arrayLike, 'x')", "3");
+shouldBe("arrayLike[2]", "'x'");
+
+// Values pushed by the thunk stay alive through a collection.
+var kept = [];
+for (var i = 0; i < 1000; ++i)
+    pushOne(kept, { index: i });
+gc();
+var wrong = 0;
+for (var i = 0; i < kept.length; ++i) {
+    if (kept[i].index !== i)
+        ++wrong;
+}
+shouldBe("wrong", "0");
@@ -0,0 +1,114 @@
+description("Property reads at sites that have seen too many Structures go through the megamorphic cache, which must notice when the objects it remembered change.");
+
+// Each call site below sees far more Structures than fit in a polymorphic
+// list, so it falls back to the megamorphic cache.
+function readP(o) { return o.p; }
+function readQ(o) { return o.q; }
+
+function objectsWithShapes(count, prototype) {
+    var objects = [];
+    for (var i = 0; i < count; ++i) {
+        var o = Object.create(prototype);
+        o["shape" + i] = i;
+        objects.push(o);
+    }
+    return objects;
+}
+
+function readAll(read, objects) {
+    var results = [];
+    for (var i = 0; i < objects.length; ++i)
+        results.push(read(objects[i]));
+    return results.join(",");
+}
+
+function repeat(value, count) {
+    var results = [];
+    for (var i = 0; i < count; ++i)
+        results.push(value);
+    return results.join(",");
+}
+
+// A property on the prototype that is replaced, shadowed by another
+// prototype property, deleted and added again.
+var proto = { p: "first" };
+var objects = objectsWithShapes(32, proto);
+for (var i = 0; i < 4; ++i)
+    readAll(readP, objects);
+shouldBe("readAll(readP, objects)", "repeat('first', 32)");
+
+proto.p = "second";
+shouldBe("readAll(readP, objects)", "repeat('second', 32)");
+
+proto.unrelated = true;
+shouldBe("readAll(readP, objects)", "repeat('second', 32)");
+
+delete proto.p;
+shouldBe("readAll(readP, objects)", "repeat('', 32)");
+
+proto.p = "third";
+shouldBe("readAll(readP, objects)", "repeat('third', 32)");
+
+Object.prototype.q = "inherited";
+shouldBe("readAll(readQ, objects)", "repeat('inherited', 32)");
+proto.q = "shadowed";
+shouldBe("readAll(readQ, objects)", "repeat('shadowed', 32)");
+delete proto.q;
+shouldBe("readAll(readQ, objects)", "repeat('inherited', 32)");
+delete Object.prototype.q;
+shouldBe("readAll(readQ, objects)", "repeat('', 32)");
+
+// An own property added to an object that used to find p on its prototype.
+objects[5].p = "own";
+shouldBe("readP(objects[5])", "'own'");
+shouldBe("readP(objects[6])", "'third'");
+delete objects[5].p;
+shouldBe("readP(objects[5])", "'third'");
+
+// Dictionary objects keep their Structure while their properties move.
+var dictionaries = [];
+for (var i = 0; i < 32; ++i) {
+    var o = { a: 1, p: "before" + i, b: 2 };
+    o["shape" + i] = i;
+    delete o.a;
+    dictionaries.push(o);
+}
+for (var i = 0; i < 4; ++i)
+    readAll(readP, dictionaries);
+for (var i = 0; i < 32; ++i) {
+    delete dictionaries[i].p;
+    dictionaries[i].c = "c" + i;
+    dictionaries[i].p = "after" + i;
+}
+shouldBe("readP(dictionaries[0])", "'after0'");
+shouldBe("readP(dictionaries[31])", "'after31'");
+for (var i = 0; i < 32; ++i)
+    delete dictionaries[i].p;
+shouldBe("readAll(readP, dictionaries)", "repeat('', 32)");
+
+// A dictionary prototype whose property moves.
+var dictionaryProto = { a: 1, p: "proto-before" };
+delete dictionaryProto.a;
+var dictionaryChildren = objectsWithShapes(32, dictionaryProto);
+for (var i = 0; i < 4; ++i)
+    readAll(readP, dictionaryChildren);
+delete dictionaryProto.p;
+dictionaryProto.z = "z";
+dictionaryProto.p = "proto-after";
+shouldBe("readAll(readP, dictionaryChildren)", "repeat('proto-after', 32)");
+
+// A getter installed after the cache has filled up and started evicting.
+var getterProto = { p: "value" };
+var getterChildren = objectsWithShapes(1024, getterProto);
+for (var i = 0; i < 2; ++i)
+    readAll(readP, getterChildren);
+shouldBe("readAll(readP, getterChildren)", "repeat('value', 1024)");
+
+getterProto.__defineGetter__("p", function() { return "getter"; });
+shouldBe("readAll(readP, getterChildren)", "repeat('getter', 1024)");
+
+var ownGetter = getterChildren[100];
+ownGetter.__defineGetter__("shape100", function() { return "own getter"; });
+ownGetter.__defineGetter__("p", function() { return "own p"; });
+shouldBe("readP(ownGetter)", "'own p'");
+shouldBe("readP(getterChildren[101])", "'getter'");
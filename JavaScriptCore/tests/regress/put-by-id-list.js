@@ -0,0 +1,120 @@
+description("Property stores at sites that see several Structures cache each case in a list, and must keep storing correctly once the list is full or the prototype chain changes.");
+
+function setX(o, value) { o.x = value; }
+function setY(o) { o.y = "stored"; }
+
+function objectWithShape(shape) {
+    var o = {};
+    o["shape" + shape] = shape;
+    return o;
+}
+
+function describe(o) {
+    var names = [];
+    for (var name in o)
+        names.push(name + "=" + o[name]);
+    return names.join(" ");
+}
+
+// Many more Structures than the list holds, both replacing and adding x.
+var replaced = [];
+var added = [];
+for (var i = 0; i < 40; ++i) {
+    var o = objectWithShape(i);
+    o.x = -1;
+    replaced.push(o);
+    added.push(objectWithShape(i));
+}
+for (var round = 0; round < 3; ++round) {
+    for (var i = 0; i < 40; ++i) {
+        setX(replaced[i], round * 100 + i);
+        setX(added[i], round * 100 + i);
+    }
+}
+var wrong = 0;
+for (var i = 0; i < 40; ++i) {
+    if (describe(replaced[i]) != "shape" + i + "=" + i + " x=" + (200 + i))
+        ++wrong;
+    if (describe(added[i]) != "shape" + i + "=" + i + " x=" + (200 + i))
+        ++wrong;
+}
+shouldBe("wrong", "0");
+
+// Objects that need their property storage grown to take x.
+var large = [];
+for (var i = 0; i < 12; ++i) {
+    var o = objectWithShape(i);
+    for (var j = 0; j < 3 + i; ++j)
+        o["p" + j] = j;
+    large.push(o);
+}
+for (var round = 0; round < 3; ++round) {
+    for (var i = 0; i < 12; ++i)
+        setX(round ? large[i] : objectWithShape(i), "large" + i);
+}
+shouldBe("large[0].x", "'large0'");
+shouldBe("large[11].x", "'large11'");
+shouldBe("large[11].p13", "13");
+shouldBe("large[11].shape11", "11");
+
+// The first case cached is a replace, which is done inline and has no stub
+// of its own; the list is built behind it.
+function setZ(o, value) { o.z = value; }
+var first = { z: 0 };
+setZ(first, 1);
+setZ(first, 2);
+var others = [];
+for (var i = 0; i < 6; ++i)
+    others.push(objectWithShape(i));
+for (var i = 0; i < 6; ++i)
+    setZ(others[i], "other" + i);
+for (var i = 0; i < 6; ++i)
+    setZ(objectWithShape(i), "fresh" + i);
+setZ(first, 3);
+shouldBe("describe(first)", "'z=3'");
+shouldBe("describe(others[0])", "'shape0=0 z=other0'");
+shouldBe("describe(others[5])", "'shape5=5 z=other5'");
+var late = objectWithShape(3);
+setZ(late, "late");
+shouldBe("describe(late)", "'shape3=3 z=late'");
+
+// A setter added to the prototype after transitions that add y were cached.
+var proto = {};
+function Child(shape) { this["shape" + shape] = shape; }
+Child.prototype = proto;
+for (var round = 0; round < 3; ++round) {
+    for (var i = 0; i < 6; ++i)
+        setY(new Child(i));
+}
+shouldBe("describe(Object.getPrototypeOf(new Child(0)))", "''");
+
+var setterCalls = 0;
+proto.__defineSetter__("y", function(value) { ++setterCalls; });
+var children = [];
+for (var i = 0; i < 6; ++i) {
+    var child = new Child(i);
+    setY(child);
+    children.push(child);
+}
+shouldBe("setterCalls", "6");
+shouldBeFalse("children[0].hasOwnProperty('y')");
+shouldBeFalse("children[5].hasOwnProperty('y')");
+
+// The same for a setter further up the prototype chain.
+function setW(o) { o.w = "stored"; }
+for (var round = 0; round < 3; ++round) {
+    for (var i = 0; i < 6; ++i)
+        setW(new Child(i));
+}
+var objectSetterCalls = 0;
+Object.prototype.__defineSetter__("w", function(value) { ++objectSetterCalls; });
+var grandchildren = [];
+for (var i = 0; i < 6; ++i) {
+    var child = new Child(i);
+    setW(child);
+    grandchildren.push(child);
+}
+delete Object.prototype.w;
+shouldBe("objectSetterCalls", "6");
+shouldBeFalse("grandchildren[0].hasOwnProperty('w')");
+shouldBeFalse("grandchildren[5].hasOwnProperty('w')");
@@ -0,0 +1,78 @@
+description("RegExps that share a compiled pattern through the cache behave like independent RegExps, and the cache evicts instead of growing past its limit.");
+
+var maxEntries = regExpCacheStatistics().maxEntries;
+
+// A hit hands out the same compiled pattern, but not the same RegExp object.
+var before = regExpCacheStatistics();
+var first = new RegExp("cache-hit-(\\d+)", "g");
+var second = new RegExp("cache-hit-(\\d+)", "g");
+var after = regExpCacheStatistics();
+shouldBe("after.misses - before.misses", "1");
+shouldBe("after.hits - before.hits", "1");
+shouldBeFalse("first === second");
+
+var subject = "cache-hit-1 cache-hit-22";
+shouldBe("first.exec(subject)[1]", "'1'");
+shouldBe("first.lastIndex", "11");
+shouldBe("second.lastIndex", "0");
+shouldBe("second.exec(subject)[1]", "'1'");
+shouldBe("first.exec(subject)[1]", "'22'");
+shouldBe("second.exec(subject)[1]", "'22'");
+
+// The flags are part of the key.
+var global = new RegExp("Flag", "g");
+var ignoreCase = new RegExp("Flag", "i");
+var plain = new RegExp("Flag");
+shouldBeTrue("global.global");
+shouldBeFalse("global.ignoreCase");
+shouldBeTrue("ignoreCase.ignoreCase");
+shouldBeFalse("ignoreCase.global");
+shouldBeFalse("plain.global || plain.ignoreCase || plain.multiline");
+shouldBe("'flag'.search(ignoreCase)", "0");
+shouldBe("'flag'.search(plain)", "-1");
+
+// match and search with a string argument share entries with new RegExp().
+before = regExpCacheStatistics();
+shouldBe("'xxab+'.search('b\\\\+')", "3");
+shouldBe("'xxab+'.match('b\\\\+')[0]", "'b+'");
+after = regExpCacheStatistics();
+shouldBe("after.hits - before.hits", "1");
+
+// Patterns that nothing holds on to are evicted when the cache fills up.
+var wrong = 0;
+for (var i = 0; i < maxEntries * 3; ++i) {
+    if (!new RegExp("^unreferenced" + i + "$").test("unreferenced" + i))
+        ++wrong;
+}
+shouldBe("wrong", "0");
+shouldBeTrue("regExpCacheStatistics().size <= maxEntries");
+
+// Once the collector has freed the RegExpObjects, a full cache makes room.
+gc();
+before = regExpCacheStatistics();
+new RegExp("after-eviction");
+new RegExp("after-eviction");
+after = regExpCacheStatistics();
+shouldBe("after.hits - before.hits", "1");
+shouldBeTrue("after.size < maxEntries");
+
+// Patterns that are still in use cannot be evicted; past the limit, new
+// patterns are compiled without being cached.
+var live = [];
+for (var i = 0; i < maxEntries + 20; ++i)
+    live.push(new RegExp("^live" + i + "$"));
+shouldBeTrue("regExpCacheStatistics().size <= maxEntries");
+wrong = 0;
+for (var i = 0; i < live.length; ++i) {
+    if (!live[i].test("live" + i) || live[i].test("live" + (i + 1)))
+        ++wrong;
+}
+shouldBe("wrong", "0");
+live = null;
+
+// Entries unused since the previous full collection are dropped.
+gc();
+gc();
+var afterCollection = regExpCacheStatistics().size;
+shouldBe("afterCollection", "0");
+shouldBeTrue("new RegExp('^live7$').test('live7')");
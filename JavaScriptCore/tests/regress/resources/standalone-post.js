@@ -0,0 +1,4 @@
+if (failureCount)
+    print("FAIL " + failureCount + " check(s) failed");
+else
+    print("TEST COMPLETE");
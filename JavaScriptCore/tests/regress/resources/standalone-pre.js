@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2010 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Loaded by run-javascriptcore-tests ahead of each test in tests/regress and
+// tests/bytecode-cache.
+// Tests report with the functions below; any line starting with "FAIL"
+// fails the test.
+
+var failureCount = 0;
+
+function description(msg)
+{
+    print(msg);
+}
+
+function testPassed(msg)
+{
+    print("PASS " + msg);
+}
+
+function testFailed(msg)
+{
+    print("FAIL " + msg);
+    ++failureCount;
+}
+
+function stringify(value)
+{
+    if (typeof value == "string")
+        return "\"" + value + "\"";
+    if (value === 0 && 1 / value < 0)
+        return "-0";
+    return String(value);
+}
+
+function shouldBe(actual, expected)
+{
+    var actualValue;
+    var expectedValue;
+    try {
+        actualValue = eval(actual);
+    } catch (e) {
+        testFailed(actual + " should be " + expected + ". Threw exception " + e);
+        return;
+    }
+    expectedValue = eval(expected);
+
+    var same = actualValue === expectedValue;
+    if (typeof actualValue == "number" && typeof expectedValue == "number") {
+        if (actualValue != actualValue)
+            same = expectedValue != expectedValue;
+        else if (actualValue === 0 && expectedValue === 0)
+            same = 1 / actualValue == 1 / expectedValue;
+    }
+    if (same)
+        testPassed(actual + " is " + expected);
+    else
+        testFailed(actual + " should be " + stringify(expectedValue) + ". Was " + stringify(actualValue) + ".");
+}
+
+function shouldBeTrue(actual) { shouldBe(actual, "true"); }
+function shouldBeFalse(actual) { shouldBe(actual, "false"); }
+
+function shouldThrow(code)
+{
+    try {
+        eval(code);
+    } catch (e) {
+        testPassed(code + " threw exception " + e);
+        return;
+    }
+    testFailed(code + " should throw an exception. Did not throw.");
+}
@@ -0,0 +1,32 @@
+description("substring, substr, slice and charAt on a rope give the same results as on a flat string, including for empty ranges.");
+
+function rope()
+{
+    var left = "ab";
+    return left + "cd";
+}
+
+shouldBe("rope().slice(2, 2)", "''");
+shouldBe("rope().substring(3, 3)", "''");
+shouldBe("rope().substr(1, 0)", "''");
+shouldBe("rope().slice(4)", "''");
+shouldBe("rope().slice(0, 0) + rope().slice(1, 1).length", "'0'");
+
+// Ranges inside one fiber, across fibers, and the whole string.
+shouldBe("rope().slice(0, 2)", "'ab'");
+shouldBe("rope().slice(2, 4)", "'cd'");
+shouldBe("rope().slice(1, 3)", "'bc'");
+shouldBe("rope().substring(0, 4)", "'abcd'");
+shouldBe("rope().substr(-3, 2)", "'bc'");
+shouldBe("rope().charAt(3)", "'d'");
+shouldBe("rope().charAt(4)", "''");
+
+// Deeply nested ropes fall back to flattening.
+var nested = "";
+for (var i = 0; i < 20; ++i)
+    nested = nested + String.fromCharCode(97 + i);
+shouldBe("nested.slice(5, 5)", "''");
+shouldBe("nested.slice(0, 1)", "'a'");
+shouldBe("nested.slice(18)", "'st'");
+shouldBe("nested.substring(3, 7)", "'defg'");
+shouldBe("nested", "'abcdefghijklmnopqrst'");
@@ -372,6 +372,8 @@ void* fastRealloc(void* p, size_t n)
 }
 
 void releaseFastMallocFreeMemory() { }
+
+void setFastMallocScavengerParameters(unsigned, float, size_t) { }
     
 FastMallocStatistics fastMallocStatistics()
 {
@@ -379,6 +381,17 @@ FastMallocStatistics fastMallocStatistics()
     return statistics;
 }
 
+size_t fastMallocSizeClassStatistics(FastMallocSizeClassStatistics*, size_t)
+{
+    return 0;
+}
+
+FastMallocThreadCacheStatistics fastMallocThreadCacheStatistics()
+{
+    FastMallocThreadCacheStatistics statistics = { 0, 0, 0, 0 };
+    return statistics;
+}
+
 size_t fastMallocSize(const void* p)
 {
 #if OS(DARWIN)
@@ -620,6 +633,13 @@ static const int kMaxFreeListLength = 256;
 static const size_t kMinThreadCacheSize = kMaxSize * 2;
 static const size_t kMaxThreadCacheSize = 2 << 20;
 
+// The amount a thread cache's limit grows by, each time it fills up
+static const size_t kStealAmount = 1 << 16;
+
+// After failing to grow, a thread cache fills up at most this many more
+// times before it tries again
+static const unsigned kMaxCacheGrowthBackoff = 63;
+
 // Default bound on the total amount of thread caches
 static const size_t kDefaultOverallThreadCacheSize = 16 << 20;
 
@@ -1263,7 +1283,8 @@ template <> class MapSelector<32> {
 //     - returns to the OS a percentage of the memory that remained unused during
 //       that pause (kScavengePercentage * min_free_committed_pages_since_last_scavenge_)
 // The goal of this strategy is to reduce memory pressure in a timely fashion
-// while avoiding thrashing the OS allocator.
+// while avoiding thrashing the OS allocator.  The constants below are the
+// defaults; setFastMallocScavengerParameters changes them.
 
 // Time delay before the page heap scavenger will consider returning pages to
 // the OS.
@@ -1340,6 +1361,10 @@ class TCMalloc_PageHeap {
   // Release all pages on the free list for reuse by the OS:
   void ReleaseFreePages();
 
+#if USE_BACKGROUND_THREAD_TO_SCAVENGE_MEMORY
+  void setScavengerParameters(unsigned delayInSeconds, float releaseFraction, size_t minimumFreeCommittedPageCount);
+#endif
+
   // Return 0 if we have no information, or else the correct sizeclass for p.
   // Reads and writes to pagemap_cache_ do not require locking.
   // The entries are 64 bits on 64-bit hardware and 16 bits on
@@ -1448,6 +1473,12 @@ class TCMalloc_PageHeap {
   bool m_scavengingScheduled;
 #endif
 
+  // How aggressively the scavenger returns memory; these start out as
+  // kScavengeDelayInSeconds, kScavengePercentage and kMinimumFreeCommittedPageCount.
+  unsigned m_scavengeDelayInSeconds;
+  float m_scavengeFraction;
+  Length m_minimumFreeCommittedPageCount;
+
 #endif  // USE_BACKGROUND_THREAD_TO_SCAVENGE_MEMORY
 };
 
@@ -1461,6 +1492,9 @@ void TCMalloc_PageHeap::init()
 #if USE_BACKGROUND_THREAD_TO_SCAVENGE_MEMORY
   free_committed_pages_ = 0;
   min_free_committed_pages_since_last_scavenge_ = 0;
+  m_scavengeDelayInSeconds = kScavengeDelayInSeconds;
+  m_scavengeFraction = kScavengePercentage;
+  m_minimumFreeCommittedPageCount = kMinimumFreeCommittedPageCount;
 #endif  // USE_BACKGROUND_THREAD_TO_SCAVENGE_MEMORY
 
   scavenge_counter_ = 0;
@@ -1531,8 +1565,8 @@ ALWAYS_INLINE void TCMalloc_PageHeap::signalScavenger()
 
 void TCMalloc_PageHeap::scavenge()
 {
-    size_t pagesToRelease = min_free_committed_pages_since_last_scavenge_ * kScavengePercentage;
-    size_t targetPageCount = std::max<size_t>(kMinimumFreeCommittedPageCount, free_committed_pages_ - pagesToRelease);
+    size_t pagesToRelease = min_free_committed_pages_since_last_scavenge_ * m_scavengeFraction;
+    size_t targetPageCount = std::max<size_t>(m_minimumFreeCommittedPageCount, free_committed_pages_ - pagesToRelease);
 
     for (int i = kMaxPages; i >= 0 && free_committed_pages_ > targetPageCount; i--) {
         SpanList* slist = (static_cast<size_t>(i) == kMaxPages) ? &large_ : &free_[i];
@@ -1556,7 +1590,21 @@ void TCMalloc_PageHeap::scavenge()
 
 ALWAYS_INLINE bool TCMalloc_PageHeap::shouldScavenge() const 
 {
-    return free_committed_pages_ > kMinimumFreeCommittedPageCount; 
+    return free_committed_pages_ > m_minimumFreeCommittedPageCount; 
+}
+
+// REQUIRES: pageheap_lock is held.
+void TCMalloc_PageHeap::setScavengerParameters(unsigned delayInSeconds, float releaseFraction, size_t minimumFreeCommittedPageCount)
+{
+    m_scavengeDelayInSeconds = std::max(delayInSeconds, 1u);
+    m_scavengeFraction = std::min(std::max(releaseFraction, 0.f), 1.f);
+    m_minimumFreeCommittedPageCount = minimumFreeCommittedPageCount;
+#if HAVE(DISPATCH_H)
+    dispatch_time_t startTime = dispatch_time(DISPATCH_TIME_NOW, m_scavengeDelayInSeconds * NSEC_PER_SEC);
+    dispatch_source_set_timer(m_scavengeTimer, startTime, m_scavengeDelayInSeconds * NSEC_PER_SEC, 1000 * NSEC_PER_USEC);
+#endif
+    // There may be more memory to return now.
+    signalScavenger();
 }
 
 #endif  // USE_BACKGROUND_THREAD_TO_SCAVENGE_MEMORY
@@ -2046,6 +2094,7 @@ static void ReleaseFreeList(Span* list, Span* returned) {
     DLL_Prepend(returned, s);
     TCMalloc_SystemRelease(reinterpret_cast<void*>(s->start << kPageShift),
                            static_cast<size_t>(s->length << kPageShift));
+    s->decommitted = true;
   }
 }
 
@@ -2054,6 +2103,10 @@ void TCMalloc_PageHeap::ReleaseFreePages() {
     ReleaseFreeList(&free_[s].normal, &free_[s].returned);
   }
   ReleaseFreeList(&large_.normal, &large_.returned);
+#if USE_BACKGROUND_THREAD_TO_SCAVENGE_MEMORY
+  free_committed_pages_ = 0;
+  min_free_committed_pages_since_last_scavenge_ = 0;
+#endif
   ASSERT(Check());
 }
 
@@ -2136,6 +2189,10 @@ class TCMalloc_ThreadCache {
 #endif
 
   size_t        size_;                  // Combined size of data
+  size_t        max_size_;              // size_ > max_size_ --> Scavenge()
+  unsigned      growth_backoff_;        // Fills skipped after the last failed growth
+  unsigned      fills_until_growth_;    // Fills left before trying to grow again
+  bool          active_;                // Used the central cache since the scavenger last looked
   ThreadIdentifier tid_;                // Which thread owns it
   bool          in_setspecific_;           // Called pthread_setspecific?
   FreeList      list_[kNumClasses];     // Array indexed by size-class
@@ -2162,6 +2219,7 @@ class TCMalloc_ThreadCache {
 
   // Total byte size in cache
   size_t Size() const { return size_; }
+  size_t MaxSize() const { return max_size_; }
 
   void* Allocate(size_t size);
   void Deallocate(void* ptr, size_t size_class);
@@ -2169,8 +2227,13 @@ class TCMalloc_ThreadCache {
   void FetchFromCentralCache(size_t cl, size_t allocationSize);
   void ReleaseToCentralCache(size_t cl, int N);
   void Scavenge();
+  void IncreaseCacheLimit();
   void Print() const;
 
+  // Lowers the limits of caches that have not used the central cache since
+  // the last call.  REQUIRES: pageheap_lock is held.
+  static void ShrinkIdleCaches();
+
   // Record allocation of "k" bytes.  Return true iff allocation
   // should be sampled
   bool SampleAllocation(size_t k);
@@ -2227,6 +2290,18 @@ class TCMalloc_Central_FreeList {
     return used_slots_ * num_objects_to_move[size_class_];
   }
 
+  // Returns the objects in the transfer cache to their spans, so that spans
+  // with no objects in use go back to the page heap.
+  void ReleaseTransferCache();
+
+  // Returns the number of objects taken from the spans of this size class,
+  // which are either in use or in a thread cache or the transfer cache.
+  size_t span_objects_in_use();
+
+  // Returns the number of times InsertRange or RemoveRange found the lock
+  // held by another thread.
+  size_t lock_contentions() const { return lock_contentions_; }
+
 #ifdef WTF_CHANGES
   template <class Finder, class Reader>
   void enumerateFreeObjects(Finder& finder, const Reader& reader, TCMalloc_Central_FreeList* remoteCentralFreeList)
@@ -2318,6 +2393,9 @@ class TCMalloc_Central_FreeList {
   // adaptive value that is increased if there is lots of traffic
   // on a given size class.
   int32_t cache_size_;
+
+  // Updated under the lock, but can be read without it.
+  size_t lock_contentions_;
 };
 
 // Pad each CentralCache object to multiple of 64 bytes
@@ -2379,10 +2457,11 @@ void TCMalloc_PageHeap::scavengerThread()
           m_scavengeThreadActive = true;
           pthread_mutex_unlock(&m_scavengeMutex);
       }
-      sleep(kScavengeDelayInSeconds);
+      sleep(m_scavengeDelayInSeconds);
       {
           SpinLockHolder h(&pageheap_lock);
           pageheap->scavenge();
+          TCMalloc_ThreadCache::ShrinkIdleCaches();
       }
   }
 }
@@ -2394,6 +2473,7 @@ void TCMalloc_PageHeap::periodicScavenge()
   {
     SpinLockHolder h(&pageheap_lock);
     pageheap->scavenge();
+    TCMalloc_ThreadCache::ShrinkIdleCaches();
   }
 
   if (!shouldScavenge()) {
@@ -2446,11 +2526,20 @@ static int thread_heap_count = 0;
 // Overall thread cache size.  Protected by pageheap_lock.
 static size_t overall_thread_cache_size = kDefaultOverallThreadCacheSize;
 
-// Global per-thread cache size.  Writes are protected by
-// pageheap_lock.  Reads are done without any locking, which should be
-// fine as long as size_t can be written atomically and we don't place
-// invariants between this variable and other pieces of state.
-static volatile size_t per_thread_cache_size = kMaxThreadCacheSize;
+// Each thread's share of the overall thread cache size.  The limits of
+// the thread caches are scaled down when it goes down.  Protected by
+// pageheap_lock.
+static size_t per_thread_cache_size = kMaxThreadCacheSize;
+
+// The part of the overall thread cache size not claimed by any thread
+// cache, which is negative if the thread caches' minimum sizes add up
+// to more.  Protected by pageheap_lock.
+static intptr_t unclaimed_cache_space = kDefaultOverallThreadCacheSize;
+
+// The thread cache whose limit is lowered next when another thread's
+// cache needs to grow and there is no unclaimed space.  Protected by
+// pageheap_lock.
+static TCMalloc_ThreadCache* next_memory_steal = NULL;
 
 //-------------------------------------------------------------------
 // Central cache implementation
@@ -2466,6 +2555,27 @@ void TCMalloc_Central_FreeList::Init(size_t cl) {
   cache_size_ = 1;
   used_slots_ = 0;
   ASSERT(cache_size_ <= kNumTransferEntries);
+  lock_contentions_ = 0;
+}
+
+void TCMalloc_Central_FreeList::ReleaseTransferCache() {
+  SpinLockHolder h(&lock_);
+  // ReleaseListToSpans may drop the lock, letting other threads use the
+  // slots, so take one slot at a time.
+  while (used_slots_ > 0) {
+    TCEntry* entry = &tc_slots_[--used_slots_];
+    ReleaseListToSpans(entry->head);
+  }
+}
+
+size_t TCMalloc_Central_FreeList::span_objects_in_use() {
+  SpinLockHolder h(&lock_);
+  size_t result = 0;
+  for (Span* span = empty_.next; span != &empty_; span = span->next)
+    result += span->refcount;
+  for (Span* span = nonempty_.next; span != &nonempty_; span = span->next)
+    result += span->refcount;
+  return result;
 }
 
 void TCMalloc_Central_FreeList::ReleaseListToSpans(void* start) {
@@ -2592,7 +2702,9 @@ bool TCMalloc_Central_FreeList::ShrinkCache(int locked_size_class, bool force) {
 }
 
 void TCMalloc_Central_FreeList::InsertRange(void *start, void *end, int N) {
+  const bool contended = lock_.IsHeld();
   SpinLockHolder h(&lock_);
+  if (contended) lock_contentions_++;
   if (N == num_objects_to_move[size_class_] &&
     MakeCacheSpace()) {
     int slot = used_slots_++;
@@ -2610,7 +2722,9 @@ void TCMalloc_Central_FreeList::RemoveRange(void **start, void **end, int *N) {
   int num = *N;
   ASSERT(num > 0);
 
+  const bool contended = lock_.IsHeld();
   SpinLockHolder h(&lock_);
+  if (contended) lock_contentions_++;
   if (num == num_objects_to_move[size_class_] && used_slots_ > 0) {
     int slot = --used_slots_;
     ASSERT(slot >= 0);
@@ -2738,6 +2852,10 @@ inline bool TCMalloc_ThreadCache::SampleAllocation(size_t k) {
 
 void TCMalloc_ThreadCache::Init(ThreadIdentifier tid) {
   size_ = 0;
+  max_size_ = kMinThreadCacheSize;
+  growth_backoff_ = 0;
+  fills_until_growth_ = 0;
+  active_ = true;
   next_ = NULL;
   prev_ = NULL;
   tid_  = tid;
@@ -2784,7 +2902,12 @@ inline void TCMalloc_ThreadCache::Deallocate(void* ptr, size_t cl) {
   if (list->length() > kMaxFreeListLength) {
     ReleaseToCentralCache(cl, num_objects_to_move[cl]);
   }
-  if (size_ >= per_thread_cache_size) Scavenge();
+  if (size_ >= max_size_) {
+    // Keep less of what this thread does not reuse, but since it frees
+    // enough to fill its cache, let the cache grow.
+    Scavenge();
+    IncreaseCacheLimit();
+  }
 }
 
 // Remove some objects of class "cl" from central cache and add to thread heap
@@ -2794,6 +2917,7 @@ ALWAYS_INLINE void TCMalloc_ThreadCache::FetchFromCentralCache(size_t cl, size_t
   central_cache[cl].RemoveRange(&start, &end, &fetch_count);
   list_[cl].PushRange(fetch_count, start, end);
   size_ += allocationSize * fetch_count;
+  active_ = true;
 }
 
 // Remove some objects of class "cl" from thread heap and add to central cache
@@ -2802,6 +2926,7 @@ inline void TCMalloc_ThreadCache::ReleaseToCentralCache(size_t cl, int N) {
   FreeList* src = &list_[cl];
   if (N > src->length()) N = src->length();
   size_ -= N*ByteSizeForClass(cl);
+  active_ = true;
 
   // We return prepackaged chains of the correct size to the central cache.
   // TODO: Use the same format internally in the thread caches?
@@ -2842,6 +2967,58 @@ inline void TCMalloc_ThreadCache::Scavenge() {
   //MESSAGE("GC: %.0f ns\n", ct.CyclesToUsec(finish-start)*1000.0);
 }
 
+// Thread caches start out small.  Each time one fills up, its limit grows
+// by kStealAmount, taken from the part of the overall thread cache size
+// that is unclaimed or else from the limit of another thread's cache, so
+// the caches of the threads that free the most memory grow, while idle
+// threads' caches shrink and return memory the next time they free.
+void TCMalloc_ThreadCache::IncreaseCacheLimit() {
+  // Other threads only ever lower max_size_, so this can be checked before
+  // taking the lock.
+  if (max_size_ + kStealAmount > kMaxThreadCacheSize) return;
+  // Once all the space is claimed, most attempts fail, so a cache that
+  // failed to grow waits for more and more fills before taking
+  // pageheap_lock again.
+  if (fills_until_growth_ > 0) {
+    --fills_until_growth_;
+    return;
+  }
+  SpinLockHolder h(&pageheap_lock);
+  if (unclaimed_cache_space > 0) {
+    unclaimed_cache_space -= kStealAmount;
+    max_size_ += kStealAmount;
+    growth_backoff_ = 0;
+    return;
+  }
+  // Look at a few other caches, starting where we left off last time.
+  for (int i = 0; i < 10; ++i, next_memory_steal = next_memory_steal->next_) {
+    if (next_memory_steal == NULL) next_memory_steal = thread_heaps;
+    if (next_memory_steal == this || next_memory_steal->max_size_ < kMinThreadCacheSize + kStealAmount) continue;
+    next_memory_steal->max_size_ -= kStealAmount;
+    max_size_ += kStealAmount;
+    next_memory_steal = next_memory_steal->next_;
+    growth_backoff_ = 0;
+    return;
+  }
+  growth_backoff_ = std::min(growth_backoff_ * 2 + 1, kMaxCacheGrowthBackoff);
+  fills_until_growth_ = growth_backoff_;
+}
+
+// The scavenger cannot take objects from another thread's cache without
+// every allocation taking a lock, so it halves the limits of caches that
+// went without central cache traffic since it last ran.  Such a cache gives
+// back what it holds over its new limit the next time its thread frees.
+void TCMalloc_ThreadCache::ShrinkIdleCaches() {
+  for (TCMalloc_ThreadCache* h = thread_heaps; h != NULL; h = h->next_) {
+    if (!h->active_ && h->max_size_ > kMinThreadCacheSize) {
+      const size_t new_max_size = std::max(kMinThreadCacheSize, h->max_size_ / 2);
+      unclaimed_cache_space += h->max_size_ - new_max_size;
+      h->max_size_ = new_max_size;
+    }
+    h->active_ = false;
+  }
+}
+
 void TCMalloc_ThreadCache::PickNextSample(size_t k) {
   // Make next "random" number
   // x^32+x^22+x^2+x^1+1 is a primitive polynomial for random numbers
@@ -3089,6 +3266,7 @@ void TCMalloc_ThreadCache::DeleteCache(TCMalloc_ThreadCache* heap) {
   if (heap->next_ != NULL) heap->next_->prev_ = heap->prev_;
   if (heap->prev_ != NULL) heap->prev_->next_ = heap->next_;
   if (thread_heaps == heap) thread_heaps = heap->next_;
+  if (next_memory_steal == heap) next_memory_steal = heap->next_;
   thread_heap_count--;
   RecomputeThreadCacheSize();
 
@@ -3104,6 +3282,16 @@ void TCMalloc_ThreadCache::RecomputeThreadCacheSize() {
   if (space < kMinThreadCacheSize) space = kMinThreadCacheSize;
   if (space > kMaxThreadCacheSize) space = kMaxThreadCacheSize;
 
+  // Scale the caches' limits down if each thread's share went down, and
+  // work out what is left unclaimed.
+  double ratio = space / std::max<double>(1, per_thread_cache_size);
+  size_t claimed = 0;
+  for (TCMalloc_ThreadCache* h = thread_heaps; h != NULL; h = h->next_) {
+    if (ratio < 1.0)
+      h->max_size_ = std::max(kMinThreadCacheSize, static_cast<size_t>(h->max_size_ * ratio));
+    claimed += h->max_size_;
+  }
+  unclaimed_cache_space = static_cast<intptr_t>(overall_thread_cache_size) - static_cast<intptr_t>(claimed);
   per_thread_cache_size = space;
 }
 
@@ -4125,9 +4313,31 @@ void releaseFastMallocFreeMemory()
         threadCache->Scavenge();
     }
 
+    // Other threads' caches cannot be touched from here, but the central
+    // caches can give back whole spans.
+    if (phinited) {
+        for (size_t cl = 0; cl < kNumClasses; ++cl)
+            central_cache[cl].ReleaseTransferCache();
+    }
+
     SpinLockHolder h(&pageheap_lock);
     pageheap->ReleaseFreePages();
 }
+
+void setFastMallocScavengerParameters(unsigned delayInSeconds, float releaseFraction, size_t minimumFreeBytes)
+{
+#if USE_BACKGROUND_THREAD_TO_SCAVENGE_MEMORY
+    if (!phinited)
+        TCMalloc_ThreadCache::InitModule();
+
+    SpinLockHolder h(&pageheap_lock);
+    pageheap->setScavengerParameters(delayInSeconds, releaseFraction, minimumFreeBytes >> kPageShift);
+#else
+    UNUSED_PARAM(delayInSeconds);
+    UNUSED_PARAM(releaseFraction);
+    UNUSED_PARAM(minimumFreeBytes);
+#endif
+}
     
 FastMallocStatistics fastMallocStatistics()
 {
@@ -4150,6 +4360,60 @@ FastMallocStatistics fastMallocStatistics()
     return statistics;
 }
 
+size_t fastMallocSizeClassStatistics(FastMallocSizeClassStatistics* statistics, size_t count)
+{
+    // Size class 0 is not used.
+    const size_t sizeClassCount = kNumClasses - 1;
+    if (!phinited)
+        TCMalloc_ThreadCache::InitModule();
+
+    size_t threadCacheObjects[kNumClasses] = { 0 };
+    {
+        SpinLockHolder lockHolder(&pageheap_lock);
+        for (TCMalloc_ThreadCache* threadCache = thread_heaps; threadCache ; threadCache = threadCache->next_) {
+            for (size_t cl = 1; cl < kNumClasses; ++cl)
+                threadCacheObjects[cl] += threadCache->freelist_length(cl);
+        }
+    }
+
+    // The central free lists' locks are taken without pageheap_lock held,
+    // since they give it up to take pageheap_lock themselves.
+    for (size_t i = 0; i < count && i < sizeClassCount; ++i) {
+        const size_t cl = i + 1;
+        TCMalloc_Central_FreeList& centralCache = central_cache[cl];
+        const size_t transferCacheObjects = centralCache.tc_length();
+
+        FastMallocSizeClassStatistics& classStatistics = statistics[i];
+        classStatistics.objectSize = ByteSizeForClass(cl);
+        classStatistics.threadCacheObjects = threadCacheObjects[cl];
+        classStatistics.centralCacheObjects = centralCache.length() + transferCacheObjects;
+
+        // Other threads' caches are read without locking them, so the
+        // numbers may not quite add up.
+        const size_t cachedObjects = classStatistics.threadCacheObjects + transferCacheObjects;
+        const size_t objectsInUse = centralCache.span_objects_in_use();
+        classStatistics.allocatedObjects = objectsInUse > cachedObjects ? objectsInUse - cachedObjects : 0;
+        classStatistics.lockContentions = centralCache.lock_contentions();
+    }
+    return sizeClassCount;
+}
+
+FastMallocThreadCacheStatistics fastMallocThreadCacheStatistics()
+{
+    FastMallocThreadCacheStatistics statistics = { 0, 0, 0, 0 };
+
+    SpinLockHolder lockHolder(&pageheap_lock);
+    for (TCMalloc_ThreadCache* threadCache = thread_heaps; threadCache ; threadCache = threadCache->next_) {
+        ++statistics.threadCaches;
+        statistics.cachedBytes += threadCache->Size();
+        statistics.limitBytes += threadCache->MaxSize();
+    }
+    if (unclaimed_cache_space > 0)
+        statistics.unclaimedBytes = static_cast<size_t>(unclaimed_cache_space);
+
+    return statistics;
+}
+
 size_t fastMallocSize(const void* ptr)
 {
     const PageID p = reinterpret_cast<uintptr_t>(ptr) >> kPageShift;
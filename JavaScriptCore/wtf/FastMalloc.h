@@ -80,7 +80,15 @@ namespace WTF {
     void fastMallocAllow();
 #endif
 
+    // Returns as much free memory as can be to the system, for example when
+    // the system is low on memory.
     void releaseFastMallocFreeMemory();
+
+    // While at least minimumFreeBytes of memory are free, a background thread
+    // wakes up every delayInSeconds and returns to the system releaseFraction
+    // of the free pages that went unused since it last ran. The defaults are
+    // 2 seconds, 0.5 and 2MB.
+    void setFastMallocScavengerParameters(unsigned delayInSeconds, float releaseFraction, size_t minimumFreeBytes);
     
     struct FastMallocStatistics {
         size_t reservedVMBytes;
@@ -89,6 +97,30 @@ namespace WTF {
     };
     FastMallocStatistics fastMallocStatistics();
 
+    struct FastMallocSizeClassStatistics {
+        size_t objectSize;
+        size_t allocatedObjects;
+        size_t threadCacheObjects;
+        size_t centralCacheObjects;
+        // The number of times a thread found the size class's central free
+        // list locked by another thread when moving objects to or from it.
+        size_t lockContentions;
+    };
+    // Fills in the statistics for up to count size classes, and returns the
+    // number of size classes.
+    size_t fastMallocSizeClassStatistics(FastMallocSizeClassStatistics*, size_t count);
+
+    struct FastMallocThreadCacheStatistics {
+        size_t threadCaches;
+        size_t cachedBytes;
+        // The sum of the limits of the thread caches, which grow for threads
+        // that free a lot of memory and shrink for those that do not, and the
+        // part of the overall limit that no thread cache has claimed yet.
+        size_t limitBytes;
+        size_t unclaimedBytes;
+    };
+    FastMallocThreadCacheStatistics fastMallocThreadCacheStatistics();
+
     // This defines a type which holds an unsigned integer and is the same
     // size as the minimally aligned memory allocation.
     typedef unsigned long long AllocAlignmentInteger;
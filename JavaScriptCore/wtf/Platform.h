@@ -189,6 +189,13 @@
 #define WTF_CPU_X86_64 1
 #endif
 
+/* CPU(X86_SSE2) - SSE2 can be used without a runtime check: always on x86-64,
+   and on x86 when the compiler targets it */
+#if CPU(X86_64) \
+    || (CPU(X86) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#define WTF_CPU_X86_SSE2 1
+#endif
+
 /* CPU(ARM) - ARM, any version*/
 #if   defined(arm) \
     || defined(__arm__) \
@@ -754,6 +761,7 @@
 
 #define HAVE_ERRNO_H 1
 #define HAVE_LANGINFO_H 0
+#define HAVE_MADV_DONTNEED 1
 #define HAVE_MMAP 1
 #define HAVE_SBRK 1
 #define HAVE_STRINGS_H 1
@@ -769,6 +777,9 @@
 #if !OS(HAIKU)
 #define HAVE_LANGINFO_H 1
 #endif
+#if OS(LINUX)
+#define HAVE_MADV_DONTNEED 1
+#endif
 #define HAVE_MMAP 1
 #define HAVE_SBRK 1
 #define HAVE_STRINGS_H 1
@@ -973,6 +984,14 @@ on MinGW. See https://bugs.webkit.org/show_bug.cgi?id=29268 */
 #ifndef ENABLE_JIT_OPTIMIZE_MOD
 #define ENABLE_JIT_OPTIMIZE_MOD 0
 #endif
+/* Host functions such as Math.sqrt and Array.prototype.push get thunks that inline their common cases. */
+#if !defined(ENABLE_JIT_INTRINSICS) && USE(JSVALUE64) && CPU(X86_64)
+#define ENABLE_JIT_INTRINSICS 1
+#endif
+/* The sampling profiler reads the call frame register of a suspended thread. */
+#if !defined(ENABLE_SAMPLING_PROFILER) && (CPU(X86) || CPU(X86_64)) && (OS(DARWIN) || OS(LINUX))
+#define ENABLE_SAMPLING_PROFILER 1
+#endif
 #endif
 
 #if CPU(X86) && COMPILER(MSVC)
@@ -1088,6 +1107,11 @@ on MinGW. See https://bugs.webkit.org/show_bug.cgi?id=29268 */
 /* Set up a define for a common error that is intended to cause a build error -- thus the space after Error. */
 #define WTF_PLATFORM_CFNETWORK Error USE_macro_should_be_used_with_CFNETWORK
 
+/* Parallel marking relies on the GCC atomic builtins for setting mark bits. */
+#if !defined(ENABLE_PARALLEL_MARKING) && COMPILER(GCC) && (CPU(X86) || CPU(X86_64)) && OS(UNIX) && !OS(SYMBIAN) && !ENABLE(SINGLE_THREADED)
+#define ENABLE_PARALLEL_MARKING 1
+#endif
+
 #define ENABLE_JSC_ZOMBIES 0
 
 #endif /* WTF_Platform_h */
@@ -1096,6 +1096,369 @@ static void hexnan(U* rvp, const char** sp)
 #endif /*No_Hex_NaN*/
 #endif /* INFNAN_CHECK */
 
+/* Shortest digit generation with Grisu3 (Florian Loitsch, "Printing
+ * Floating-Point Numbers Quickly and Accurately with Integers", PLDI 2010)
+ * and a matching fast path for strtod.  Both work on DiyFp values, a 64 bit
+ * significand with a binary exponent, and both detect the rare inputs for
+ * which 64 bits of precision are not enough; those fall back to the BigInt
+ * code, so the results are always identical to it.
+ */
+
+struct DiyFp {
+    DiyFp()
+        : f(0)
+        , e(0)
+    {
+    }
+
+    DiyFp(uint64_t significand, int exponent)
+        : f(significand)
+        , e(exponent)
+    {
+    }
+
+    uint64_t f;
+    int e;
+};
+
+static const int diyFpSignificandSize = 64;
+static const uint64_t doubleHiddenBit = 0x0010000000000000ULL;
+static const uint64_t doubleSignificandMask = 0x000FFFFFFFFFFFFFULL;
+static const int doubleExponentBias = Bias + P - 1;
+static const int doubleDenormalExponent = 1 - doubleExponentBias;
+
+/* The product, rounded to the 64 most significant bits. */
+static ALWAYS_INLINE DiyFp multiply(const DiyFp& x, const DiyFp& y)
+{
+    const uint64_t mask32 = 0xFFFFFFFFU;
+    uint64_t a = x.f >> 32;
+    uint64_t b = x.f & mask32;
+    uint64_t c = y.f >> 32;
+    uint64_t d = y.f & mask32;
+    uint64_t ac = a * c;
+    uint64_t bc = b * c;
+    uint64_t ad = a * d;
+    uint64_t bd = b * d;
+    uint64_t middle = (bd >> 32) + (ad & mask32) + (bc & mask32) + (1U << 31);
+    return DiyFp(ac + (ad >> 32) + (bc >> 32) + (middle >> 32), x.e + y.e + diyFpSignificandSize);
+}
+
+static ALWAYS_INLINE DiyFp normalize(DiyFp x)
+{
+    ASSERT(x.f);
+    while (!(x.f & 0xFFC0000000000000ULL)) {
+        x.f <<= 10;
+        x.e -= 10;
+    }
+    while (!(x.f & 0x8000000000000000ULL)) {
+        x.f <<= 1;
+        x.e--;
+    }
+    return x;
+}
+
+/* d must be finite. */
+static ALWAYS_INLINE DiyFp diyFpFromDouble(U* d)
+{
+    uint64_t significand = (static_cast<uint64_t>(word0(d) & Frac_mask) << 32) | word1(d);
+    int biasedExponent = static_cast<int>((word0(d) & Exp_mask) >> Exp_shift);
+    if (!biasedExponent)
+        return DiyFp(significand, doubleDenormalExponent);
+    return DiyFp(significand + doubleHiddenBit, biasedExponent - doubleExponentBias);
+}
+
+struct CachedPower {
+    uint64_t significand;
+    int16_t binaryExponent;
+    int16_t decimalExponent;
+};
+
+/* 10^k for k = -348, -340, ..., 340, rounded to the nearest 64 bit significand. */
+static const CachedPower cachedPowers[] = {
+    { 0xfa8fd5a0081c0288ULL, -1220, -348 },
+    { 0xbaaee17fa23ebf76ULL, -1193, -340 },
+    { 0x8b16fb203055ac76ULL, -1166, -332 },
+    { 0xcf42894a5dce35eaULL, -1140, -324 },
+    { 0x9a6bb0aa55653b2dULL, -1113, -316 },
+    { 0xe61acf033d1a45dfULL, -1087, -308 },
+    { 0xab70fe17c79ac6caULL, -1060, -300 },
+    { 0xff77b1fcbebcdc4fULL, -1034, -292 },
+    { 0xbe5691ef416bd60cULL, -1007, -284 },
+    { 0x8dd01fad907ffc3cULL, -980, -276 },
+    { 0xd3515c2831559a83ULL, -954, -268 },
+    { 0x9d71ac8fada6c9b5ULL, -927, -260 },
+    { 0xea9c227723ee8bcbULL, -901, -252 },
+    { 0xaecc49914078536dULL, -874, -244 },
+    { 0x823c12795db6ce57ULL, -847, -236 },
+    { 0xc21094364dfb5637ULL, -821, -228 },
+    { 0x9096ea6f3848984fULL, -794, -220 },
+    { 0xd77485cb25823ac7ULL, -768, -212 },
+    { 0xa086cfcd97bf97f4ULL, -741, -204 },
+    { 0xef340a98172aace5ULL, -715, -196 },
+    { 0xb23867fb2a35b28eULL, -688, -188 },
+    { 0x84c8d4dfd2c63f3bULL, -661, -180 },
+    { 0xc5dd44271ad3cdbaULL, -635, -172 },
+    { 0x936b9fcebb25c996ULL, -608, -164 },
+    { 0xdbac6c247d62a584ULL, -582, -156 },
+    { 0xa3ab66580d5fdaf6ULL, -555, -148 },
+    { 0xf3e2f893dec3f126ULL, -529, -140 },
+    { 0xb5b5ada8aaff80b8ULL, -502, -132 },
+    { 0x87625f056c7c4a8bULL, -475, -124 },
+    { 0xc9bcff6034c13053ULL, -449, -116 },
+    { 0x964e858c91ba2655ULL, -422, -108 },
+    { 0xdff9772470297ebdULL, -396, -100 },
+    { 0xa6dfbd9fb8e5b88fULL, -369, -92 },
+    { 0xf8a95fcf88747d94ULL, -343, -84 },
+    { 0xb94470938fa89bcfULL, -316, -76 },
+    { 0x8a08f0f8bf0f156bULL, -289, -68 },
+    { 0xcdb02555653131b6ULL, -263, -60 },
+    { 0x993fe2c6d07b7facULL, -236, -52 },
+    { 0xe45c10c42a2b3b06ULL, -210, -44 },
+    { 0xaa242499697392d3ULL, -183, -36 },
+    { 0xfd87b5f28300ca0eULL, -157, -28 },
+    { 0xbce5086492111aebULL, -130, -20 },
+    { 0x8cbccc096f5088ccULL, -103, -12 },
+    { 0xd1b71758e219652cULL, -77, -4 },
+    { 0x9c40000000000000ULL, -50, 4 },
+    { 0xe8d4a51000000000ULL, -24, 12 },
+    { 0xad78ebc5ac620000ULL, 3, 20 },
+    { 0x813f3978f8940984ULL, 30, 28 },
+    { 0xc097ce7bc90715b3ULL, 56, 36 },
+    { 0x8f7e32ce7bea5c70ULL, 83, 44 },
+    { 0xd5d238a4abe98068ULL, 109, 52 },
+    { 0x9f4f2726179a2245ULL, 136, 60 },
+    { 0xed63a231d4c4fb27ULL, 162, 68 },
+    { 0xb0de65388cc8ada8ULL, 189, 76 },
+    { 0x83c7088e1aab65dbULL, 216, 84 },
+    { 0xc45d1df942711d9aULL, 242, 92 },
+    { 0x924d692ca61be758ULL, 269, 100 },
+    { 0xda01ee641a708deaULL, 295, 108 },
+    { 0xa26da3999aef774aULL, 322, 116 },
+    { 0xf209787bb47d6b85ULL, 348, 124 },
+    { 0xb454e4a179dd1877ULL, 375, 132 },
+    { 0x865b86925b9bc5c2ULL, 402, 140 },
+    { 0xc83553c5c8965d3dULL, 428, 148 },
+    { 0x952ab45cfa97a0b3ULL, 455, 156 },
+    { 0xde469fbd99a05fe3ULL, 481, 164 },
+    { 0xa59bc234db398c25ULL, 508, 172 },
+    { 0xf6c69a72a3989f5cULL, 534, 180 },
+    { 0xb7dcbf5354e9beceULL, 561, 188 },
+    { 0x88fcf317f22241e2ULL, 588, 196 },
+    { 0xcc20ce9bd35c78a5ULL, 614, 204 },
+    { 0x98165af37b2153dfULL, 641, 212 },
+    { 0xe2a0b5dc971f303aULL, 667, 220 },
+    { 0xa8d9d1535ce3b396ULL, 694, 228 },
+    { 0xfb9b7cd9a4a7443cULL, 720, 236 },
+    { 0xbb764c4ca7a44410ULL, 747, 244 },
+    { 0x8bab8eefb6409c1aULL, 774, 252 },
+    { 0xd01fef10a657842cULL, 800, 260 },
+    { 0x9b10a4e5e9913129ULL, 827, 268 },
+    { 0xe7109bfba19c0c9dULL, 853, 276 },
+    { 0xac2820d9623bf429ULL, 880, 284 },
+    { 0x80444b5e7aa7cf85ULL, 907, 292 },
+    { 0xbf21e44003acdd2dULL, 933, 300 },
+    { 0x8e679c2f5e44ff8fULL, 960, 308 },
+    { 0xd433179d9c8cb841ULL, 986, 316 },
+    { 0x9e19db92b4e31ba9ULL, 1013, 324 },
+    { 0xeb96bf6ebadf77d9ULL, 1039, 332 },
+    { 0xaf87023b9bf0ee6bULL, 1066, 340 },
+};
+
+static const int cachedPowersDecimalDistance = 8;
+static const int cachedPowersMinDecimalExponent = -348;
+static const int cachedPowersMaxDecimalExponent = 340;
+
+/* 10^1 ... 10^7, exactly. */
+static const DiyFp adjustmentPowers[] = {
+    DiyFp(0xA000000000000000ULL, -60),
+    DiyFp(0xC800000000000000ULL, -57),
+    DiyFp(0xFA00000000000000ULL, -54),
+    DiyFp(0x9C40000000000000ULL, -50),
+    DiyFp(0xC350000000000000ULL, -47),
+    DiyFp(0xF424000000000000ULL, -44),
+    DiyFp(0x9896800000000000ULL, -40),
+};
+
+static const uint32_t smallPowersOfTen[] = { 0, 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+/* A uint64_t holds any 19 digit decimal number. */
+static const int maxUint64DecimalDigits = 19;
+
+/* Grisu scales the double so that its binary exponent falls in this range,
+ * which leaves the integral part of the scaled value in a uint32_t.
+ */
+static const int grisuMinimalTargetExponent = -60;
+static const int grisuMaximalTargetExponent = -32;
+
+/* Finds the cached power whose binary exponent is in [minExponent, maxExponent]. */
+static ALWAYS_INLINE void cachedPowerForBinaryExponentRange(int minExponent, int maxExponent, DiyFp& power, int& decimalExponent)
+{
+    int k = static_cast<int>(ceil((minExponent + diyFpSignificandSize - 1) * 0.30102999566398114));
+    int index = (k - cachedPowersMinDecimalExponent - 1) / cachedPowersDecimalDistance + 1;
+    const CachedPower& cachedPower = cachedPowers[index];
+    ASSERT_UNUSED(maxExponent, minExponent <= cachedPower.binaryExponent && cachedPower.binaryExponent <= maxExponent);
+    power = DiyFp(cachedPower.significand, cachedPower.binaryExponent);
+    decimalExponent = cachedPower.decimalExponent;
+}
+
+/* Moves the last generated digit down while that brings the result closer
+ * to w, then checks that the result is within the interval and the closest
+ * shortest representation of w even allowing for the imprecision of the
+ * scaled values, which are off by less than one unit.  All arguments are in
+ * units of the scaled values' least significant bit.
+ */
+static bool roundWeed(char* buffer, int length, uint64_t distanceTooHighW, uint64_t unsafeInterval, uint64_t rest, uint64_t tenKappa, uint64_t unit)
+{
+    uint64_t smallDistance = distanceTooHighW - unit;
+    uint64_t bigDistance = distanceTooHighW + unit;
+    ASSERT(rest <= unsafeInterval);
+    while (rest < smallDistance && unsafeInterval - rest >= tenKappa
+        && (rest + tenKappa < smallDistance || smallDistance - rest >= rest + tenKappa - smallDistance)) {
+        buffer[length - 1]--;
+        rest += tenKappa;
+    }
+    if (rest < bigDistance && unsafeInterval - rest >= tenKappa
+        && (rest + tenKappa < bigDistance || bigDistance - rest > rest + tenKappa - bigDistance))
+        return false;
+    return 2 * unit <= rest && rest <= unsafeInterval - 4 * unit;
+}
+
+/* Generates the shortest digits of a number between low and high, so that
+ * w = buffer * 10^kappa within the imprecision of the three values.
+ */
+static bool digitGen(DiyFp low, DiyFp w, DiyFp high, char* buffer, int& length, int& kappa)
+{
+    ASSERT(low.e == w.e && w.e == high.e);
+    ASSERT(low.f + 1 <= high.f - 1);
+    ASSERT(grisuMinimalTargetExponent <= w.e && w.e <= grisuMaximalTargetExponent);
+
+    uint64_t unit = 1;
+    DiyFp tooLow(low.f - unit, low.e);
+    DiyFp tooHigh(high.f + unit, high.e);
+    uint64_t unsafeInterval = tooHigh.f - tooLow.f;
+    int oneShift = -w.e;
+    uint64_t one = static_cast<uint64_t>(1) << oneShift;
+    uint32_t integrals = static_cast<uint32_t>(tooHigh.f >> oneShift);
+    uint64_t fractionals = tooHigh.f & (one - 1);
+
+    kappa = ((diyFpSignificandSize - oneShift + 1) * 1233 >> 12) + 1;
+    while (kappa && integrals < smallPowersOfTen[kappa])
+        kappa--;
+    uint32_t divisor = smallPowersOfTen[kappa];
+
+    length = 0;
+    while (kappa > 0) {
+        buffer[length++] = static_cast<char>('0' + integrals / divisor);
+        integrals %= divisor;
+        kappa--;
+        uint64_t rest = (static_cast<uint64_t>(integrals) << oneShift) + fractionals;
+        if (rest < unsafeInterval)
+            return roundWeed(buffer, length, tooHigh.f - w.f, unsafeInterval, rest, static_cast<uint64_t>(divisor) << oneShift, unit);
+        divisor /= 10;
+    }
+
+    for (;;) {
+        fractionals *= 10;
+        unit *= 10;
+        unsafeInterval *= 10;
+        buffer[length++] = static_cast<char>('0' + (fractionals >> oneShift));
+        fractionals &= one - 1;
+        kappa--;
+        if (fractionals < unsafeInterval)
+            return roundWeed(buffer, length, (tooHigh.f - w.f) * unit, unsafeInterval, fractionals, one, unit);
+    }
+}
+
+/* Writes the shortest digits that read back as d, choosing the closest to d
+ * if there are several, so that d = buffer * 10^decimalExponent.  Returns
+ * false if it cannot be sure of the result; d must be finite and positive.
+ */
+static bool grisu3(U* d, char* buffer, int& length, int& decimalExponent)
+{
+    DiyFp v = diyFpFromDouble(d);
+    DiyFp w = normalize(v);
+
+    /* The boundaries halfway to the neighbouring doubles. */
+    DiyFp plus = normalize(DiyFp((v.f << 1) + 1, v.e - 1));
+    DiyFp minus;
+    if (v.f == doubleHiddenBit && v.e != doubleDenormalExponent)
+        minus = DiyFp((v.f << 2) - 1, v.e - 2);
+    else
+        minus = DiyFp((v.f << 1) - 1, v.e - 1);
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+    ASSERT(plus.e == w.e);
+
+    DiyFp tenMk;
+    int mk;
+    cachedPowerForBinaryExponentRange(grisuMinimalTargetExponent - (w.e + diyFpSignificandSize), grisuMaximalTargetExponent - (w.e + diyFpSignificandSize), tenMk, mk);
+
+    int kappa;
+    bool result = digitGen(multiply(minus, tenMk), multiply(w, tenMk), multiply(plus, tenMk), buffer, length, kappa);
+    decimalExponent = kappa - mk;
+    return result;
+}
+
+/* Computes significand * 10^exponent, where significand has the given
+ * number of decimal digits.  Returns false if the result is too close to the
+ * halfway point between two doubles to be sure of the rounding, or if it is
+ * denormal or overflows.
+ */
+static bool diyFpStrtod(uint64_t significand, int digits, int exponent, U* result)
+{
+    ASSERT(significand);
+    ASSERT(digits <= maxUint64DecimalDigits);
+    if (exponent < cachedPowersMinDecimalExponent || exponent >= cachedPowersMaxDecimalExponent + cachedPowersDecimalDistance)
+        return false;
+
+    /* The error is kept in eighths of a unit in the last place. */
+    const int denominatorLog = 3;
+    const int denominator = 1 << denominatorLog;
+    uint64_t error = 0;
+
+    DiyFp input = normalize(DiyFp(significand, 0));
+    const CachedPower& cachedPower = cachedPowers[(exponent - cachedPowersMinDecimalExponent) / cachedPowersDecimalDistance];
+    int adjustment = exponent - cachedPower.decimalExponent;
+    if (adjustment) {
+        input = multiply(input, adjustmentPowers[adjustment - 1]);
+        /* Exact if the product still fits in 64 bits. */
+        if (digits + adjustment > maxUint64DecimalDigits)
+            error += denominator / 2;
+    }
+
+    /* The cached power and the multiplication are each off by up to half a
+     * unit; the product of the two errors adds less than one eighth.
+     */
+    input = multiply(input, DiyFp(cachedPower.significand, cachedPower.binaryExponent));
+    error += denominator + (error ? 1 : 0);
+
+    int oldExponent = input.e;
+    input = normalize(input);
+    error <<= oldExponent - input.e;
+
+    const int precisionBitCount = diyFpSignificandSize - P;
+    uint64_t precisionBits = (input.f & ((static_cast<uint64_t>(1) << precisionBitCount) - 1)) * denominator;
+    uint64_t halfWay = (static_cast<uint64_t>(1) << (precisionBitCount - 1)) * denominator;
+    if (halfWay - error < precisionBits && precisionBits < halfWay + error)
+        return false;
+
+    DiyFp rounded(input.f >> precisionBitCount, input.e + precisionBitCount);
+    if (precisionBits >= halfWay + error) {
+        rounded.f++;
+        if (rounded.f == doubleHiddenBit << 1) {
+            rounded.f >>= 1;
+            rounded.e++;
+        }
+    }
+    int biasedExponent = rounded.e + doubleExponentBias;
+    if (biasedExponent <= 0 || biasedExponent >= static_cast<int>(Exp_mask >> Exp_shift))
+        return false;
+
+    word0(result) = (static_cast<uint32_t>(biasedExponent) << Exp_shift) | static_cast<uint32_t>((rounded.f >> 32) & Frac_mask);
+    word1(result) = static_cast<uint32_t>(rounded.f);
+    return true;
+}
+
 double strtod(const char* s00, char** se)
 {
 #ifdef Avoid_Underflow
@@ -1297,6 +1660,15 @@ ret0:
         }
 #endif
     }
+    if (nd <= maxUint64DecimalDigits) {
+        uint64_t significand = 0;
+        for (i = 0; i < nd0; i++)
+            significand = 10 * significand + s0[i] - '0';
+        for (j = nd0 + 1; i < nd; i++, j++)
+            significand = 10 * significand + s0[j] - '0';
+        if (diyFpStrtod(significand, nd, e, &rv))
+            goto ret;
+    }
     e1 += nd - k;
 
 #ifdef SET_INEXACT
@@ -1929,6 +2301,18 @@ void dtoa(DtoaBuffer result, double dd, int ndigits, int* decpt, int* sign, char
         return;
     }
 
+    int length;
+    int decimalExponent;
+    if (grisu3(&u, result, length, decimalExponent)) {
+        *decpt = length + decimalExponent;
+        while (length > 1 && result[length - 1] == '0')
+            length--;
+        result[length] = '\0';
+        if (rve)
+            *rve = result + length;
+        return;
+    }
+
 #ifdef SET_INEXACT
     try_quick = oldinexact = get_inexact();
     inexact = 1;
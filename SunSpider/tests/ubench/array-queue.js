@@ -0,0 +1,9 @@
+var queue = [];
+for (var i = 0; i < 20000; ++i)
+    queue.push(i);
+
+var sum = 0;
+for (var i = 0; i < 400000; ++i) {
+    sum += queue.shift();
+    queue.push(i);
+}
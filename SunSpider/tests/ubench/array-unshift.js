@@ -0,0 +1,8 @@
+var count = 50000;
+var deque = [];
+for (var i = 0; i < count; ++i)
+    deque.unshift(i);
+
+var sum = 0;
+for (var i = 0; i < count; ++i)
+    sum += deque.shift();
@@ -0,0 +1,15 @@
+var records = [];
+for (var i = 0; i < 2000; ++i) {
+    records.push({
+        id: i,
+        name: "record " + i,
+        active: !(i % 3),
+        score: i * 1.25,
+        tags: ["json", "tag" + (i % 7)],
+        owner: { id: i % 50, login: "user" + (i % 50) }
+    });
+}
+
+var text = JSON.stringify(records);
+for (var i = 0; i < 20; ++i)
+    text = JSON.stringify(JSON.parse(text));
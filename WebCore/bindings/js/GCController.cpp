@@ -66,7 +66,9 @@ void GCController::garbageCollectSoon()
 
 void GCController::gcTimerFired(Timer<GCController>*)
 {
-    collect(0);
+    JSLock lock(SilenceAssertionsOnly);
+    // Leave dead cells for the allocator to destroy, so that the pause only covers marking.
+    JSDOMWindow::commonJSGlobalData()->heap.collectAllGarbage(DoNotSweep);
 }
 
 void GCController::garbageCollectNow()